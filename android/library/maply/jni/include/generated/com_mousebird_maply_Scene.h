@@ -64,6 +64,22 @@ JNIEXPORT float JNICALL Java_com_mousebird_maply_Scene_getZoomSlotValue
 JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_copyZoomSlots
   (JNIEnv *env, jobject obj, jobject, jfloat);
 
+/*
+ * Class:     com_mousebird_maply_Scene
+ * Method:    setChangeBudget
+ * Signature: (DI)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_setChangeBudget
+  (JNIEnv *, jobject, jdouble, jint);
+
+/*
+ * Class:     com_mousebird_maply_Scene
+ * Method:    getNumDeferredChanges
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_com_mousebird_maply_Scene_getNumDeferredChanges
+  (JNIEnv *, jobject);
+
 /*
  * Class:     com_mousebird_maply_Scene
  * Method:    teardownGL
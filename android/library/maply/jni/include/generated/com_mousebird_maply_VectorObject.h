@@ -243,10 +243,10 @@ JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_VectorObject_clipToMbrNative
 /*
  * Class:     com_mousebird_maply_VectorObject
  * Method:    reprojectNative
- * Signature: (Lcom/mousebird/maply/VectorObject;Lcom/mousebird/maply/CoordSystem;DLcom/mousebird/maply/CoordSystem;)Z
+ * Signature: (Lcom/mousebird/maply/VectorObject;Lcom/mousebird/maply/CoordSystem;DLcom/mousebird/maply/CoordSystem;D)Z
  */
 JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_VectorObject_reprojectNative
-  (JNIEnv *, jobject, jobject, jobject, jdouble, jobject);
+  (JNIEnv *, jobject, jobject, jobject, jdouble, jobject, jdouble);
 
 /*
  * Class:     com_mousebird_maply_VectorObject
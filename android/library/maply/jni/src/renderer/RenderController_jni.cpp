@@ -102,6 +102,25 @@ extern "C"
 JNIEXPORT void JNICALL Java_com_mousebird_maply_RenderController_nativeInit(JNIEnv *env, jclass cls)
 {
 	SceneRendererInfo::getClassInfo(env,cls);
+
+	// Task scheduler threads need to be attached to the VM to call back into Java
+	JavaVM *vm = nullptr;
+	if (env->GetJavaVM(&vm) == JNI_OK && vm)
+	{
+		TaskScheduler::setShared(std::make_shared<TaskScheduler>(0,
+			[vm]() -> PlatformThreadInfo * {
+				JNIEnv *threadEnv = nullptr;
+				if (vm->AttachCurrentThread(&threadEnv, nullptr) != JNI_OK)
+				{
+					return nullptr;
+				}
+				return new PlatformInfo_Android(threadEnv);
+			},
+			[vm](PlatformThreadInfo *inst) {
+				delete (PlatformInfo_Android *)inst;
+				vm->DetachCurrentThread();
+			}));
+	}
 }
 
 extern "C"
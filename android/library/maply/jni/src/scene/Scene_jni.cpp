@@ -215,3 +215,30 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_copyZoomSlots(JNIEnv *env,
     }
     MAPLY_STD_JNI_CATCH()
 }
+
+extern "C"
+JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_setChangeBudget(JNIEnv *env, jobject obj, jdouble maxTime, jint maxCount)
+{
+    try
+    {
+        if (Scene *scene = SceneClassInfo::get(env,obj))
+        {
+            scene->setChangeBudget(maxTime, maxCount);
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+}
+
+extern "C"
+JNIEXPORT jint JNICALL Java_com_mousebird_maply_Scene_getNumDeferredChanges(JNIEnv *env, jobject obj)
+{
+    try
+    {
+        if (Scene *scene = SceneClassInfo::get(env,obj))
+        {
+            return scene->getNumDeferredChanges();
+        }
+    }
+    MAPLY_STD_JNI_CATCH()
+    return 0;
+}
@@ -804,7 +804,7 @@ JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_VectorObject_clipToMbrNative
 
 extern "C"
 JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_VectorObject_reprojectNative
-  (JNIEnv *env, jobject obj, jobject retObj, jobject srcSystemObj, jdouble scale, jobject destSystemObj)
+  (JNIEnv *env, jobject obj, jobject retObj, jobject srcSystemObj, jdouble scale, jobject destSystemObj, jdouble maxError)
 {
     try
     {
@@ -814,7 +814,7 @@ JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_VectorObject_reprojectNative
         if (const auto destSystem = CoordSystemRefClassInfo::get(env,destSystemObj))
         {
             VectorObjectRef newVecObj = (*vecObj)->deepCopy();
-            newVecObj->reproject(srcSystem->get(), scale, destSystem->get());
+            newVecObj->reproject(srcSystem->get(), scale, destSystem->get(), maxError);
             *retVecObj = newVecObj;
             return true;
         }
@@ -1012,6 +1012,10 @@ public abstract class BaseController implements RenderController.TaskManager, Re
 			// Debugging output
 			renderControl.setPerfInterval(perfInterval);
 
+			// Per-frame limit on applying changes
+			if (renderControl.scene != null)
+				renderControl.scene.setChangeBudget(changeBudgetTime, changeBudgetCount);
+
 			// Kick off the layout layer
 			final LayerThread baseLayerThread = getLayerThread();
 			if (baseLayerThread == null) {
@@ -1282,6 +1286,34 @@ public abstract class BaseController implements RenderController.TaskManager, Re
 			renderControl.setPerfInterval(perfInterval);
 	}
 
+	private double changeBudgetTime = 0.0;
+	private int changeBudgetCount = 0;
+	/**
+	 * Limit the time (in seconds) and number of changes the renderer will
+	 * apply in a single frame.  Changes that don't fit are deferred to later
+	 * frames, which keeps big batches of additions from stalling the display.
+	 * Zero for either value means no limit, which is the default.
+	 * @param maxTime seconds to spend on changes per frame
+	 * @param maxCount maximum number of changes per frame
+	 */
+	public void setChangeBudget(double maxTime, int maxCount)
+	{
+		changeBudgetTime = maxTime;
+		changeBudgetCount = maxCount;
+		RenderController rc = renderControl;
+		if (rc != null && rc.scene != null)
+			rc.scene.setChangeBudget(changeBudgetTime, changeBudgetCount);
+	}
+
+	/**
+	 * Number of changes currently waiting for a later frame because of the change budget.
+	 */
+	public int getNumDeferredChanges()
+	{
+		RenderController rc = renderControl;
+		return (rc != null && rc.scene != null) ? rc.scene.getNumDeferredChanges() : 0;
+	}
+
 	/**
 	 * Get the zoom limits for the globe.
 	 */
@@ -2468,6 +2500,35 @@ public abstract class BaseController implements RenderController.TaskManager, Re
 		}
 	}
 
+	/**
+	 * Set whether the layout manager keeps its drawables between passes
+	 * and only rebuilds the ones that changed.
+	 */
+	public void setLayoutRetained(boolean retained) {
+		RenderController rc = renderControl;
+		if (rc != null) {
+			LayoutManager lm = rc.layoutManager;
+			if (lm != null) {
+				lm.setRetainedMode(retained);
+			}
+		}
+	}
+
+	/**
+	 * Set whether clustered markers are grouped with an index built once
+	 * per set of markers, rather than by checking overlaps on the screen
+	 * every time the layout runs.
+	 */
+	public void setLayoutClusterIndexing(boolean enable) {
+		RenderController rc = renderControl;
+		if (rc != null) {
+			LayoutManager lm = rc.layoutManager;
+			if (lm != null) {
+				lm.setClusterIndexing(enable);
+			}
+		}
+	}
+
 	/**
 	 * This method will add the given MaplyShape derived objects to the current scene.  It will use the parameters in the description dictionary and it will do it on the thread specified.
 	 * @param shapes An array of Shape derived objects
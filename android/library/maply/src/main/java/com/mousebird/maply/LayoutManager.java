@@ -94,6 +94,19 @@ class LayoutManager
 	public native void setFadeEnabled(boolean enable);
 	public native boolean getFadeEnabled();
 
+	/**
+	 * Keep the drawables between layout passes and only rebuild the ones that changed
+	 */
+	public native void setRetainedMode(boolean retained);
+	public native boolean getRetainedMode();
+
+	/**
+	 * Cluster markers with an index built once per set of markers,
+	 * rather than working out the overlaps on every layout pass
+	 */
+	public native void setClusterIndexing(boolean enable);
+	public native boolean getClusterIndexing();
+
 	static
 	{
 		nativeInit();
@@ -47,6 +47,18 @@ public class Scene
 	 */
 	public native void copyZoomSlots(Scene otherScene, float offset);
 
+	/**
+	 * Limit how much time and how many changes the renderer spends applying
+	 * changes each frame.  Whatever doesn't fit is deferred to the next frame.
+	 * Zero for either value means no limit.
+	 */
+	public native void setChangeBudget(double maxTime, int maxCount);
+
+	/**
+	 * Number of changes that didn't fit in the budget and are waiting for a later frame.
+	 */
+	public native int getNumDeferredChanges();
+
 	/**
 	 * Tear down the OpenGL resources.  Context needs to be set first.
 	 */
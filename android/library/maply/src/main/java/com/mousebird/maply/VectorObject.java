@@ -358,11 +358,27 @@ public class VectorObject implements Iterable<VectorObject>
 	 * @return The new vector object or null.
 	 */
 	public VectorObject reproject(CoordSystem srcSystem,double scale,CoordSystem destSystem) {
+		return reproject(srcSystem,scale,destSystem,0.0);
+	}
+
+	/**
+	 * Reproject the vectors from the given system into the destination coordinate system,
+	 * approximating where that's close enough.  For large data sets this can convert a grid
+	 * over the data and interpolate rather than converting every point.  If the grid can't
+	 * stay within the given error, every point is converted as usual.
+	 *
+	 * @param srcSystem Source coordinate system (that the data is already in)
+	 * @param scale Scale factor to apply to the coordinates. 1.0 is a good default.
+	 * @param destSystem Destination coordinate system that we'll project data into.
+	 * @param maxError How far off a point can be, in destination units.  Zero converts every point.
+	 * @return The new vector object or null.
+	 */
+	public VectorObject reproject(CoordSystem srcSystem,double scale,CoordSystem destSystem,double maxError) {
 		final VectorObject retVecObj = new VectorObject();
-		return reprojectNative(retVecObj,srcSystem,scale,destSystem) ? retVecObj : null;
+		return reprojectNative(retVecObj,srcSystem,scale,destSystem,maxError) ? retVecObj : null;
 	}
 
-	private native boolean reprojectNative(VectorObject vecObj,CoordSystem srcSystem,double scale,CoordSystem destSystem);
+	private native boolean reprojectNative(VectorObject vecObj,CoordSystem srcSystem,double scale,CoordSystem destSystem,double maxError);
 
 	/**
 	 * Filter out edges created from clipping areal features on the server.
@@ -80,6 +80,9 @@ public:
     /// Return the local MBR, if we're working in a non-geo coordinate system
     virtual Mbr getLocalMbr() const override;
 
+    /// True if the geometry is already in clip coordinates
+    bool getClipCoords() const { return clipCoords; }
+
     /// Return the Matrix if there is an active one (ideally not)
     virtual const Eigen::Matrix4d *getMatrix() const override;
 
@@ -88,16 +88,5 @@ public:
 typedef std::vector<ChangeRequest *> ChangeSet;
 typedef std::shared_ptr<ChangeSet> ChangeSetRef;
 
-typedef struct ChangeSorter
-{
-    bool operator () (const ChangeRequest *a,const ChangeRequest *b) const
-    {
-        if (a->when == b->when)
-            return a < b;
-        return a->when < b->when;
-    }
-} ChangeSorter;
-/// This version is sorted by when to run it
-typedef std::set<ChangeRequest *,ChangeSorter> SortedChangeSet;
     
 }
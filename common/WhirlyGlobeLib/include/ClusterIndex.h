@@ -0,0 +1,104 @@
+/*
+ *  ClusterIndex.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <vector>
+#import "WhirlyVector.h"
+
+namespace WhirlyKit
+{
+
+/** Hierarchical point clustering, along the lines of supercluster.
+    Points are given in a unit square (spherical mercator, for instance) and
+    merged greedily once per zoom level, working up from the most detailed.
+    At zoom level z anything within radius / 2^z of a point is merged with it.
+    Each level is kept sorted as a k-d tree, so finding the clusters in an
+    area at a given zoom level doesn't involve any clustering at all.
+    Levels where nothing merged share the storage of the level below.
+  */
+class ClusterIndex
+{
+public:
+    /// A point or a cluster of them at a particular zoom level
+    struct Node
+    {
+        float x,y;
+        /// Number of original points in here
+        uint32_t numPoints;
+        /// Where the children are in the child level's list
+        uint32_t childStart;
+        uint32_t childCount;
+        /// Index of the original point, if there's just one
+        uint32_t pointIndex;
+    };
+
+    ClusterIndex(double radius = 1.0,int minZoom = 0,int maxZoom = 20);
+
+    /// Build the levels for the given points, replacing anything there.
+    /// Returns false (and leaves the index empty) if cancelled.
+    bool load(const Point2dVector &pts,const volatile bool *cancel = nullptr);
+
+    /// Forget everything
+    void clear();
+
+    /// Number of points passed to load
+    size_t numPoints() const { return numPts; }
+
+    /// Merge distance at the given zoom level, in units
+    double getRadius(int zoom) const;
+
+    /// Zoom level where clusters will be about mergeDist apart at the given scale.
+    /// Zoom levels past the maximum have all the points, unclustered.
+    int zoomForScale(double pixelsPerUnit,double mergeDist) const;
+
+    /// Add the nodes at the given zoom level which fall within the bounds
+    void getClusters(const Point2d &ll,const Point2d &ur,int zoom,std::vector<uint32_t> &nodeIDs) const;
+
+    /// Look at a node returned by getClusters
+    const Node &getNode(int zoom,uint32_t nodeID) const;
+
+    /// Add the indices of all the original points in a node
+    void getLeaves(int zoom,uint32_t nodeID,std::vector<uint32_t> &pointIndices) const;
+
+protected:
+    struct Level
+    {
+        std::vector<Node> nodes;
+        // Children of the nodes, as indices into the child level
+        std::vector<uint32_t> children;
+        int childLevel = -1;
+
+        void sortKD(size_t left,size_t right,int axis);
+        void range(float minX,float minY,float maxX,float maxY,std::vector<uint32_t> &results) const;
+        void within(float x,float y,float radius,std::vector<uint32_t> &results) const;
+    };
+
+    // Storage for a zoom level, clamped to what we've got
+    int levelForZoom(int zoom) const;
+
+    static constexpr size_t KDNodeSize = 64;
+    static constexpr uint32_t NoPoint = (uint32_t)-1;
+
+    double radius;
+    int minZoom,maxZoom;
+    size_t numPts = 0;
+    std::vector<Level> levels;
+    // Which level stores each zoom level, from minZoom to maxZoom+1
+    std::vector<int> zoomLevels;
+};
+
+}
@@ -25,6 +25,7 @@
 #import "LayoutManager.h"
 #import "LoftManager.h"
 #import "MarkerManager.h"
+#import "MbrRTree.h"
 #import "ParticleSystemManager.h"
 #import "SceneGraphManager.h"
 #import "ShapeManager.h"
@@ -218,6 +219,11 @@ protected:
     std::unordered_multimap<std::string, ComponentObjectRef> compObjsByUUID;
 
     std::unordered_map<std::string, std::string> representations;
+
+    // Geographic bounds of the component objects with vectors, for findVectors.
+    // Those with a vector offset are searched around a different point, so they're kept aside.
+    MbrRTree vecObjTree;
+    SimpleIDSet offsetVecCompIDs;
     
     // Single entry for a mask ID
     class MaskEntry {
@@ -70,6 +70,14 @@ public:
     /// Convert from display coordinates to geocentric
     virtual Point3f geocentricToLocal(Point3f) const = 0;
     virtual Point3d geocentricToLocal(Point3d) const = 0;
+
+    /// Batch versions of the above for a run of points.
+    /// These skip the virtual call per point and subclasses can do the whole run at once.
+    /// The 3D versions can work in place, so in and out may be the same.
+    virtual void localToGeographicBatch(const Point3d *in,Point2d *out,size_t num) const;
+    virtual void geographicToLocalBatch(const Point2d *in,Point3d *out,size_t num) const;
+    virtual void localToGeocentricBatch(const Point3d *in,Point3d *out,size_t num) const;
+    virtual void geocentricToLocalBatch(const Point3d *in,Point3d *out,size_t num) const;
     
     /// Return true if the given coordinate system is the same as the one passed in
     virtual bool isSameAs(const CoordSystem *coordSys) const { return false; }
@@ -80,7 +88,44 @@ typedef std::shared_ptr<CoordSystem> CoordSystemRef;
 /// Convert a point from one coordinate system to another
 Point3f CoordSystemConvert(const CoordSystem *inSystem,const CoordSystem *outSystem,const Point3f &inCoord);
 Point3d CoordSystemConvert3d(const CoordSystem *inSystem,const CoordSystem *outSystem,const Point3d &inCoord);
+/// Convert a run of points from one coordinate system to another, in place is fine
+void CoordSystemConvert3d(const CoordSystem *inSystem,const CoordSystem *outSystem,const Point3d *inCoords,Point3d *outCoords,size_t num);
     
+/** Approximates the conversion from one coordinate system to another over an area
+    with a regular grid of samples, interpolating in between.
+    The grid is refined until the error in the middle of the cells is within the given
+    bound (in output units), up to a maximum number of cells on a side.  If it can't
+    get there it isn't valid and everything goes through the exact conversion.
+    Points outside the area are always converted exactly.
+    This is worth it when converting lots of points through something expensive, like proj.4.
+  */
+class CoordSystemConvertGrid
+{
+public:
+    CoordSystemConvertGrid(const CoordSystem *inSystem,const CoordSystem *outSystem,
+                           const MbrD &mbr,double maxError,int maxCells = 256);
+
+    /// True if the grid is usable within its error bound
+    bool isValid() const { return cells > 0; }
+
+    /// Number of cells on each side, zero if it's not valid
+    int getNumCells() const { return cells; }
+
+    /// Convert a run of points, in place is fine
+    void convert(const Point3d *in,Point3d *out,size_t num) const;
+
+protected:
+    // Interpolate within the grid, the point must be inside
+    Point3d interpolate(const Point3d &pt) const;
+
+    const CoordSystem *inSystem,*outSystem;
+    MbrD mbr;
+    int cells;
+    Point2d cellSize;
+    // Converted corners of the cells, row by row
+    Point3dVector samples;
+};
+
 /** The Coordinate System Display Adapter handles the task of
     converting coordinates in the native system to data values we
     can display.
@@ -147,6 +192,14 @@ public:
     virtual Point3f normalForLocal(Point3f) const = 0;
     virtual Point3d normalForLocal(Point3d) const = 0;
 
+    /// Batch versions of the above for a run of points, in and out may be the same
+    virtual void localToDisplayBatch(const Point3d *in,Point3d *out,size_t num) const;
+    virtual void displayToLocalBatch(const Point3d *in,Point3d *out,size_t num) const;
+    virtual void normalForLocalBatch(const Point3d *in,Point3d *out,size_t num) const;
+
+    /// Convert a run of geographic coordinates all the way to display coordinates
+    void geographicToDisplayBatch(const Point2d *in,Point3d *out,size_t num) const;
+
     /// Get a reference to the coordinate system
     virtual CoordSystem *getCoordSystem() const = 0;
     
@@ -192,6 +245,11 @@ public:
     /// For flat systems the normal is Z up.
     virtual Point3f normalForLocal(Point3f) const override { return Point3f(0,0,1); }
     virtual Point3d normalForLocal(Point3d) const override { return Point3d(0,0,1); }
+
+    /// Batch versions of the above
+    virtual void localToDisplayBatch(const Point3d *in,Point3d *out,size_t num) const override;
+    virtual void displayToLocalBatch(const Point3d *in,Point3d *out,size_t num) const override;
+    virtual void normalForLocalBatch(const Point3d *in,Point3d *out,size_t num) const override;
     
     /// Get a reference to the coordinate system
     virtual CoordSystem *getCoordSystem() const override { return coordSys; }
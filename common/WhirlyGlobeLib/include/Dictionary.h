@@ -18,6 +18,8 @@
  *
  */
 
+#import <string>
+#import <string_view>
 #import "Identifiable.h"
 #import "WhirlyVector.h"
 #import "CoordSystem.h"
@@ -38,6 +40,29 @@ typedef std::shared_ptr<Dictionary> DictionaryRef;
 class DictionaryEntry;
 typedef std::shared_ptr<DictionaryEntry> DictionaryEntryRef;
 
+/// Non-owning look at a single value in a dictionary.
+/// Strings point into the dictionary, so this is only good as long as the dictionary is.
+struct DictionaryEntryView
+{
+    DictionaryType type = DictTypeNone;
+    /// Set for DictTypeInt, DictTypeInt64 and DictTypeIdentity
+    int64_t intVal = 0;
+    /// Set for DictTypeDouble
+    double doubleVal = 0.0;
+    /// Set for DictTypeString
+    std::string_view stringVal;
+
+    /// Value as a 64 bit int, parsing strings, or 0 for anything else
+    int64_t getInt64() const;
+    /// Value as a double, parsing strings, or 0 for anything else
+    double getDouble() const;
+    /// The string, or empty if it isn't one
+    std::string_view getStringView() const { return (type == DictTypeString) ? stringVal : std::string_view(); }
+    /// Add the value to a string, formatted the way Dictionary::getString would.
+    /// Returns false for types that don't convert.
+    bool appendString(std::string &str) const;
+};
+
 /// The Dictionary is my cross platform replacement for NSDictionary
 class Dictionary
 {
@@ -78,6 +103,12 @@ public:
     virtual std::vector<DictionaryEntryRef> getArray(const std::string &name) const = 0;
     // Return an array of key names
     virtual std::vector<std::string> getKeys() const = 0;
+
+    /// Returns true if getEntryView is implemented
+    virtual bool supportsEntryViews() const { return false; }
+    /// Look at a value without making a copy of it.
+    /// Returns false if the field is missing or views aren't supported.
+    virtual bool getEntryView(const std::string &name,DictionaryEntryView &view) const { return false; }
 };
 
 class MutableDictionary;
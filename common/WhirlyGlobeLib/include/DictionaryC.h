@@ -18,9 +18,11 @@
  *
  */
 
+#import <algorithm>
 #import <map>
 #import <unordered_map>
 #import <string>
+#import <vector>
 #import "WhirlyVector.h"
 #import "CoordSystem.h"
 #import "RawData.h"
@@ -35,6 +37,109 @@ typedef std::shared_ptr<MutableDictionaryC> MutableDictionaryCRef;
 class DictionaryEntryC;
 typedef std::shared_ptr<DictionaryEntryC> DictionaryEntryCRef;
 
+/// Convert a packed AARRGGBB value to a color
+RGBAColor ARGBtoRGBAColor(uint32_t v);
+/// Parse a hex color (RGB, ARGB, RRGGBB or AARRGGBB) without the leading '#'
+RGBAColor parseColor(const char* p, RGBAColor defVal);
+
+/** Map that's just a vector of pairs while it's small, which is how most feature
+    dictionaries stay.  Lookups are a linear scan with no allocations per entry.
+    Past a few dozen entries a hash index is built alongside.
+    Erasing moves the last entry into the hole, so the order isn't kept.
+    Only as much of the std::unordered_map interface as we use.
+  */
+template <typename K,typename V>
+class SmallMap
+{
+public:
+    typedef std::pair<K,V> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    SmallMap() = default;
+    explicit SmallMap(size_t capacity) { entries.reserve(std::min(capacity,FlatLimit)); }
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    void clear() { entries.clear();  index.clear(); }
+
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+
+    iterator find(const K &key) { return entries.begin() + findIdx(key); }
+    const_iterator find(const K &key) const { return entries.begin() + findIdx(key); }
+
+    template <typename P>
+    std::pair<iterator,bool> insert(P &&pair)
+    {
+        const size_t idx = findIdx(pair.first);
+        if (idx < entries.size())
+            return std::make_pair(entries.begin() + idx, false);
+        entries.emplace_back(std::forward<P>(pair));
+        addToIndex();
+        return std::make_pair(entries.end() - 1, true);
+    }
+
+    V &operator[](const K &key)
+    {
+        const size_t idx = findIdx(key);
+        if (idx < entries.size())
+            return entries[idx].second;
+        entries.emplace_back(key, V());
+        addToIndex();
+        return entries.back().second;
+    }
+
+    void erase(const_iterator it)
+    {
+        const size_t idx = it - entries.cbegin();
+        if (!index.empty())
+            index.erase(entries[idx].first);
+        if (idx + 1 < entries.size())
+        {
+            entries[idx] = std::move(entries.back());
+            if (!index.empty())
+                index[entries[idx].first] = idx;
+        }
+        entries.pop_back();
+    }
+
+protected:
+    static constexpr size_t FlatLimit = 32;
+
+    // Index of the entry, or the size if it's not there
+    size_t findIdx(const K &key) const
+    {
+        if (index.empty())
+        {
+            for (size_t ii = 0; ii < entries.size(); ii++)
+                if (entries[ii].first == key)
+                    return ii;
+            return entries.size();
+        }
+        const auto it = index.find(key);
+        return (it != index.end()) ? it->second : entries.size();
+    }
+
+    // Keep the index up to date with the last entry, or build it once we're big enough
+    void addToIndex()
+    {
+        if (!index.empty())
+            index[entries.back().first] = entries.size() - 1;
+        else if (entries.size() > FlatLimit)
+        {
+            index.reserve(entries.size() * 2);
+            for (size_t ii = 0; ii < entries.size(); ii++)
+                index[entries[ii].first] = ii;
+        }
+    }
+
+    std::vector<value_type> entries;
+    std::unordered_map<K,size_t> index;
+};
+
 /// The Dictionary is my cross platform replacement for NSDictionary
 /// TODO: Removing & adding things repeatedly will just cause this to grow
 class MutableDictionaryC : public MutableDictionary
@@ -117,6 +222,11 @@ public:
     virtual std::vector<DictionaryEntryRef> getArray(unsigned int key) const;
     // Return an array of keys
     virtual std::vector<std::string> getKeys() const override;
+    /// We can hand out views of our values
+    virtual bool supportsEntryViews() const override { return true; }
+    /// Look at a value without making a copy of it
+    virtual bool getEntryView(const std::string &name,DictionaryEntryView &view) const override;
+    virtual bool getEntryView(unsigned int key,DictionaryEntryView &view) const;
 
     /// Get the key for the given string
     int getKeyID(const std::string &name);
@@ -216,12 +326,12 @@ protected:
     std::vector<MutableDictionaryCRef> dictVals;
     
     // Map strings to integer values for lookup
-    typedef std::unordered_map<std::string,unsigned int> StringMap;
+    typedef SmallMap<std::string,unsigned int> StringMap;
     StringMap stringMap;
     
     // TODO: Turn the values into an array and index the string values separately from keys
     // Map integer key values into fields
-    typedef std::unordered_map<unsigned int,Value> ValueMap;
+    typedef SmallMap<unsigned int,Value> ValueMap;
     ValueMap valueMap;
 };
 
@@ -0,0 +1,101 @@
+/*
+ *  DrawableSpatialIndex.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <memory>
+#import <unordered_map>
+#import <vector>
+#import "Identifiable.h"
+#import "WhirlyVector.h"
+
+namespace WhirlyKit
+{
+
+class Drawable;
+
+/** Loose quad tree over the local MBRs of drawables.
+    Each drawable lives in the deepest cell at least as big as it is, chosen by
+    its center, and every cell's bounds are padded by half a cell so there's
+    no straddling.  Adds and removes touch a single cell.
+    Drawables without usable bounds are kept in a list of their own and
+    returned by every query.  Not thread safe, the Scene locks around it.
+  */
+class DrawableSpatialIndex
+{
+public:
+    /// Construct with the extents of the local coordinate system.
+    /// If those aren't valid, nothing is culled.
+    DrawableSpatialIndex(const Mbr &bounds);
+    ~DrawableSpatialIndex();
+
+    /// Add a drawable.  If it's already in here, it's moved.
+    void addDrawable(Drawable *draw);
+
+    /// Remove a drawable by ID
+    void removeDrawable(SimpleIdentity drawID);
+
+    /// Forget all the drawables
+    void clear();
+
+    /// Add the drawables that might overlap the given local MBR to the list,
+    ///  along with any that can't be culled.
+    void findDrawables(const Mbr &localMbr,std::vector<Drawable *> &draws) const;
+
+    /// Total number of drawables
+    size_t size() const { return locations.size(); }
+
+    /// Return true if the drawable has bounds we can cull against
+    static bool getCullMbr(const Drawable *draw,Mbr &mbr);
+
+protected:
+    struct Node;
+
+    struct Entry
+    {
+        Drawable *draw;
+        Mbr mbr;
+    };
+
+    struct Location
+    {
+        Node *node;     // null for the unbounded list
+        size_t index;
+    };
+
+    struct Node
+    {
+        Node(Node *parent,const Mbr &cell) : parent(parent), cell(cell) { }
+
+        Node *parent;
+        Mbr cell;
+        std::vector<Entry> entries;
+        std::unique_ptr<Node> children[4];
+        // Drawables in this node and all those below
+        size_t count = 0;
+    };
+
+    void findDrawables(const Node *node,const Mbr &localMbr,std::vector<Drawable *> &draws) const;
+
+    static constexpr int MaxDepth = 16;
+
+    Node root;
+    bool rootValid;
+    std::vector<Entry> unbounded;
+    std::unordered_map<SimpleIdentity,Location> locations;
+};
+
+}
@@ -31,6 +31,8 @@ namespace WhirlyKit
 
 /** The dynamic texture can have pieces of itself replaced in the layer thread while
     being used in the renderer.  It's used to implement dynamic texture atlases.
+    Space is handed out in cells.  The free space is tracked as the list of maximal
+    free rectangles, so finding a spot is a pass over those rather than over the cells.
   */
 class DynamicTexture : virtual public TextureBase
 {
@@ -91,8 +93,29 @@ public:
     
     /// Return texture cell utilization
     void getUtilization(int &numCell,int &usedCell);
+
+    /// Packing statistics, in cells
+    struct Stats
+    {
+        int numCells = 0;
+        int usedCells = 0;
+        /// Free rectangles we're tracking
+        int numFreeRects = 0;
+        /// Area of the largest free rectangle.  Compare to the free cells for fragmentation.
+        int largestFree = 0;
+    };
+
+    /// Add this texture's packing statistics to the ones passed in
+    void addStats(Stats &stats);
     
 protected:
+    // Take the given region out of the free rectangles
+    void splitFreeRects(const Region &used);
+    // Work out the free rectangles from the grid
+    void rebuildFreeRects();
+    // Regions the renderer is done with go back in the grid
+    void applyReleasedRegions();
+
     /// Used for debugging
     std::string name;
     
@@ -109,6 +132,12 @@ protected:
 
     // Use to track where sub textures are
     bool *layoutGrid;
+    /// Number of cells set in the grid
+    int usedCells = 0;
+    /// The maximal free rectangles, which can overlap one another
+    std::vector<Region> freeRects;
+    /// Set when cells were freed and the free rectangles have to be worked out again
+    bool freeRectsDirty = false;
     
     std::mutex regionLock;
     /// These regions have been released by the renderer
@@ -232,6 +261,9 @@ public:
     /// Get some basic info out
     void getUsage(int &numRegions,int &dynamicTextures);
     
+    /// Packing statistics summed over all the dynamic textures
+    void getStats(DynamicTexture::Stats &stats);
+
     /// Print out some utilization info
     void log();
 
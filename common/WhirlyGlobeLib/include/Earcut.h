@@ -0,0 +1,39 @@
+/*
+ *  Earcut.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "WhirlyVector.h"
+#import "VectorData.h"
+
+namespace WhirlyKit
+{
+
+/** Ear clipping triangulation, after Mapbox's earcut.
+    Holes are bridged into the outer ring and larger rings are indexed
+    along a z-order curve so checking an ear doesn't look at every vertex.
+    This is much quicker than libtess for small, well behaved polygons, but it
+    trusts its input.  The result is checked against the area of the polygon
+    and if they don't agree (self-intersections, overlapping holes, and so on)
+    nothing is added and it returns false so the caller can use TesselateLoops.
+    Triangles are wound the same way as the outer ring, like TesselateLoops.
+  */
+bool EarcutLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris);
+
+/// Ear clip a single ring, with the same rules as EarcutLoops
+bool EarcutRing(const VectorRing &ring,VectorTrianglesRef tris);
+
+}
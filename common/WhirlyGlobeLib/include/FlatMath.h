@@ -48,6 +48,12 @@ public:
     /// Convert from WGS84 geocentric to local coordinates
     virtual Point3f geocentricToLocal(Point3f) const override;
     virtual Point3d geocentricToLocal(Point3d) const override;
+
+    /// Batch versions of the above
+    virtual void localToGeographicBatch(const Point3d *in,Point2d *out,size_t num) const override;
+    virtual void geographicToLocalBatch(const Point2d *in,Point3d *out,size_t num) const override;
+    virtual void localToGeocentricBatch(const Point3d *in,Point3d *out,size_t num) const override;
+    virtual void geocentricToLocalBatch(const Point3d *in,Point3d *out,size_t num) const override;
         
     /// Return true if the other coordinate system is also Plate Carree
     virtual bool isSameAs(const CoordSystem *coordSys) const override;
@@ -32,11 +32,24 @@ public:
     
     // Parse file
     bool parse(FILE *fp);
+    // Parse a file by name, mapping it into memory rather than reading it
+    bool parseFile(const std::string &fileName);
+    // Parse OBJ data that's already in memory.
+    // Larger files are split up at line boundaries and the pieces parsed in parallel.
+    bool parse(const char *data,size_t len);
     // Parse material library
     bool parseMaterials(FILE *fp);
     
     // Convert to raw geometry objects
     void toRawGeometry(std::vector<std::string> &textures,std::vector<GeometryRaw> &rawGeom);
+
+    // Load raw geometry from the cache file if it's up to date with the OBJ and its materials.
+    // Otherwise parse the OBJ, convert it, and write the cache for next time.
+    bool loadCached(const std::string &fileName,const std::string &cacheFile,
+                    std::vector<std::string> &textures,std::vector<GeometryRaw> &rawGeom);
+
+    // Turn off parsing on the shared task scheduler (on by default)
+    void setParallel(bool inParallel) { parallel = inParallel; }
     
     // Vertices point to a vertex and optionally a tex coordinate and normal
     class Vertex
@@ -65,13 +78,15 @@ public:
         double Ka[3],Kd[3],Ks[3],trans,illum;
     };
 
-    // Face is just a collection of vertices
+    // Face is just a run of vertices in faceVerts
     class Face
     {
     public:
+        Face() : mat(nullptr), mtlID(-1), firstVert(0), numVerts(0) { }
         Material *mat;
         int mtlID;
-        std::vector<Vertex> verts;
+        int firstVert;
+        int numVerts;
     };
 
     // Group is currently just a collection of faces
@@ -84,10 +99,17 @@ public:
     
     std::string resourceDir;
     std::vector<Group> groups;
+    // Vertices for all the faces, one after another
+    std::vector<Vertex> faceVerts;
     Point3dVector verts;
     Point2dVector texCoords;
     Point3dVector norms;
     std::vector<Material> materials;
+    // Material libraries we've read, with their full paths
+    std::vector<std::string> mtlFiles;
+
+protected:
+    bool parallel = true;
 };
 
 }
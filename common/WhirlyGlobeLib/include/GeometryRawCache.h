@@ -0,0 +1,55 @@
+/*
+ *  GeometryRawCache.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <memory>
+#import <string>
+#import <vector>
+#import "GeometryManager.h"
+
+namespace WhirlyKit
+{
+
+/** Write raw geometry out to a binary cache file.
+    The arrays are written as-is, in native byte order, so reading them back is
+    just a matter of copying.  The sizes and modification times of the source
+    files are recorded along with them so a stale cache can be spotted.
+    Texture references are kept as the file names they index into.
+    The file is written to the side and renamed into place, so a reader
+    never sees half of one.
+  */
+bool WriteGeometryCache(const std::string &cacheFile,
+                        const std::vector<std::string> &sourceFiles,
+                        const std::vector<std::string> &textures,
+                        const std::vector<GeometryRaw> &rawGeom,
+                        const std::vector<const GeometryRawPoints *> &rawPoints = std::vector<const GeometryRawPoints *>());
+
+/** Read raw geometry from a file written by WriteGeometryCache.
+    The file is mapped into memory and the arrays copied straight out.
+    Every source file recorded in the cache is checked, so the caller only has
+    to pass the ones it knows about up front (e.g. the OBJ, but not its materials).
+    Returns false, leaving the outputs alone, if the file is missing, damaged,
+    from a different version or architecture, wasn't made from the given source
+    files, or any of its source files have changed since it was written.
+  */
+bool ReadGeometryCache(const std::string &cacheFile,
+                       const std::vector<std::string> &sourceFiles,
+                       std::vector<std::string> &textures,
+                       std::vector<GeometryRaw> &rawGeom,
+                       std::vector<std::unique_ptr<GeometryRawPoints>> *rawPoints = nullptr);
+
+}
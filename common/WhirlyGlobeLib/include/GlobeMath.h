@@ -54,6 +54,15 @@ public:
     /// Static version for convenience
     static Point3f GeocentricToLocal(Point3f);
     static Point3d GeocentricToLocal(Point3d);
+
+    /// Batch versions, which hand the whole run to Proj4 at once
+    virtual void localToGeographicBatch(const Point3d *in,Point2d *out,size_t num) const override;
+    virtual void geographicToLocalBatch(const Point2d *in,Point3d *out,size_t num) const override;
+    virtual void localToGeocentricBatch(const Point3d *in,Point3d *out,size_t num) const override { LocalToGeocentric(in,out,num); }
+    virtual void geocentricToLocalBatch(const Point3d *in,Point3d *out,size_t num) const override { GeocentricToLocal(in,out,num); }
+    /// Static versions, in and out may be the same
+    static void LocalToGeocentric(const Point3d *in,Point3d *out,size_t num);
+    static void GeocentricToLocal(const Point3d *in,Point3d *out,size_t num);
     
     /// Convenience routine to convert a whole MBR to local coordinates
     static Mbr GeographicMbrToLocal(GeoMbr);
@@ -96,6 +105,14 @@ public:
     /// Return a normal for the given point
     virtual Point3f normalForLocal(Point3f p) const override { return LocalToDisplay(p); }
     virtual Point3d normalForLocal(Point3d p) const override { return LocalToDisplay(p); }
+
+    /// Batch versions of the above
+    virtual void localToDisplayBatch(const Point3d *in,Point3d *out,size_t num) const override { LocalToDisplay(in,out,num); }
+    virtual void displayToLocalBatch(const Point3d *in,Point3d *out,size_t num) const override { DisplayToLocal(in,out,num); }
+    virtual void normalForLocalBatch(const Point3d *in,Point3d *out,size_t num) const override { LocalToDisplay(in,out,num); }
+    /// Static versions, in and out may be the same
+    static void LocalToDisplay(const Point3d *in,Point3d *out,size_t num);
+    static void DisplayToLocal(const Point3d *in,Point3d *out,size_t num);
     
     /// Get a reference to the coordinate system
     virtual CoordSystem *getCoordSystem() const override { return &geoCoordSys; }
@@ -139,6 +156,14 @@ public:
     /// Return a normal for the given point
     virtual Point3f normalForLocal(Point3f p) const override { return LocalToDisplay(p); }
     virtual Point3d normalForLocal(Point3d p) const override { return LocalToDisplay(p); }
+
+    /// Batch versions of the above
+    virtual void localToDisplayBatch(const Point3d *in,Point3d *out,size_t num) const override { LocalToDisplay(in,out,num); }
+    virtual void displayToLocalBatch(const Point3d *in,Point3d *out,size_t num) const override { DisplayToLocal(in,out,num); }
+    virtual void normalForLocalBatch(const Point3d *in,Point3d *out,size_t num) const override { LocalToDisplay(in,out,num); }
+    /// Static versions, in and out may be the same
+    static void LocalToDisplay(const Point3d *in,Point3d *out,size_t num);
+    static void DisplayToLocal(const Point3d *in,Point3d *out,size_t num);
     
     /// Get a reference to the coordinate system
     virtual CoordSystem *getCoordSystem() const override { return &geoCoordSys; }
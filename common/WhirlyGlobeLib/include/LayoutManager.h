@@ -18,6 +18,7 @@
 
 #import "Identifiable.h"
 #import "BasicDrawable.h"
+#import "ClusterIndex.h"
 #import "Scene.h"
 #import "SceneRenderer.h"
 #import "ScreenSpaceBuilder.h"
@@ -291,6 +292,16 @@ public:
     void setFadeOutTime(TimeInterval time);
     TimeInterval getFadeOutTime() const { return oldObjectFadeOut; }
 
+    /// Keep the drawables from one layout pass to the next and only rebuild the
+    /// groups of objects where something changed, rather than everything every time
+    void setRetainedMode(bool retained);
+    bool getRetainedMode() const { return retainedMode; }
+
+    /// Cluster with a hierarchical index built once per set of objects, rather than
+    /// working out the overlaps on the screen every pass
+    void setClusterIndexing(bool enable);
+    bool getClusterIndexing() const { return clusterIndexing; }
+
     /// Show lines around layout objects for debugging/troubleshooting
     bool getShowDebugBoundaries() const { return showDebugBoundaries; }
     void setShowDebugBoundaries(bool show) {
@@ -319,6 +330,11 @@ protected:
                              const ViewStateRef &viewState,
                              const Mbr &screenMbr,
                              const Point2f &frameBufferSize);
+    static bool calcScreenPt(Point2f &objPt,
+                             const Point3d &worldLoc,
+                             const ViewStateRef &viewState,
+                             const Mbr &screenMbr,
+                             const Point2f &frameBufferSize);
     static Eigen::Matrix2d calcScreenRot(float &screenRot,
                                          const ViewStateRef &viewState,
                                          const WhirlyGlobe::GlobeViewState *globeViewState,
@@ -369,6 +385,7 @@ protected:
                              ClusteredObjectsSet &clusterGroups,
                              std::vector<ClusterEntry> &clusterEntries,
                              std::vector<ClusterGenerator::ClusterClassParams> &outClusterParams,
+                             bool indexClusters,
                              const ViewStateRef &viewState,
                              Maply::MapViewState *mapViewState,
                              WhirlyGlobe::GlobeViewState *globeViewState,
@@ -377,6 +394,41 @@ protected:
                              const Eigen::Matrix4d &modelTrans,
                              const Eigen::Matrix4d &normalMat);
 
+    /// Precomputed clusters for one cluster group
+    struct ClusterIndexEntry
+    {
+        // The objects in the group, in the order they went into the index
+        std::vector<LayoutObjectEntryRef> objs;
+        ClusterIndex index;
+        // Set on each pass the group shows up in
+        bool inUse = false;
+
+        // A cluster we've already worked out at the current zoom level
+        struct Cluster
+        {
+            std::vector<LayoutObjectEntryRef> objs;
+            Point3d worldLoc;
+        };
+        int cacheZoom = -1;
+        std::unordered_map<uint32_t,Cluster> clusters;
+    };
+
+    bool runIndexedClustering(PlatformThreadInfo *threadInfo,
+                              const ClusteredObjects &clusterGroup,
+                              const ClusterGenerator::ClusterClassParams &params,
+                              LayoutContainerVec &layoutObjs,
+                              std::vector<ClusterEntry> &clusterEntries,
+                              int clusterParamID,
+                              const ViewStateRef &viewState,
+                              Maply::MapViewState *mapViewState,
+                              WhirlyGlobe::GlobeViewState *globeViewState,
+                              const Point2f &frameBufferSize,
+                              const Mbr &screenMbr,
+                              const Eigen::Matrix4d &modelTrans);
+
+    // Point the objects at their new cluster and figure out which old one it came from, if any
+    static int assignToCluster(const std::vector<LayoutObjectEntryRef> &objsForCluster,int clusterEntryID);
+
     void layoutAlongShape(const LayoutObjectEntryRef &layoutObj,
                           const ViewStateRef &viewState,
                           const Point2f &frameBufferSize,
@@ -396,6 +448,46 @@ protected:
                         UnorderedIDSetbyUID *newUniqueDrawableMap,
                         const UnorderedIDSetbyUID *oldUniqueDrawableMap);
 
+    /// Objects laid out in retained mode are grouped by drawable state.
+    /// A group's drawables are only rebuilt when one of its objects changes.
+    struct RetainedBucket
+    {
+        ScreenSpaceBuilder::DrawableState state;
+        // Objects placed along a shape move every pass, so they're kept apart
+        bool alongShape = false;
+        LayoutEntrySet objs;
+        SimpleIDSet drawIDs;
+        bool dirty = false;
+    };
+    typedef std::shared_ptr<RetainedBucket> RetainedBucketRef;
+    typedef std::map<ScreenSpaceBuilder::DrawableState,std::vector<RetainedBucketRef>> RetainedBucketMap;
+
+    struct RetainedObject
+    {
+        LayoutObjectEntryRef entry;
+        RetainedBucketRef bucket;
+    };
+
+    // Build the screen space geometry for a single layout object
+    static void addLayoutObject(ScreenSpaceBuilder &ssBuild,const LayoutObject &obj,SimpleIDUnorderedSet *drawIDs);
+
+    // Drawable state the object will be grouped under
+    static ScreenSpaceBuilder::DrawableState retainedStateFor(const LayoutObject &obj);
+
+    void addRetained(const LayoutObjectEntryRef &entry);
+    void removeRetained(std::unordered_map<SimpleIdentity,RetainedObject>::iterator it);
+
+    void updateRetained(TimeInterval curTime,
+                        TimeInterval &maxAnimTime,
+                        const LayoutEntrySet &localLayoutObjects,
+                        bool hadRemoves,
+                        const std::vector<ClusterEntry> &oldClusters,
+                        const std::vector<ClusterGenerator::ClusterClassParams> &oldClusterParams,
+                        std::vector<BasicDrawableRef> &newDraws,
+                        ChangeSet &changes);
+
+    void clearRetained(ChangeSet &changes);
+
     void handleFadeOut(const TimeInterval curTime,
                        TimeInterval &maxAnimTime,
                        const LayoutEntrySet &localLayoutObjects,
@@ -458,6 +550,28 @@ protected:
     
     // Mapping of object unique IDs to drawables from the previous run
     UnorderedIDSetbyUID uniqueDrawableIDs;
+
+    /// Build drawables incrementally
+    bool retainedMode = false;
+    /// The mode the current drawables were built in
+    bool builtRetained = false;
+    /// Most objects in a group we'll rebuild at once in retained mode
+    static constexpr size_t MaxRetainedBucketObjects = 256;
+    RetainedBucketMap retainedBuckets;
+    /// Which group each retained object lives in, by object ID
+    std::unordered_map<SimpleIdentity,RetainedObject> retainedObjs;
+    /// Number of retained objects showing for each unique ID
+    std::unordered_map<std::string,int> retainedUniqueIDs;
+    /// Groups waiting to be rebuilt
+    std::vector<RetainedBucketRef> dirtyBuckets;
+    /// Use a precomputed index for clustering
+    bool clusterIndexing = false;
+    /// Cluster indices by cluster group
+    std::map<int,ClusterIndexEntry> clusterIndexes;
+    /// Generator that made the cluster layout objects we're holding on to
+    ClusterGenerator *indexClusterGen = nullptr;
+    /// Clusters and cluster animations, which are rebuilt every pass
+    SimpleIDSet transientDrawIDs;
 };
 typedef std::shared_ptr<LayoutManager> LayoutManagerRef;
 
@@ -19,6 +19,7 @@
  */
 
 #import <math.h>
+#import <tuple>
 #import "WhirlyVector.h"
 #import "Scene.h"
 #import "GlobeMath.h"
@@ -160,6 +161,16 @@ public:
     // Remove all the various geometry
     void cleanup(ChangeSet &changes);
 
+    // Fill in the display coordinates for a tile's sample grid.
+    // Tiles in the same row on the globe usually differ only by a rotation,
+    //  so if it's cacheable we'll try spinning one we've already converted into place.
+    void buildTileGrid(const QuadTreeNew::Node &ident,int tessX,int tessY,
+                       const Point2d &chunkLL,const Point2d &incr,bool cacheable,
+                       Point3dVector &locs);
+
+    // Convert a single point from the tile coordinate system to display
+    Point3d localToDisplay(const Point3d &pt) const;
+
 protected:
     TileGeomSettings settings;
     
@@ -187,6 +198,18 @@ public:
     
 protected:
     std::map<QuadTreeNew::Node,LoadedTileNewRef> tileMap;
+
+    // Display grids by level, row and sampling
+    typedef std::tuple<int,int,int,int> TileGridKey;
+    std::map<TileGridKey,Point3dVector> gridCache;
+    static constexpr size_t MaxTileGrids = 256;
+    // How far off a moved grid can be, relative to its distance from the origin
+    static constexpr double TileGridTolerance = 1e-9;
+    // Reprojected grids with at least this many points are interpolated from a coarser one
+    static constexpr size_t TileGridInterpMinPoints = 256;
+    static constexpr int TileGridInterpCells = 8;
+    // How far off an interpolated point can be, relative to the size of the tile
+    static constexpr double TileGridInterpError = 1e-5;
 };
 
 }
@@ -21,6 +21,7 @@
 #import "Dictionary.h"
 #import "QuadTreeNew.h"
 #import <string>
+#import <unordered_map>
 
 namespace WhirlyKit
 {
@@ -37,6 +38,111 @@ typedef std::shared_ptr<MapboxVectorStyleSetImpl> MapboxVectorStyleSetImplRef;
 class MapboxVectorFilter;
 typedef std::shared_ptr<MapboxVectorFilter> MapboxVectorFilterRef;
 
+/**
+ @brief Compiled form of one or more filters.
+ 
+ Filter trees are flattened into a single instruction table.  Attribute names are collected
+ into slots which are looked up at most once per evaluation, and literal values are converted
+ to the types they'll be compared as up front.  Evaluating doesn't allocate.
+
+ Identical predicates are only stored once, no matter how many filters use them, so the
+ style set keeps one program for all the layers of a source layer.  Predicates shared
+ that way are evaluated once per feature and the results kept in a small bitset.
+ 
+ The attributes passed to evaluate must support entry views.
+ */
+class MapboxVectorFilterProgram
+{
+protected:
+    static constexpr unsigned MaxCachedSlots = 32;
+    static constexpr unsigned MaxMemoWords = 8;
+
+public:
+    /// Per-feature evaluation state, meant to live on the stack.
+    /// Reuse it for all the filters in a program that test the same feature.
+    class Context
+    {
+    public:
+        Context(const Dictionary &attrs,const QuadTreeIdentifier &tileID);
+
+        /// Set if the attributes can be used with compiled filters at all
+        bool usable() const { return useViews; }
+
+        /// Tie this context to a program, returning false if it's already tied to a different one
+        bool bind(const MapboxVectorFilterProgram *program);
+
+    protected:
+        friend class MapboxVectorFilterProgram;
+
+        const Dictionary &attrs;
+        const QuadTreeIdentifier &tileID;
+        const MapboxVectorFilterProgram *program = nullptr;
+        const bool useViews;
+        uint32_t fetched = 0;
+        uint64_t evaluated[MaxMemoWords];
+        uint64_t results[MaxMemoWords];
+        DictionaryEntryView views[MaxCachedSlots];
+    };
+
+    /// Add a filter (and its sub-filters), returning the index of its root instruction
+    uint32_t add(const MapboxVectorFilter &filter);
+
+    /// Evaluate the given root instruction against a feature's attributes
+    bool evaluate(uint32_t root,const Dictionary &attrs,const QuadTreeIdentifier &tileID) const;
+
+    /// Evaluate the given root instruction with a context that may be shared with other roots
+    bool evaluate(uint32_t root,Context &ctx) const;
+
+    /// Number of distinct instructions
+    size_t size() const { return instrs.size(); }
+
+    /// Number of times an instruction was reused rather than added
+    size_t sharedCount() const { return numShared; }
+
+protected:
+    typedef enum {OpFalse,OpGeomEqual,OpGeomNotEqual,OpCompare,OpIn,OpNotIn,OpHas,OpNotHas,OpAll,OpAny} OpType;
+
+    // Literal value, with all the conversions we might need done ahead of time
+    struct Literal
+    {
+        DictionaryType type = DictTypeNone;
+        std::string strVal;
+        int intVal = 0;
+        int64_t int64Val = 0;
+        double doubleVal = 0.0;
+    };
+
+    struct Instruction
+    {
+        OpType op = OpFalse;
+        MapboxVectorFilterType filterType = MBFilterNone;
+        // Attribute slot
+        uint32_t slot = 0;
+        // Range of literals or child instructions, or the geometry type for the geometry ops
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        // Number of filters and instructions referring to this one
+        uint32_t refs = 0;
+    };
+
+    uint32_t addSlot(const std::string &attrName);
+    uint32_t addLiteral(const DictionaryEntryRef &entry,bool numeric);
+    uint32_t addInstr(const Instruction &instr,size_t literalStart,size_t childStart);
+    std::string instrKey(const Instruction &instr) const;
+    const DictionaryEntryView &getAttr(uint32_t slot,Context &ctx,DictionaryEntryView &scratch) const;
+    bool matchLiteral(const Literal &lit,const DictionaryEntryView &val) const;
+    bool evalInstr(uint32_t which,Context &ctx) const;
+    bool evalInstrDirect(uint32_t which,Context &ctx) const;
+
+    std::vector<Instruction> instrs;
+    std::vector<uint32_t> children;
+    std::vector<Literal> literals;
+    std::vector<std::string> slots;
+    std::unordered_map<std::string,uint32_t> instrsByKey;
+    size_t numShared = 0;
+};
+typedef std::shared_ptr<MapboxVectorFilterProgram> MapboxVectorFilterProgramRef;
+
 /// @brief Filter is used to match data in a layer to styles
 class MapboxVectorFilter
 {
@@ -46,9 +152,19 @@ public:
     /// @brief Parse the filter info out of the style entry
     bool parse(const std::vector<DictionaryEntryRef> &styleEntry,MapboxVectorStyleSetImpl *styleSet);
 
+    /// @brief Build the compiled version of the filter, used by testFeature when possible
+    /// @param sharedProgram Add to this program, rather than making a new one
+    void compile(const MapboxVectorFilterProgramRef &sharedProgram = MapboxVectorFilterProgramRef());
+
     /// @brief Test a feature's attributes against the filter
     bool testFeature(Dictionary const& attrs,const QuadTreeIdentifier &tileID);
 
+    /// @brief Test a feature with an evaluation context shared with other filters
+    bool testFeature(MapboxVectorFilterProgram::Context &ctx,Dictionary const& attrs,const QuadTreeIdentifier &tileID);
+
+    /// @brief Walk the filter tree to test a feature's attributes
+    bool testFeatureTree(Dictionary const& attrs,const QuadTreeIdentifier &tileID);
+
     /// @brief The comparison type for this filter
     MapboxVectorFilterType filterType;
 
@@ -66,6 +182,10 @@ public:
 
     /// @brief For All and Any these are the MapboxVectorFilters to evaluate
     std::vector<MapboxVectorFilterRef> subFilters;
+
+    /// @brief Compiled version of the filter, if any
+    MapboxVectorFilterProgramRef program;
+    uint32_t programRoot = 0;
 };
 
 }
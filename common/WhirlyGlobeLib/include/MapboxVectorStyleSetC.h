@@ -22,6 +22,7 @@
 #import "MarkerManager.h"
 #import "ComponentManager.h"
 #import "MapboxVectorTileParser.h"
+#import "MapboxVectorFilter.h"
 #import "MaplyVectorStyleC.h"
 #import "MapboxVectorStyleSpritesImpl.h"
 #import <set>
@@ -300,6 +301,12 @@ public:
                                                              const Dictionary &attrs,
                                                              const QuadTreeIdentifier &tileID,
                                                              const std::string &layerName) override;
+
+    /// We only read the attributes during stylesForFeature, so any implementation will do
+    virtual bool supportsLazyAttributes() const override { return true; }
+
+    /// Matching and building don't modify the style set, so a tile's layers can be parsed in parallel
+    virtual bool supportsParallelParsing() const override { return true; }
     
     /// Return true if the given layer is meant to display for the given tile (zoom level)
     virtual bool layerShouldDisplay(PlatformThreadInfo *inst,
@@ -382,6 +389,9 @@ public:
     /// @brief Layers sorted by source layer name
     std::unordered_multimap<std::string, MapboxVectorStyleLayerRef> layersBySource;
 
+    /// Compiled filters shared by all the layers of a source layer
+    std::unordered_map<std::string, MapboxVectorFilterProgramRef> filterProgramsBySource;
+
     VectorManagerRef vecManage;
     WideVectorManagerRef wideVecManage;
     MarkerManagerRef markerManage;
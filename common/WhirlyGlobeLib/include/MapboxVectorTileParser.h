@@ -113,6 +113,10 @@ public:
     /// Parse everything, even if there's no style for it
     void setParseAll(bool b = true) { parseAll = b; }
 
+    /// Decode the layers and build the styles of a tile on the shared task scheduler,
+    ///  if the style delegate allows it.  On by default.
+    void setParallel(bool b = true) { parallel = b; }
+
     /// Add a category for a particulary style ID
     /// These are used for sorting later on
     void addCategory(const std::string &category,long long styleID);
@@ -163,6 +167,9 @@ protected:
     /// Parse everything, even if there's no style for it
     bool parseAll;
 
+    /// Work on the layers and styles in parallel when we can
+    bool parallel;
+
     /// If set, we'll tack a debug label in the middle of the tile
     bool debugLabel;
 
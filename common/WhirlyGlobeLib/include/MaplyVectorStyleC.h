@@ -125,6 +125,16 @@ public:
                                                              const QuadTreeIdentifier &tileID,
                                                              const std::string &layerName) = 0;
     
+    /// Return true if stylesForFeature can work with any Dictionary implementation and
+    /// doesn't hold on to the attributes after it returns.  Tile parsers can then pass in
+    /// a lightweight view of the feature and only build a full dictionary for matches.
+    virtual bool supportsLazyAttributes() const { return false; }
+
+    /// Return true if stylesForFeature, layerShouldDisplay and the styles' buildObjects
+    /// can be called from several threads at once for the same tile.  Tile parsers
+    /// can then work on the layers and styles of a tile in parallel.
+    virtual bool supportsParallelParsing() const { return false; }
+
     /// Return true if the given layer is meant to display for the given tile (zoom level)
     virtual bool layerShouldDisplay(PlatformThreadInfo *inst,
                                     const std::string &name,
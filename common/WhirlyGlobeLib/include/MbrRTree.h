@@ -0,0 +1,62 @@
+/*
+ *  MbrRTree.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "Identifiable.h"
+#import "RTree.h"
+
+namespace WhirlyKit
+{
+
+/** R-tree over 2D bounding boxes, keyed by ID.
+    This is the flat cousin of SelectableRTree, for things like geographic
+    bounds where all we want back is whatever overlaps an area.
+    Boxes are taken as given, nothing here knows about the anti-meridian.
+    Not thread safe, lock around it.
+  */
+class MbrRTree
+{
+public:
+    /// Add an entry, replacing any with the same ID
+    void insert(SimpleIdentity ident,const MbrD &mbr);
+
+    /// Remove an entry
+    void remove(SimpleIdentity ident) { tree.remove(ident); }
+
+    /// Forget everything
+    void clear() { tree.clear(); }
+
+    /// Number of entries
+    size_t size() const { return tree.size(); }
+    bool empty() const { return tree.empty(); }
+
+    /// Add the IDs of the entries that overlap the given box, edges included.
+    /// These are in no particular order.
+    void findOverlapping(const MbrD &mbr,std::vector<SimpleIdentity> &idents) const;
+
+protected:
+    // Nothing to carry along besides the box
+    struct Payload
+    {
+        void add(const Payload &) { }
+    };
+    typedef RTree<SimpleIdentity,Point2d,Payload> Tree;
+
+    Tree tree;
+};
+
+}
@@ -57,7 +57,7 @@ protected:
     bool checkObject(const Point2dVector &pts, const Mbr &objMbr,
                      int sx, int sy, int ex, int ey,
                      const char* mergeID);
-    void addObject(Point2dVector pts, std::string mergeID,
+    void addObject(Point2dVector pts, std::string mergeID, const Mbr &objMbr,
                    int sx, int sy, int ex, int ey);
 
     struct GridCell
@@ -73,18 +73,18 @@ protected:
         BoundedObject(const BoundedObject&) = default;
         BoundedObject& operator=(const BoundedObject&) = default;
 
-        BoundedObject(const Point2dVector& inPts, const char* id) :
-                pts(inPts), mergeID(id ? id : std::string())
+        BoundedObject(const Point2dVector& inPts, const char* id, const Mbr &inMbr) :
+                pts(inPts), mergeID(id ? id : std::string()), mbr(inMbr)
         {
         }
 
-        BoundedObject(Point2dVector&& inPts, std::string &&id) :
-                pts(std::move(inPts)), mergeID(std::move(id))
+        BoundedObject(Point2dVector&& inPts, std::string &&id, const Mbr &inMbr) :
+                pts(std::move(inPts)), mergeID(std::move(id)), mbr(inMbr)
         {
         }
 
         BoundedObject(BoundedObject&& that) :
-                pts(std::move(that.pts)), mergeID(std::move(that.mergeID))
+                pts(std::move(that.pts)), mergeID(std::move(that.mergeID)), mbr(that.mbr)
         {
         }
         BoundedObject& operator=(BoundedObject&& that)
@@ -93,12 +93,15 @@ protected:
             {
                 pts = std::move(that.pts);
                 mergeID = std::move(that.mergeID);
+                mbr = that.mbr;
             }
             return *this;
         }
 
         Point2dVector pts;
         std::string mergeID;
+        // Bounds of the points, which is what we test against
+        Mbr mbr;
     };
 
     GridCell &cellAt(int x, int y) { return grid[y * sizeX + x]; }
@@ -111,6 +114,11 @@ protected:
     std::vector<BoundedObject> objects;
     std::vector<GridCell> grid;
 
+    // The check that last looked at each object, so objects spanning
+    //  several cells are only tested once per check
+    std::vector<uint32_t> objectChecks;
+    uint32_t curCheck = 0;
+
     // Estimate the fraction of objects likely to fall in a given cell
     const double overlapHeuristic = 0.1;
 
@@ -49,6 +49,13 @@ public:
     /// Convert from display coordinates to geocentric
     virtual Point3f geocentricToLocal(Point3f) const override;
     virtual Point3d geocentricToLocal(Point3d) const override;
+
+    /// Batch versions of the above.  These hand the whole run to proj.4 in one call.
+    /// Points that can't be converted come back as zeros, as with the single versions.
+    virtual void localToGeographicBatch(const Point3d *in,Point2d *out,size_t num) const override;
+    virtual void geographicToLocalBatch(const Point2d *in,Point3d *out,size_t num) const override;
+    virtual void localToGeocentricBatch(const Point3d *in,Point3d *out,size_t num) const override;
+    virtual void geocentricToLocalBatch(const Point3d *in,Point3d *out,size_t num) const override;
     
     /// True if the other system is Spherical Mercator with the same origin
     virtual bool isSameAs(const CoordSystem *coordSys) const override;
@@ -0,0 +1,533 @@
+/*
+ *  RTree.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <algorithm>
+#import <cmath>
+#import <memory>
+#import <unordered_map>
+#import <vector>
+#import "WhirlyVector.h"
+
+namespace WhirlyKit
+{
+
+/** R-tree over axis aligned boxes, keyed by ID, with a quadratic split.
+    The point type sets the dimension (Point2d, Point3d).
+    Each entry carries a payload and each node carries the payloads of everything
+    below it, merged with the payload's add(), so searches can prune on those too.
+    The payload needs a default constructor and an add(const Payload &).
+    Not thread safe, lock around it.
+  */
+template <typename IDType,typename PointType,typename PayloadType>
+class RTree
+{
+public:
+    struct Box
+    {
+        PointType ll,ur;
+        void add(const Box &that)
+        {
+            ll = ll.cwiseMin(that.ll);
+            ur = ur.cwiseMax(that.ur);
+        }
+    };
+
+    struct Entry
+    {
+        IDType ident;
+        Box box;
+        PayloadType payload;
+    };
+
+    RTree() : root(std::make_unique<Node>()) { }
+
+    /// Add an entry, replacing any with the same ID
+    void insert(const IDType &ident,const Box &box,const PayloadType &payload = PayloadType())
+    {
+        remove(ident);
+        insertEntry(Entry { ident, box, payload });
+    }
+
+    /// Remove an entry
+    void remove(const IDType &ident);
+
+    /// Look up an entry, null if it isn't here
+    const Entry *find(const IDType &ident) const
+    {
+        const auto it = leaves.find(ident);
+        if (it == leaves.end())
+            return nullptr;
+        for (const auto &entry : it->second->entries)
+        {
+            if (entry.ident == ident)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    /// Change an entry's payload in place
+    void setPayload(const IDType &ident,const PayloadType &payload)
+    {
+        const auto it = leaves.find(ident);
+        if (it == leaves.end())
+            return;
+        for (auto &entry : it->second->entries)
+        {
+            if (entry.ident == ident)
+            {
+                entry.payload = payload;
+                updateBounds(it->second);
+                break;
+            }
+        }
+    }
+
+    /// Forget everything
+    void clear()
+    {
+        root = std::make_unique<Node>();
+        leaves.clear();
+    }
+
+    /// Number of entries
+    size_t size() const { return leaves.size(); }
+    bool empty() const { return leaves.empty(); }
+
+    /// Walk down the nodes that pass the test and hand over the entries that pass it too.
+    /// The test gets a box and a payload, for nodes and entries both.
+    template <typename TestFunc,typename EntryFunc>
+    void search(const TestFunc &test,const EntryFunc &func) const
+    {
+        if (root->count() == 0)
+            return;
+
+        std::vector<const Node *> stack { root.get() };
+        while (!stack.empty())
+        {
+            const Node *node = stack.back();
+            stack.pop_back();
+            if (!test(node->box, node->payload))
+                continue;
+
+            if (node->leaf)
+            {
+                for (const auto &entry : node->entries)
+                {
+                    if (test(entry.box, entry.payload))
+                    {
+                        func(entry);
+                    }
+                }
+            }
+            else
+            {
+                for (const auto &child : node->children)
+                {
+                    stack.push_back(child.get());
+                }
+            }
+        }
+    }
+
+protected:
+    struct Node
+    {
+        Node *parent = nullptr;
+        Box box;
+        PayloadType payload;
+        // Leaves hold entries, everything else holds nodes
+        bool leaf = true;
+        std::vector<Entry> entries;
+        std::vector<std::unique_ptr<Node>> children;
+
+        size_t count() const { return leaf ? entries.size() : children.size(); }
+    };
+
+    // Size of a box for deciding where things go.  A lot of what goes in is flat
+    //  (or points, or lines), so fall back to the margin when the areas are equal.
+    struct Cost
+    {
+        double area;
+        double margin;
+
+        bool operator < (const Cost &that) const
+        {
+            return area < that.area || (area == that.area && margin < that.margin);
+        }
+        Cost operator - (const Cost &that) const { return Cost { area - that.area, margin - that.margin }; }
+    };
+
+    // Area in 2D, surface area (well, half of it) in 3D
+    static Cost measure(const Box &box)
+    {
+        const PointType span = box.ur - box.ll;
+        Cost cost { 0.0, 0.0 };
+        for (int ii = 0; ii < span.size(); ii++)
+        {
+            cost.margin += span[ii];
+            for (int jj = ii + 1; jj < span.size(); jj++)
+                cost.area += span[ii] * span[jj];
+        }
+        return cost;
+    }
+
+    static Box merge(Box a,const Box &b)
+    {
+        a.add(b);
+        return a;
+    }
+
+    void insertEntry(const Entry &entry);
+    Node *chooseLeaf(const Box &box) const;
+    void splitNode(Node *node);
+    static void recalcBounds(Node *node);
+    void gatherEntries(Node *node,std::vector<Entry> &entries);
+
+    void updateBounds(Node *node)
+    {
+        for (; node; node = node->parent)
+        {
+            recalcBounds(node);
+        }
+    }
+
+    static constexpr size_t MaxEntries = 16;
+    static constexpr size_t MinEntries = 4;
+
+    std::unique_ptr<Node> root;
+    // Which leaf each entry lives in
+    std::unordered_map<IDType,Node *> leaves;
+};
+
+template <typename IDType,typename PointType,typename PayloadType>
+void RTree<IDType,PointType,PayloadType>::insertEntry(const Entry &entry)
+{
+    Node *leaf = chooseLeaf(entry.box);
+    leaf->entries.push_back(entry);
+    leaves[entry.ident] = leaf;
+    updateBounds(leaf);
+
+    if (leaf->entries.size() > MaxEntries)
+    {
+        splitNode(leaf);
+    }
+}
+
+template <typename IDType,typename PointType,typename PayloadType>
+typename RTree<IDType,PointType,PayloadType>::Node *RTree<IDType,PointType,PayloadType>::chooseLeaf(const Box &box) const
+{
+    Node *node = root.get();
+    while (!node->leaf)
+    {
+        // Whichever child grows the least, then the smallest
+        Node *best = nullptr;
+        Cost bestGrowth { 0, 0 }, bestSize { 0, 0 };
+        for (const auto &child : node->children)
+        {
+            const Cost size = measure(child->box);
+            const Cost growth = measure(merge(child->box, box)) - size;
+            if (!best || growth < bestGrowth || (!(bestGrowth < growth) && size < bestSize))
+            {
+                best = child.get();
+                bestGrowth = growth;
+                bestSize = size;
+            }
+        }
+        node = best;
+    }
+    return node;
+}
+
+template <typename IDType,typename PointType,typename PayloadType>
+void RTree<IDType,PointType,PayloadType>::splitNode(Node *node)
+{
+    const size_t num = node->count();
+    std::vector<Box> boxes(num);
+    for (size_t ii = 0; ii < num; ii++)
+    {
+        boxes[ii] = node->leaf ? node->entries[ii].box : node->children[ii]->box;
+    }
+
+    // Quadratic split.  Start with the pair that would waste the most space together.
+    size_t seed0 = 0, seed1 = 1;
+    Cost worst { -1, -1 };
+    for (size_t ii = 0; ii < num; ii++)
+    {
+        for (size_t jj = ii + 1; jj < num; jj++)
+        {
+            const Cost waste = measure(merge(boxes[ii], boxes[jj])) - measure(boxes[ii]) - measure(boxes[jj]);
+            if (worst < waste)
+            {
+                worst = waste;
+                seed0 = ii;
+                seed1 = jj;
+            }
+        }
+    }
+
+    std::vector<int> group(num, -1);
+    group[seed0] = 0;
+    group[seed1] = 1;
+    Box groupBox[2] = { boxes[seed0], boxes[seed1] };
+    size_t groupCount[2] = { 1, 1 };
+    size_t left = num - 2;
+
+    while (left > 0)
+    {
+        // If one side needs everything that's left to be full enough, it gets it
+        for (int which = 0; which < 2; which++)
+        {
+            if (groupCount[which] + left <= MinEntries)
+            {
+                for (size_t ii = 0; ii < num; ii++)
+                {
+                    if (group[ii] < 0)
+                    {
+                        group[ii] = which;
+                        groupBox[which].add(boxes[ii]);
+                        groupCount[which]++;
+                    }
+                }
+                left = 0;
+            }
+        }
+        if (left == 0)
+            break;
+
+        // Place the one with the strongest preference next
+        size_t next = 0;
+        Cost nextPref { -1, -1 };
+        Cost nextGrowth[2];
+        for (size_t ii = 0; ii < num; ii++)
+        {
+            if (group[ii] >= 0)
+                continue;
+            const Cost grow0 = measure(merge(groupBox[0], boxes[ii])) - measure(groupBox[0]);
+            const Cost grow1 = measure(merge(groupBox[1], boxes[ii])) - measure(groupBox[1]);
+            const Cost pref { std::abs(grow0.area - grow1.area), std::abs(grow0.margin - grow1.margin) };
+            if (nextPref < pref)
+            {
+                nextPref = pref;
+                next = ii;
+                nextGrowth[0] = grow0;
+                nextGrowth[1] = grow1;
+            }
+        }
+
+        int which;
+        if (nextGrowth[0] < nextGrowth[1])
+            which = 0;
+        else if (nextGrowth[1] < nextGrowth[0])
+            which = 1;
+        else if (measure(groupBox[0]) < measure(groupBox[1]))
+            which = 0;
+        else if (measure(groupBox[1]) < measure(groupBox[0]))
+            which = 1;
+        else
+            which = (groupCount[0] <= groupCount[1]) ? 0 : 1;
+
+        group[next] = which;
+        groupBox[which].add(boxes[next]);
+        groupCount[which]++;
+        left--;
+    }
+
+    // The second group moves to a new sibling
+    auto sibling = std::make_unique<Node>();
+    sibling->leaf = node->leaf;
+    if (node->leaf)
+    {
+        std::vector<Entry> keep;
+        keep.reserve(groupCount[0]);
+        sibling->entries.reserve(groupCount[1]);
+        for (size_t ii = 0; ii < num; ii++)
+        {
+            if (group[ii] == 0)
+            {
+                keep.push_back(node->entries[ii]);
+            }
+            else
+            {
+                sibling->entries.push_back(node->entries[ii]);
+                leaves[node->entries[ii].ident] = sibling.get();
+            }
+        }
+        node->entries.swap(keep);
+    }
+    else
+    {
+        std::vector<std::unique_ptr<Node>> keep;
+        keep.reserve(groupCount[0]);
+        sibling->children.reserve(groupCount[1]);
+        for (size_t ii = 0; ii < num; ii++)
+        {
+            auto &child = node->children[ii];
+            if (group[ii] == 0)
+            {
+                keep.push_back(std::move(child));
+            }
+            else
+            {
+                child->parent = sibling.get();
+                sibling->children.push_back(std::move(child));
+            }
+        }
+        node->children.swap(keep);
+    }
+
+    if (node == root.get())
+    {
+        // Grow a level
+        auto newRoot = std::make_unique<Node>();
+        newRoot->leaf = false;
+        node->parent = newRoot.get();
+        sibling->parent = newRoot.get();
+        newRoot->children.push_back(std::move(root));
+        newRoot->children.push_back(std::move(sibling));
+        root = std::move(newRoot);
+        updateBounds(root->children[0].get());
+        updateBounds(root->children[1].get());
+        return;
+    }
+
+    Node *parent = node->parent;
+    Node *siblingPtr = sibling.get();
+    sibling->parent = parent;
+    parent->children.push_back(std::move(sibling));
+    updateBounds(node);
+    updateBounds(siblingPtr);
+
+    if (parent->children.size() > MaxEntries)
+    {
+        splitNode(parent);
+    }
+}
+
+template <typename IDType,typename PointType,typename PayloadType>
+void RTree<IDType,PointType,PayloadType>::recalcBounds(Node *node)
+{
+    if (node->count() == 0)
+    {
+        node->box = Box { PointType::Zero(), PointType::Zero() };
+        node->payload = PayloadType();
+    }
+    else if (node->leaf)
+    {
+        node->box = node->entries[0].box;
+        node->payload = node->entries[0].payload;
+        for (const auto &entry : node->entries)
+        {
+            node->box.add(entry.box);
+            node->payload.add(entry.payload);
+        }
+    }
+    else
+    {
+        node->box = node->children[0]->box;
+        node->payload = node->children[0]->payload;
+        for (const auto &child : node->children)
+        {
+            node->box.add(child->box);
+            node->payload.add(child->payload);
+        }
+    }
+}
+
+template <typename IDType,typename PointType,typename PayloadType>
+void RTree<IDType,PointType,PayloadType>::gatherEntries(Node *node,std::vector<Entry> &entries)
+{
+    if (node->leaf)
+    {
+        entries.insert(entries.end(), node->entries.begin(), node->entries.end());
+        return;
+    }
+    for (const auto &child : node->children)
+    {
+        gatherEntries(child.get(), entries);
+    }
+}
+
+template <typename IDType,typename PointType,typename PayloadType>
+void RTree<IDType,PointType,PayloadType>::remove(const IDType &ident)
+{
+    const auto it = leaves.find(ident);
+    if (it == leaves.end())
+        return;
+    Node *leaf = it->second;
+    leaves.erase(it);
+
+    auto &entries = leaf->entries;
+    for (size_t ii = 0; ii < entries.size(); ii++)
+    {
+        if (entries[ii].ident == ident)
+        {
+            entries[ii] = entries.back();
+            entries.pop_back();
+            break;
+        }
+    }
+
+    // Take out any nodes that are too empty now and put their contents back in later.
+    // The rest shrink to fit on the way up.
+    std::vector<Entry> orphans;
+    Node *node = leaf;
+    while (node != root.get())
+    {
+        Node *parent = node->parent;
+        if (node->count() < MinEntries)
+        {
+            gatherEntries(node, orphans);
+            auto &siblings = parent->children;
+            for (size_t ii = 0; ii < siblings.size(); ii++)
+            {
+                if (siblings[ii].get() == node)
+                {
+                    if (ii + 1 < siblings.size())
+                        siblings[ii] = std::move(siblings.back());
+                    siblings.pop_back();
+                    break;
+                }
+            }
+        }
+        else
+        {
+            recalcBounds(node);
+        }
+        node = parent;
+    }
+    recalcBounds(root.get());
+
+    // Drop levels with only one child
+    while (!root->leaf && root->children.size() == 1)
+    {
+        auto child = std::move(root->children[0]);
+        child->parent = nullptr;
+        root = std::move(child);
+    }
+    if (!root->leaf && root->children.empty())
+    {
+        root->leaf = true;
+    }
+
+    for (const auto &entry : orphans)
+    {
+        insertEntry(entry);
+    }
+}
+
+}
@@ -21,7 +21,10 @@
 #import <vector>
 #import <set>
 #import <unordered_map>
+#import <atomic>
+#import <limits>
 #import "WhirlyVector.h"
+#import "DrawableSpatialIndex.h"
 #import "Texture.h"
 #import "Program.h"
 #import "BasicDrawableInstance.h"
@@ -267,16 +270,29 @@ public:
     /// You can get the coordinate system we're using from that.
     CoordSystemDisplayAdapter *getCoordAdapter() const;
     
-    /// Add a single change request.  You can call this from any thread, it locks.
+    /// Add a single change request.  You can call this from any thread, it doesn't lock.
     /// If you have more than one, don't iterate, use the other version.
     void addChangeRequest(ChangeRequest *newChange);
-    /// Add a list of change requets.  You can call this from any thread.
+    /// Add a list of change requets.  You can call this from any thread, it doesn't lock.
     /// This is the faster option if you have more than one change request
     void addChangeRequests(const ChangeSet &newchanges);
     
     /// Process change requests
     /// Only the renderer should call this in the rendering thread
+    /// Returns the number of requests executed, which may be fewer than were
+    ///  outstanding if a change budget is set.
     int processChanges(View *view,SceneRenderer *renderer,TimeInterval now);
+
+    /// Limit the work processChanges does in a single call.
+    /// Requests are executed in the order they were added until either the time
+    ///  (in seconds) or the count is used up and the rest are carried over to the next call.
+    /// Since the order is kept, texture adds still precede the drawables using them and
+    ///  a drawable's add still precedes its removal.  At least one request always runs.
+    /// Zero for either means no limit, which is the default.
+    void setChangeBudget(TimeInterval maxTime,int maxCount);
+
+    /// Number of change requests the last call to processChanges carried over
+    int getNumDeferredChanges() const { return numDeferredChanges; }
     
     /// Some changes generate other changes, so they go first
     int preProcessChanges(View *view,SceneRenderer *renderer,TimeInterval now);
@@ -315,6 +331,10 @@ public:
     /// Remove a drawable from the scene
     virtual void remDrawable(SimpleIdentity id);
 
+    /// Call this when something changes where a drawable ends up, like its matrix,
+    ///  so the spatial index can file it again.
+    void updateDrawableBounds(Drawable *drawable);
+
     /// Add a fully formed texture
     virtual void addTexture(TextureBaseRef texRef);
     
@@ -365,6 +385,10 @@ public:
     
     // Return all the drawables in a list.  Only call this on the main thread.
     std::vector<Drawable *> getDrawables() const;
+
+    // Return the drawables which might overlap the given local MBR, plus any we can't cull.
+    // Only call this on the main thread.
+    std::vector<Drawable *> getDrawables(const Mbr &localMbr) const;
     
     // Used for offline frame by frame rendering
     void setCurrentTime(TimeInterval newTime);
@@ -455,6 +479,8 @@ protected:
     /// All the drawables we've been handed, sorted by ID
     mutable std::mutex drawablesLock;
     DrawableRefSet drawables;
+    /// The same drawables, by local MBR
+    std::unique_ptr<DrawableSpatialIndex> drawableIndex;
     
     typedef std::unordered_map<SimpleIdentity,TextureBaseRef> TextureRefSet;
     /// Textures, sorted by ID
@@ -463,11 +489,39 @@ protected:
     /// Mutex for accessing textures
     mutable std::mutex textureLock;
 
-    mutable std::mutex changeRequestLock;
-    /// We keep a list of change requests to execute
-    /// This can be accessed in multiple threads, so we lock it
+    /// A group of change requests handed over by one call to addChangeRequest(s)
+    struct ChangeBatch
+    {
+        ChangeSet changes;
+        ChangeBatch *next = nullptr;
+    };
+
+    /// Move everything the producers have handed over into the consumer side queues.
+    /// Rendering thread only.
+    void takeIncomingChanges();
+    /// Pick up one round of incoming batches.  Returns true if any of them were timed.
+    bool takeIncomingBatches();
+    /// Publish the earliest timed request's start time for hasChanges.  Rendering thread only.
+    void updateNextTimedChange();
+
+    /// Producers push batches onto this list without locking, newest first.
+    /// The rendering thread swaps out the whole list at once.
+    std::atomic<ChangeBatch *> incomingChanges { nullptr };
+    /// Untimed requests which haven't run yet, readable from any thread
+    std::atomic<int> numChangeRequests { 0 };
+    /// When the earliest timed request is due, readable from any thread
+    std::atomic<TimeInterval> nextTimedChange { std::numeric_limits<TimeInterval>::max() };
+
+    /// Change requests ready to execute, in order.  Rendering thread only.
     ChangeSet changeRequests;
-    SortedChangeSet timedChangeRequests;
+    /// Requests with a start time, kept as a min-heap.  Rendering thread only.
+    ChangeSet timedChangeRequests;
+
+    /// Per-call limits for processChanges, zero for none
+    TimeInterval changeTimeBudget = 0.0;
+    int changeCountBudget = 0;
+    /// Requests left over from the last processChanges
+    int numDeferredChanges = 0;
 
         mutable std::mutex subTexLock;
     typedef std::set<SubTexture> SubTextureSet;
@@ -232,6 +232,11 @@ public:
     /// Get the framebuffer size (divided by scale) with a margin
     Mbr getFramebufferBoundScaled(float marginFrac) const;
 
+    /// For flat maps, work out the area in local coordinates visible through the
+    ///  given inverse model/view/projection matrix, padded by the given fraction.
+    /// Returns false if that's not possible, as with a globe or the horizon in view.
+    bool calcVisibleLocalMbr(const Eigen::Matrix4d &mvpInvMat,float marginFrac,Mbr &localMbr) const;
+
     /// Return the attached Scene
     Scene *getScene();
     
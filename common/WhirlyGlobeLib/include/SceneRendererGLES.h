@@ -30,6 +30,7 @@
 namespace WhirlyKit
 {
 class SceneRendererGLES;
+class DrawableGLES;
 
 /** Renderer Frame Info.
  Data about the current frame, passed around by the renderer.
@@ -84,6 +85,9 @@ public:
 
     /// If set, we'll draw one more frame than needed after updates stop
     virtual void setExtraFrameMode(bool newMode);
+
+    /// Remove the drawable from the draw order as well
+    virtual void removeDrawable(DrawableRef draw,bool teardown,RenderTeardownInfoRef teardownInfo) override;
     
     /// Draw stuff (the whole point!)
     void render(TimeInterval period);
@@ -134,6 +138,53 @@ public:
     int extraFrameCount;
 
     RendererFrameInfoGLESRef lastFrameInfo;
+
+protected:
+    /// A drawable's place in the draw order, kept from frame to frame
+    struct DrawOrderEntry
+    {
+        unsigned int drawPriority;
+        bool zBuffer;
+        SimpleIdentity drawID;
+        /// The rest don't affect the order, so they can change in place
+        mutable DrawableGLES *draw;
+        /// Offset matrices the drawable is visible through this frame
+        mutable uint32_t offsetMask;
+        /// Last frame the drawable was visible
+        mutable unsigned int lastFrame;
+    };
+
+    /// Same order as the full sort: priority, then z buffer use (if sorting lines to the end), then ID
+    static bool drawOrderBefore(const DrawOrderEntry &a,const DrawOrderEntry &b,bool sortLinesToEnd);
+
+    struct DrawOrderSorter
+    {
+        bool sortLinesToEnd;
+        bool operator () (const DrawOrderEntry &a,const DrawOrderEntry &b) const
+            { return drawOrderBefore(a,b,sortLinesToEnd); }
+    };
+    typedef std::set<DrawOrderEntry,DrawOrderSorter> DrawOrderSet;
+
+    /// Start a new frame and re-sort if the sort mode changed
+    void beginDrawOrder(bool sortLinesToEnd);
+    /// Note a drawable as visible through the given offset matrix this frame
+    void markDrawOrder(DrawableGLES *draw,unsigned int offset);
+    /// Walk the visible drawables in order, dropping the ones we haven't seen in a while.
+    /// The callback gets each visible drawable once per offset.
+    void finishDrawOrder(const std::function<void(DrawableGLES *,unsigned int)> &callback);
+    /// Forget the draw order entirely
+    void clearDrawOrder();
+
+    /// Most offset matrices the draw order can track
+    static constexpr unsigned int MaxDrawOrderOffsets = 32;
+    /// Frames a drawable can go unseen before we stop tracking it
+    static constexpr unsigned int DrawOrderEvictFrames = 120;
+
+    /// Everything we've drawn recently, sorted by priority, z buffer use and ID
+    DrawOrderSet drawOrder { DrawOrderSorter { false } };
+    /// Where each drawable lives in drawOrder
+    std::unordered_map<SimpleIdentity,DrawOrderSet::iterator> drawOrderPos;
+    unsigned int drawOrderFrame = 0;
 };
     
 typedef std::shared_ptr<SceneRendererGLES> SceneRendererGLESRef;
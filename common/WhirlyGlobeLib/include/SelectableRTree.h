@@ -0,0 +1,87 @@
+/*
+ *  SelectableRTree.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "Identifiable.h"
+#import "RTree.h"
+
+namespace WhirlyKit
+{
+
+/** R-tree over the display space bounds of selectable objects.
+    Entries are keyed by selection ID and can carry a padding in screen units
+    for things that are drawn at a fixed size on the screen.
+    Queries walk down the tree projecting node bounds to the screen and only
+    return the entries that might be within reach of a touch.
+    Not thread safe, the SelectionManager locks around it.
+  */
+class SelectableRTree
+{
+public:
+    /// What we need to project bounds to the screen for a touch
+    struct TouchQuery
+    {
+        /// Model and view matrices, one for each wrapped copy of the world
+        const std::vector<Eigen::Matrix4d> *fullMatrices;
+        const Eigen::Matrix4d *projMatrix;
+        /// Screen size in the same units as the touch point
+        Point2f frameSize;
+        Point2f touchPt;
+        /// Anything within this distance on the screen is a candidate
+        float maxDist;
+    };
+
+    /// Add an entry, replacing any with the same ID.
+    /// Padding is added to the projected bounds, in screen units.
+    void insert(SimpleIdentity selectID,const BBox &bounds,float screenPad = 0.0f);
+
+    /// Remove an entry
+    void remove(SimpleIdentity selectID) { tree.remove(selectID); }
+
+    /// Disabled entries are kept, but not returned
+    void setEnable(SimpleIdentity selectID,bool enable);
+
+    /// Forget everything
+    void clear() { tree.clear(); }
+
+    /// Number of entries, enabled or not
+    size_t size() const { return tree.size(); }
+
+    /// Add the IDs of the enabled entries that might be near the touch, in ID order
+    void findNearTouch(const TouchQuery &query,std::vector<SimpleIdentity> &selectIDs) const;
+
+protected:
+    // Nodes get the largest padding below them and whether anything below is enabled
+    struct Payload
+    {
+        float pad = 0.0f;
+        bool enable = false;
+
+        void add(const Payload &that)
+        {
+            pad = std::max(pad, that.pad);
+            enable = enable || that.enable;
+        }
+    };
+    typedef RTree<SimpleIdentity,Point3d,Payload> Tree;
+
+    static bool nearTouch(const Tree::Box &box,float pad,const TouchQuery &query);
+
+    Tree tree;
+};
+
+}
@@ -26,6 +26,7 @@
 #import "GlobeView.h"
 #import "Scene.h"
 #import "ScreenSpaceBuilder.h"
+#import "SelectableRTree.h"
 #import "VectorObject.h"
 
 namespace WhirlyKit
@@ -339,8 +340,9 @@ protected:
     // Projects a world coordinate to one or more points on the screen (wrapping)
     static void projectWorldPointToScreen(const Point3d &worldLoc,const PlacementInfo &pInfo,Point2dVector &screenPts,float scale);
 
-    // Convert rect selectables into more generic screen space objects
-    void getScreenSpaceObjects(const PlacementInfo &pInfo,std::vector<ScreenSpaceObjectLocation> &screenObjs,TimeInterval now);
+    // Convert rect selectables near the touch into more generic screen space objects
+    void getScreenSpaceObjects(const PlacementInfo &pInfo,const SelectableRTree::TouchQuery &query,
+                               std::vector<ScreenSpaceObjectLocation> &screenObjs,TimeInterval now);
 
     // Internal object picking method
     void pickObjects(const Point2f &touchPt,float maxDist,const ViewStateRef &viewState,
@@ -355,6 +357,13 @@ protected:
     WhirlyKit::MovingPolytopeSelectableSet movingPolytopeSelectables;
     WhirlyKit::LinearSelectableSet linearSelectables;
     WhirlyKit::BillboardSelectableSet billboardSelectables;
+
+    /// Spatial indexes for the ones that don't move.
+    /// The moving and billboard selectables are few and get checked one by one.
+    SelectableRTree rect3DIndex;
+    SelectableRTree rect2DIndex;
+    SelectableRTree polytopeIndex;
+    SelectableRTree linearIndex;
 };
 typedef std::shared_ptr<SelectionManager> SelectionManagerRef;
  
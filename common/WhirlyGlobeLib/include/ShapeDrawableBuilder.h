@@ -134,6 +134,9 @@ public:
     // Creates a new local drawable with all the appropriate settings
     void setupNewDrawable();
 
+    // Expand the drawable's local MBR to cover a vertex in display space
+    void addToMbr(const Point3d &dispPt);
+
     CoordSystemDisplayAdapter *coordAdapter;    
     SceneRenderer *sceneRender;
     Mbr drawMbr;
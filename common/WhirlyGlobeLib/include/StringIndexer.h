@@ -18,9 +18,12 @@
  *
  */
 
+#import <atomic>
+#import <memory>
 #import <vector>
 #import <unordered_map>
 #import <string>
+#import <string_view>
 #import <mutex>
 
 namespace WhirlyKit
@@ -98,26 +101,92 @@ extern StringIdentity a_modelDirNameID;
  than a string in certain high performance unordered maps and such.
  
  Only adds strings.  Never removes them.
+
+ Looking up a string that's already there doesn't lock.  Readers go through
+ a read-only hash table that's replaced wholesale as strings are added.
+ New strings go through one of several locked shards, picked by hash,
+ and show up in the read-only table the next time it's rebuilt.
+ Replaced tables are freed once no reader is left that could be using them.
  */
 class StringIndexer
 {
 public:
     // Return or make up a string identity
-    static StringIdentity getStringID(const std::string &);
+    static StringIdentity getStringID(std::string_view);
     
     // Return the string for a string identity
     static std::string getString(StringIdentity);
     
 protected:
     StringIndexer();
+    ~StringIndexer();
     StringIndexer(StringIndexer const&)     = delete;
     void operator=(StringIndexer const&)    = delete;
 
     static StringIndexer &getInstance() { return instance; }
-    
-    mutable std::mutex mutex;
-    std::unordered_map<std::string,StringIdentity> stringToIdent;
-    std::vector<std::string> identToString;
+
+    // A string and its ID.  These never move once they're made.
+    struct Entry
+    {
+        Entry(std::string_view str,size_t hash,StringIdentity ident) : str(str), hash(hash), ident(ident) { }
+        const std::string str;
+        const size_t hash;
+        const StringIdentity ident;
+    };
+
+    // Read-only open addressed table, replaced rather than modified
+    struct Table
+    {
+        explicit Table(size_t size);
+        const Entry *find(std::string_view str,size_t hash) const;
+        void add(const Entry *entry);
+
+        size_t mask;
+        size_t count = 0;
+        std::vector<const Entry *> slots;
+    };
+
+    // Where new strings go
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string_view,const Entry *> entries;
+        std::vector<std::unique_ptr<Entry>> storage;
+    };
+
+    StringIdentity addString(std::string_view str,size_t hash);
+    const Entry *entryForID(StringIdentity ident) const;
+    void setEntryForID(const Entry *entry);
+    void publish();
+    void reclaim();
+
+    static size_t readerSlot();
+
+    static constexpr size_t NumShards = 16;
+    Shard shards[NumShards];
+
+    // The current read-only table is the last one.  Older ones are kept until
+    //  we can tell that no reader is still in one.
+    std::atomic<const Table *> table;
+    std::mutex publishMutex;
+    std::vector<std::unique_ptr<Table>> tables;
+
+    // Readers count themselves in one of these while they're in a table.
+    // Each thread sticks to one, which keeps them off each other's cache lines.
+    static constexpr size_t NumReaderSlots = 16;
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<int> count;
+    };
+    ReaderSlot readers[NumReaderSlots];
+
+    // IDs are handed out in order.  Looking up the string for one goes through
+    //  fixed size blocks that are allocated as needed and never move.
+    static constexpr size_t IDBlockSize = 1024;
+    static constexpr size_t MaxIDBlocks = 4096;
+    std::atomic<StringIdentity> nextID;
+    std::atomic<std::atomic<const Entry *> *> idBlocks[MaxIDBlocks];
+    std::mutex idBlockMutex;
 
 private:
     static StringIndexer instance;
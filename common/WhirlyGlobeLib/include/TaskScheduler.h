@@ -0,0 +1,155 @@
+/*
+ *  TaskScheduler.h
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <atomic>
+#import <condition_variable>
+#import <deque>
+#import <functional>
+#import <memory>
+#import <mutex>
+#import <thread>
+#import <vector>
+#import "Platform.h"
+
+namespace WhirlyKit
+{
+
+/** Work stealing task scheduler.
+    Each worker thread has its own queue for each priority.  Tasks submitted from a
+    worker go on its own queue and it runs them newest first.  Idle workers take the
+    oldest tasks from the shared queue and then from each other.
+    Tasks are grouped so a caller can wait on or cancel just the ones it submitted.
+  */
+class TaskScheduler
+{
+public:
+    enum Priority {
+        PriorityHigh = 0,
+        PriorityNormal,
+        PriorityLow,
+    };
+    static constexpr int NumPriorities = 3;
+
+    /// A task gets the thread info for the thread it runs on
+    typedef std::function<void(PlatformThreadInfo *)> Task;
+    /// Called on each worker thread when it starts, to make its thread info.
+    /// This is where a platform would attach the thread to its runtime.
+    typedef std::function<PlatformThreadInfo *()> ThreadSetupFunc;
+    /// Called on each worker thread when it stops, to release its thread info
+    typedef std::function<void(PlatformThreadInfo *)> ThreadTeardownFunc;
+
+    /// A set of tasks which can be waited on or cancelled together
+    class TaskGroup
+    {
+    public:
+        /// Tasks which haven't started yet won't be run
+        void cancel() { cancelled = true; }
+
+        /// Tasks can check this to stop early
+        bool isCancelled() const { return cancelled; }
+
+        /// True if all the tasks submitted so far have run (or been skipped)
+        bool isDone() const { return pending == 0; }
+
+    protected:
+        friend class TaskScheduler;
+
+        std::atomic<int> pending { 0 };
+        std::atomic<bool> cancelled { false };
+        std::mutex lock;
+        std::condition_variable done;
+    };
+    typedef std::shared_ptr<TaskGroup> TaskGroupRef;
+
+    /// Start the given number of worker threads, zero for one fewer than the number of cores
+    TaskScheduler(unsigned int numThreads = 0,
+                  ThreadSetupFunc setupFunc = ThreadSetupFunc(),
+                  ThreadTeardownFunc teardownFunc = ThreadTeardownFunc());
+    /// Stops the workers.  Tasks which haven't started are dropped.
+    ~TaskScheduler();
+
+    /// Make a group to submit tasks under
+    TaskGroupRef makeGroup() const { return std::make_shared<TaskGroup>(); }
+
+    /// Queue up a task.  You can call this from any thread.
+    void submit(const TaskGroupRef &group,Task task,Priority priority = PriorityNormal);
+
+    /// Wait for all the tasks in the group to finish.
+    /// Worker threads run other tasks while they wait rather than blocking.
+    void wait(const TaskGroupRef &group);
+
+    /// Run func over [0,count) in pieces of (at most) grainSize, and wait for them all.
+    /// The calling thread does its share with the thread info it passes in.
+    /// Returns false if the group was cancelled before everything ran.
+    bool parallelFor(PlatformThreadInfo *inst,size_t count,size_t grainSize,
+                     const std::function<void(PlatformThreadInfo *,size_t begin,size_t end)> &func,
+                     Priority priority = PriorityNormal,
+                     const TaskGroupRef &group = TaskGroupRef());
+
+    /// Number of worker threads
+    unsigned int getNumThreads() const { return (unsigned int)workers.size(); }
+
+    /// True if the calling thread is one of our workers
+    bool isWorkerThread() const;
+
+    /// Return the scheduler for general use, creating it with the defaults if need be
+    static std::shared_ptr<TaskScheduler> getShared();
+
+    /// Replace the shared scheduler, so a platform can provide its thread setup.
+    /// Anyone already holding the old one keeps it until they let go.
+    static void setShared(std::shared_ptr<TaskScheduler> scheduler);
+
+protected:
+    struct Entry
+    {
+        Task task;
+        TaskGroupRef group;
+    };
+
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<Entry> queues[NumPriorities];
+        std::thread thread;
+    };
+
+    void workerMain(unsigned int which);
+    bool findTask(int which,Entry &entry);
+    void runTask(Entry &entry,PlatformThreadInfo *inst);
+    void finishTask(const TaskGroupRef &group);
+
+    ThreadSetupFunc setupFunc;
+    ThreadTeardownFunc teardownFunc;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /// Tasks submitted from outside the workers
+    std::mutex sharedLock;
+    std::deque<Entry> sharedQueues[NumPriorities];
+
+    /// Idle workers sleep here until something is queued
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::atomic<int> numQueued { 0 };
+    /// Workers sleeping in wait() for another worker to finish a group
+    std::atomic<int> numWaiting { 0 };
+    std::atomic<bool> shuttingDown { false };
+};
+typedef std::shared_ptr<TaskScheduler> TaskSchedulerRef;
+
+}
@@ -18,6 +18,7 @@
  *
  */
 
+#import <functional>
 #import "WhirlyVector.h"
 #import "WhirlyGeometry.h"
 #import "VectorData.h"
@@ -34,5 +35,37 @@ void TesselateRing(const WhirlyKit::VectorRing &ring,VectorTrianglesRef tris);
   */
 void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris);
 
+class BasicDrawableBuilder;
+
+/// Chop up and tesselate an areal's loops, adding the results to the mesh
+typedef std::function<void(const VectorAreal *areal,const VectorTrianglesRef &mesh)> TessLoopsFunc;
+
+/// Called with an areal's mesh before any of it is added.  Work out the per-vertex
+///  data (normals, texture coordinates and so on) here.  Return false to skip it.
+typedef std::function<bool(const VectorAreal *areal,const VectorTriangles &mesh)> TessShapeFunc;
+
+/// Called with the number of points and triangles about to be added.
+/// Return a drawable with room for them, starting a new one if need be.
+typedef std::function<BasicDrawableBuilder *(int numPts,int numTris)> TessDrawableFunc;
+
+/// Add the given vertex of the mesh to the drawable, along with anything else that goes with it
+typedef std::function<void(BasicDrawableBuilder *draw,int which)> TessVertexFunc;
+
+/** Add a tesselated mesh to drawables.
+    Vertices are shared between the triangles.  Meshes too big for a single drawable
+    are broken up, duplicating the vertices along the seams.  Triangles are wound
+    the way the vector drawables always have been, the reverse of the mesh.
+    Returns the number of triangles added.
+  */
+int AddTrianglesToDrawables(const VectorTriangles &mesh,const TessDrawableFunc &drawFunc,const TessVertexFunc &vertFunc);
+
+/** Tesselate all the areal features in a shape set, writing the results straight
+    into drawables through the callbacks.
+    The loops func may be empty, in which case the loops are tesselated as they are.
+    Returns the number of triangles added.
+  */
+int TesselateShapes(const ShapeSet &shapes,const TessLoopsFunc &loopsFunc,const TessShapeFunc &shapeFunc,
+                    const TessDrawableFunc &drawFunc,const TessVertexFunc &vertFunc);
+
 
 }
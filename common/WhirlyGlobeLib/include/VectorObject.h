@@ -21,6 +21,15 @@
 #import "VectorData.h"
 #import "WhirlyKitView.h"
 
+namespace WhirlyGlobe
+{
+class GlobeViewState;
+}
+namespace Maply
+{
+class MapViewState;
+}
+
 namespace WhirlyKit
 {
 
@@ -37,6 +46,39 @@ typedef enum {
 class VectorObject;
 typedef std::shared_ptr<VectorObject> VectorObjectRef;
 
+/** View setup for finding linear features near a point on the screen.
+    The matrices and where the point lands are the same for every object
+    we look at, so work them out once and pass this to pointNearLinear.
+  */
+struct VectorNearQuery
+{
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    VectorNearQuery(const ViewStateRef &viewState,const Point2f &frameSize,
+                    const Point2d &coord,float maxDistance);
+
+    /// Geographic point we're searching around
+    Point2d coord;
+    float maxDistance;
+    Point2f frameSize;
+
+    /// Set if the point is on the screen.  If it isn't, nothing is near it.
+    bool onScreen;
+    /// Where the point is on the screen
+    Point2d screenPt;
+    /// Geographic area within about maxDistance of the point on the screen, including the point
+    GeoMbr searchMbr;
+
+    ViewStateRef viewState;
+    const CoordSystemDisplayAdapter *coordAdapter;
+    WhirlyGlobe::GlobeViewState *globeView;
+    Maply::MapViewState *mapView;
+    Eigen::Matrix4d modelAndViewMat4d;
+    Eigen::Matrix4d modelMatFull;
+    Eigen::Matrix4f modelAndViewMat;
+    Eigen::Matrix4f modelAndViewNormalMat;
+};
+
 /** @brief The C++ object we use to wrap a group of vectors and consolidate the various methods for manipulating vectors.
     @details The VectorObject stores a list of reference counted VectorShape objects.
   */
@@ -104,6 +146,9 @@ public:
     bool pointNearLinear(const Point2d &coord,float maxDistance,
                          const ViewStateRef &viewState,
                          const Point2f &frameBufferSize) const;
+
+    /// Fuzzy matching for linear features, with the view setup done by the caller
+    bool pointNearLinear(const VectorNearQuery &query) const;
     
     /// Calculate the area of all the loops together
     double areaOfOuterLoops() const;
@@ -164,7 +209,9 @@ public:
 
     /// Reproject the vectors from the source system into the destination
     /// We don't recognize units, so pass in a scaling factor
-    void reproject(CoordSystem *srcSystem,double scale,CoordSystem *destSystem);
+    /// If maxError (in destination units) is non-zero, points may be interpolated
+    /// from a grid of conversions rather than converted one by one.
+    void reproject(CoordSystem *srcSystem,double scale,CoordSystem *destSystem,double maxError = 0.0);
 
     /**
      Filter out edges created from clipping areal features on the server.
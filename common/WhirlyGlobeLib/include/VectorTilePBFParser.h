@@ -10,6 +10,7 @@
 #define VectorTilePBFParser_h
 
 #include <Identifiable.h>
+#include <Dictionary.h>
 #include <VectorData.h>
 #include <WhirlyVector.h>
 #include <MapboxVectorTileParser.h>
@@ -33,6 +34,7 @@ namespace WhirlyKit
 
 class MutableDictionaryC;
 class PlatformThreadInfo;
+class TaskScheduler;
 class VectorTileData;
 class VectorStyleDelegateImpl;
 class VectorObject;
@@ -57,7 +59,10 @@ public:
         std::vector<VectorObjectRef>* keepVectors = nullptr,
         CancelFunction isCancelled = [](auto){return false;});
 
-    bool parse(const uint8_t* data, size_t length);
+    /// Parse the tile, one layer after another.
+    /// With a scheduler, the layers are located first and then decoded and styled in
+    /// parallel, if the style delegate allows it.  The results are the same either way.
+    bool parse(const uint8_t* data, size_t length, TaskScheduler *scheduler = nullptr);
 
     unsigned getLayerCount() const { return _layerCount; }
     unsigned getFeatureCount() const { return _featureCount; }
@@ -94,6 +99,21 @@ public:
 private:
     typedef VectorTilePBFParser This;
 
+    // Where a layer is in the tile, found by a quick first pass
+    struct LayerRange
+    {
+        const uint8_t *data;
+        size_t length;
+        std::string_view name;
+        uint32_t extent;
+    };
+
+    // Makes a parser for a single layer, sharing the caller's settings but with its own output
+    VectorTilePBFParser(const VectorTilePBFParser &parent,
+                        PlatformThreadInfo *styleInst,
+                        std::map<SimpleIdentity, std::vector<VectorObjectRef>*>& vecObjByStyle,
+                        std::vector<VectorObjectRef>* keepVectors);
+
     typedef std::unordered_set<SimpleIdentity> SimpleIDUSet;
 
     // This holds a tile value in less space than the one generated by nanopb
@@ -131,12 +151,52 @@ private:
             : tagIndex(tagIdx), geomIndex(geomIdx), geomType(gType) { }
     };
 
+    // Read-only view of a feature's attributes.
+    // Lookups are resolved against the layer's key and value tables, which point into the
+    // tile data, so nothing is copied.  Only valid while the layer is being processed.
+    class FeatureAttributes : public Dictionary
+    {
+    public:
+        FeatureAttributes(const VectorTilePBFParser &parser, const std::string &layerName,
+                          const Feature &feature, size_t tagIdx, int layerOrder);
+
+        virtual int count() const override;
+        virtual bool empty() const override { return false; }
+        virtual bool hasField(const std::string &name) const override;
+        virtual DictionaryType getType(const std::string &name) const override;
+        virtual int getInt(const std::string &name,int defVal) const override;
+        virtual int64_t getInt64(const std::string &name,int64_t defVal) const override;
+        virtual SimpleIdentity getIdentity(const std::string &name) const override;
+        virtual bool getBool(const std::string &name,bool defVal) const override;
+        virtual RGBAColor getColor(const std::string &name,const RGBAColor &defVal) const override;
+        virtual double getDouble(const std::string &name,double defVal) const override;
+        virtual std::string getString(const std::string &name) const override;
+        virtual std::string getString(const std::string &name,const std::string &defVal) const override;
+        virtual DictionaryRef getDict(const std::string &name) const override;
+        virtual DictionaryEntryRef getEntry(const std::string &name) const override;
+        virtual std::vector<DictionaryEntryRef> getArray(const std::string &name) const override;
+        virtual std::vector<std::string> getKeys() const override;
+        virtual bool supportsEntryViews() const override { return true; }
+        virtual bool getEntryView(const std::string &name,DictionaryEntryView &view) const override;
+
+    protected:
+        // Resolve a value, with the tile value types collapsed the same way processTags does
+        DictionaryEntryView find(const std::string &name) const;
+
+        const VectorTilePBFParser &parser;
+        const std::string &layerName;
+        const Feature &feature;
+        const size_t tagIdx;
+        const int layerOrder;
+    };
+
 private:
     static inline int32_t decodeParamInt(int32_t p);
     static inline std::pair<uint8_t, int32_t> decodeCommand(int32_t c);
 
     // nanopb callbacks
     static bool layerDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg);
+    static bool layerScan(pb_istream_t *stream, const pb_field_iter_t *field, void **arg);
     static bool featureDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg);
     static bool stringDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg);
     static bool stringVecDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg);
@@ -148,8 +208,14 @@ private:
     inline bool featureDecode(pb_istream_t *stream, const pb_field_iter_t *field);
 
     // Parsing methods
+    bool parseParallel(const uint8_t* data, size_t length, TaskScheduler &scheduler);
+    inline bool decodeLayer(pb_istream_t *stream, std::string_view &layerName, uint32_t &extent);
+    inline bool displayLayer(std::string_view layerNameView, uint32_t extent, std::string &layerName);
+    inline bool processFeatures(const std::string &layerName, uint32_t extent, int layerOrder);
+    inline void mergeFrom(VectorTilePBFParser &that);
+    inline MutableDictionaryCRef makeAttributes(const std::string &layerName, size_t tagIdx, size_t geomIdx, const Feature &feature);
     inline bool processTags(const MutableDictionaryCRef &attributes, size_t tagIdx, size_t geomIdx, const Feature &feature);
-    inline bool checkStyles(SimpleIDUSet& styleIDs, const MutableDictionaryCRef &attributes, const std::string &layerName);
+    inline bool checkStyles(SimpleIDUSet& styleIDs, const Dictionary &attributes, const std::string &layerName);
     inline void parseLineString(const uint32_t *geometry, size_t geomCount, ShapeSet& shapes) const;
     inline bool parsePolygon(const uint32_t *geometry, size_t geomCount, VectorAreal& shape);
     inline bool parsePoints(const uint32_t *geometry, size_t geomCount, VectorPoints& shape);
@@ -176,6 +242,7 @@ private:
 private:
     // Data parsed and collected
     double _layerScale = 0;
+    int _layerOrder = 0;
     std::vector<uint32_t> _featureTags;
     std::vector<uint32_t> _featureGeometry;
     std::vector<Feature> _features;
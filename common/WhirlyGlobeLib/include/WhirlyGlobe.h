@@ -101,6 +101,7 @@
 #import "SphericalMercator.h"
 #import "StringIndexer.h"
 #import "Sun.h"
+#import "TaskScheduler.h"
 #import "Tesselator.h"
 #import "Texture.h"
 #import "TextureAtlas.h"
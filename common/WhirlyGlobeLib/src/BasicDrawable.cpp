@@ -713,7 +713,11 @@ void TransformChangeRequest::execute2(Scene *scene,SceneRenderer *renderer,Drawa
 {
     BasicDrawableRef basicDraw = std::dynamic_pointer_cast<BasicDrawable>(draw);
     if (basicDraw.get())
+    {
         basicDraw->setMatrix(&newMat);
+        // With a matrix, the local MBR doesn't say where it is anymore
+        scene->updateDrawableBounds(basicDraw.get());
+    }
 }
 
 DrawOrderChangeRequest::DrawOrderChangeRequest(SimpleIdentity drawId,int64_t drawOrder)
@@ -0,0 +1,268 @@
+/*
+ *  ClusterIndex.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <algorithm>
+#import <cmath>
+#import "ClusterIndex.h"
+
+namespace WhirlyKit
+{
+
+void ClusterIndex::Level::sortKD(size_t left,size_t right,int axis)
+{
+    if (right - left <= KDNodeSize)
+        return;
+
+    // Split on the median, alternating axes, the same way the queries walk it
+    const size_t mid = (left + right) / 2;
+    std::nth_element(nodes.begin() + left, nodes.begin() + mid, nodes.begin() + right + 1,
+                     [axis](const Node &a,const Node &b)
+                     { return axis == 0 ? a.x < b.x : a.y < b.y; });
+
+    sortKD(left, mid - 1, 1 - axis);
+    sortKD(mid + 1, right, 1 - axis);
+}
+
+void ClusterIndex::Level::range(float minX,float minY,float maxX,float maxY,std::vector<uint32_t> &results) const
+{
+    if (nodes.empty())
+        return;
+
+    // Each span pushes at most two, so this only needs to be twice the depth
+    struct Span { size_t left,right; int axis; };
+    Span stack[128];
+    int stackSize = 0;
+    stack[stackSize++] = Span { 0, nodes.size() - 1, 0 };
+
+    while (stackSize > 0)
+    {
+        const Span span = stack[--stackSize];
+
+        // Small enough to just look through
+        if (span.right - span.left <= KDNodeSize)
+        {
+            for (size_t ii = span.left; ii <= span.right; ii++)
+            {
+                const Node &node = nodes[ii];
+                if (node.x >= minX && node.x <= maxX && node.y >= minY && node.y <= maxY)
+                    results.push_back((uint32_t)ii);
+            }
+            continue;
+        }
+
+        const size_t mid = (span.left + span.right) / 2;
+        const Node &node = nodes[mid];
+        if (node.x >= minX && node.x <= maxX && node.y >= minY && node.y <= maxY)
+            results.push_back((uint32_t)mid);
+
+        const float val = span.axis == 0 ? node.x : node.y;
+        if ((span.axis == 0 ? minX : minY) <= val)
+            stack[stackSize++] = Span { span.left, mid - 1, 1 - span.axis };
+        if ((span.axis == 0 ? maxX : maxY) >= val)
+            stack[stackSize++] = Span { mid + 1, span.right, 1 - span.axis };
+    }
+}
+
+void ClusterIndex::Level::within(float x,float y,float radius,std::vector<uint32_t> &results) const
+{
+    const size_t start = results.size();
+    range(x - radius, y - radius, x + radius, y + radius, results);
+
+    // Trim the box down to a circle
+    const float radius2 = radius * radius;
+    size_t end = start;
+    for (size_t ii = start; ii < results.size(); ii++)
+    {
+        const Node &node = nodes[results[ii]];
+        const float dx = node.x - x, dy = node.y - y;
+        if (dx * dx + dy * dy <= radius2)
+            results[end++] = results[ii];
+    }
+    results.resize(end);
+}
+
+ClusterIndex::ClusterIndex(double radius,int minZoom,int maxZoom) :
+    radius(radius),
+    minZoom(std::max(minZoom, 0)),
+    maxZoom(std::max(maxZoom, std::max(minZoom, 0)))
+{
+}
+
+void ClusterIndex::clear()
+{
+    levels.clear();
+    zoomLevels.clear();
+    numPts = 0;
+}
+
+double ClusterIndex::getRadius(int zoom) const
+{
+    return std::ldexp(radius, -zoom);
+}
+
+int ClusterIndex::zoomForScale(double pixelsPerUnit,double mergeDist) const
+{
+    if (!(pixelsPerUnit > 0.0) || !(mergeDist > 0.0) || !std::isfinite(pixelsPerUnit))
+        return maxZoom + 1;
+
+    // The merge radius at zoom z is radius/2^z units, which we want to cover mergeDist pixels
+    const double zoom = std::floor(std::log2(radius * pixelsPerUnit / mergeDist));
+    return (int)std::min(std::max(zoom, (double)minZoom), (double)(maxZoom + 1));
+}
+
+int ClusterIndex::levelForZoom(int zoom) const
+{
+    if (zoomLevels.empty())
+        return -1;
+    zoom = std::min(std::max(zoom, minZoom), maxZoom + 1);
+    return zoomLevels[zoom - minZoom];
+}
+
+bool ClusterIndex::load(const Point2dVector &pts,const volatile bool *cancel)
+{
+    clear();
+    if (pts.empty())
+        return true;
+
+    // The points themselves sit one level past the maximum
+    Level pointLevel;
+    pointLevel.nodes.reserve(pts.size());
+    for (size_t ii = 0; ii < pts.size(); ii++)
+    {
+        pointLevel.nodes.push_back(Node { (float)pts[ii].x(), (float)pts[ii].y(), 1, 0, 0, (uint32_t)ii });
+    }
+    pointLevel.sortKD(0, pointLevel.nodes.size() - 1, 0);
+    levels.push_back(std::move(pointLevel));
+    zoomLevels.assign(maxZoom - minZoom + 2, -1);
+    zoomLevels.back() = 0;
+
+    std::vector<uint8_t> processed;
+    std::vector<uint32_t> neighbors;
+    for (int zoom = maxZoom; zoom >= minZoom; zoom--)
+    {
+        const int prevIdx = zoomLevels[zoom + 1 - minZoom];
+        const auto &prevNodes = levels[prevIdx].nodes;
+        const float zoomRadius = (float)getRadius(zoom);
+
+        Level level;
+        level.childLevel = prevIdx;
+        level.nodes.reserve(prevNodes.size());
+        level.children.reserve(prevNodes.size());
+        processed.assign(prevNodes.size(), 0);
+        bool merged = false;
+
+        for (size_t ii = 0; ii < prevNodes.size(); ii++)
+        {
+            if (cancel && *cancel && (ii % 4096) == 0)
+            {
+                clear();
+                return false;
+            }
+            if (processed[ii])
+                continue;
+            processed[ii] = 1;
+
+            // Everything nearby that hasn't been claimed yet goes in with this one
+            const Node &node = prevNodes[ii];
+            neighbors.clear();
+            levels[prevIdx].within(node.x, node.y, zoomRadius, neighbors);
+
+            const uint32_t childStart = (uint32_t)level.children.size();
+            level.children.push_back((uint32_t)ii);
+            uint32_t numPoints = node.numPoints;
+            double wx = (double)node.x * node.numPoints;
+            double wy = (double)node.y * node.numPoints;
+            for (const uint32_t which : neighbors)
+            {
+                if (processed[which])
+                    continue;
+                processed[which] = 1;
+
+                const Node &other = prevNodes[which];
+                level.children.push_back(which);
+                numPoints += other.numPoints;
+                wx += (double)other.x * other.numPoints;
+                wy += (double)other.y * other.numPoints;
+            }
+
+            const uint32_t childCount = (uint32_t)level.children.size() - childStart;
+            merged |= (childCount > 1);
+            level.nodes.push_back(Node { (float)(wx / numPoints), (float)(wy / numPoints),
+                                         numPoints, childStart, childCount,
+                                         numPoints == 1 ? node.pointIndex : NoPoint });
+        }
+
+        if (!merged)
+        {
+            // Same as the level below, so just point at that
+            zoomLevels[zoom - minZoom] = prevIdx;
+            continue;
+        }
+
+        level.nodes.shrink_to_fit();
+        level.sortKD(0, level.nodes.size() - 1, 0);
+        levels.push_back(std::move(level));
+        zoomLevels[zoom - minZoom] = (int)levels.size() - 1;
+    }
+
+    numPts = pts.size();
+    return true;
+}
+
+void ClusterIndex::getClusters(const Point2d &ll,const Point2d &ur,int zoom,std::vector<uint32_t> &nodeIDs) const
+{
+    const int which = levelForZoom(zoom);
+    if (which < 0)
+        return;
+
+    levels[which].range((float)ll.x(), (float)ll.y(), (float)ur.x(), (float)ur.y(), nodeIDs);
+}
+
+const ClusterIndex::Node &ClusterIndex::getNode(int zoom,uint32_t nodeID) const
+{
+    return levels[levelForZoom(zoom)].nodes[nodeID];
+}
+
+void ClusterIndex::getLeaves(int zoom,uint32_t nodeID,std::vector<uint32_t> &pointIndices) const
+{
+    const int which = levelForZoom(zoom);
+    if (which < 0)
+        return;
+
+    std::vector<std::pair<int,uint32_t>> stack;
+    stack.emplace_back(which, nodeID);
+    while (!stack.empty())
+    {
+        const auto entry = stack.back();
+        stack.pop_back();
+
+        const Level &level = levels[entry.first];
+        const Node &node = level.nodes[entry.second];
+        if (node.numPoints == 1)
+        {
+            pointIndices.push_back(node.pointIndex);
+            continue;
+        }
+        for (uint32_t ii = 0; ii < node.childCount; ii++)
+        {
+            stack.emplace_back(level.childLevel, level.children[node.childStart + ii]);
+        }
+    }
+}
+
+}
@@ -19,6 +19,7 @@
 #import "ComponentManager.h"
 #import "WhirlyKitLog.h"
 #import "SharedAttributes.h"
+#import <algorithm>
 
 //#define LOG_REPRESENTATIONS
 
@@ -63,6 +64,54 @@ void ComponentObject::clear()
     drawStringIDs.clear();
 }
 
+// Bounds of a group of vectors.  Anything crossing the anti-meridian is
+//  unwrapped to the east, so the result may run past 180.
+static MbrD VectorBounds(const std::vector<VectorObjectRef> &vecObjs)
+{
+    MbrD mbr;
+    for (const auto &vecObj : vecObjs)
+    {
+        for (const auto &shape : vecObj->shapes)
+        {
+            const GeoMbr geoMbr = shape->calcGeoMbr();
+            if (!geoMbr.valid())
+            {
+                continue;
+            }
+            Point2d ll = geoMbr.ll().cast<double>();
+            Point2d ur = geoMbr.ur().cast<double>();
+            if (ur.x() < ll.x())
+            {
+                ur.x() += 2 * M_PI;
+            }
+            mbr.addPoint(ll);
+            mbr.addPoint(ur);
+        }
+    }
+    return mbr;
+}
+
+// Look for bounds from VectorBounds which overlap a geographic area.
+// Either side might be unwrapped, so check a world to each side as well.
+static void FindVectorBounds(const MbrRTree &tree,const GeoMbr &geoMbr,std::vector<SimpleIdentity> &ids)
+{
+    Point2d ll = geoMbr.ll().cast<double>();
+    Point2d ur = geoMbr.ur().cast<double>();
+    if (ur.x() < ll.x())
+    {
+        ur.x() += 2 * M_PI;
+    }
+
+    const size_t start = ids.size();
+    for (int wrap = -1; wrap <= 1; wrap++)
+    {
+        const Point2d offset(wrap * 2 * M_PI, 0.0);
+        tree.findOverlapping(MbrD(ll + offset, ur + offset), ids);
+    }
+    std::sort(ids.begin() + start, ids.end());
+    ids.erase(std::unique(ids.begin() + start, ids.end()), ids.end());
+}
+
 ComponentManager::ComponentManager() :
     lastMaskID(0)
 {
@@ -88,11 +137,27 @@ void ComponentManager::setScene(Scene *scene)
 
 void ComponentManager::addComponentObject(const ComponentObjectRef &compObj, ChangeSet &changes)
 {
+    // Work out where the vectors are before we lock, they're not going to change
+    const bool hasOffset = (compObj->vectorOffset.x() != 0.0 || compObj->vectorOffset.y() != 0.0);
+    const MbrD vecMbr = (compObj->vecObjs.empty() || hasOffset) ? MbrD() : VectorBounds(compObj->vecObjs);
+
     std::lock_guard<std::mutex> guardLock(lock);
 
     compObj->underConstruction = false;
     compObjsById[compObj->getId()] = compObj;
 
+    if (!compObj->vecObjs.empty())
+    {
+        if (hasOffset)
+        {
+            offsetVecCompIDs.insert(compObj->getId());
+        }
+        else
+        {
+            vecObjTree.insert(compObj->getId(), vecMbr);
+        }
+    }
+
     // Does the new object have a UUID?
     if (!compObj->uuid.empty())
     {
@@ -195,6 +260,12 @@ void ComponentManager::removeComponentObjects_NoLock(PlatformThreadInfo *,
             }
         }
 
+        if (!compObj->vecObjs.empty())
+        {
+            vecObjTree.remove(compID);
+            offsetVecCompIDs.erase(compID);
+        }
+
         objs.push_back(compObj);
 
         compObjsById.erase(it);
@@ -647,17 +718,29 @@ std::vector<std::pair<ComponentObjectRef,VectorObjectRef>> ComponentManager::fin
         const Point2d &pt,double maxDist,const ViewStateRef &viewState,
         const Point2f &frameSize,int resultLimit)
 {
-    // not locked, we don't care if the size is off, we just want
-    // to typically do the allocations outside the locked region.
+    // Set up the view once, along with the area around the touch we need to look at
+    const VectorNearQuery query(viewState, frameSize, pt, (float)maxDist);
+
+    std::vector<SimpleIdentity> compIDs;
     std::vector<ComponentObjectRef> compRefs;
-    compRefs.reserve(compObjsById.size());
 
     // Copy out the vectors that might be candidates
     {
         std::lock_guard<std::mutex> guardLock(lock);
-        for (const auto &kvp: compObjsById)
+
+        // The search area includes the point itself, so this covers anything it's inside too
+        FindVectorBounds(vecObjTree, query.searchMbr, compIDs);
+        compIDs.insert(compIDs.end(), offsetVecCompIDs.begin(), offsetVecCompIDs.end());
+
+        compRefs.reserve(compIDs.size());
+        for (const SimpleIdentity compID : compIDs)
         {
-            const auto &compObj = kvp.second;
+            const auto it = compObjsById.find(compID);
+            if (it == compObjsById.end())
+            {
+                continue;
+            }
+            const auto &compObj = it->second;
             if (compObj->enable && compObj->isSelectable && !compObj->vecObjs.empty())
             {
                 compRefs.push_back(compObj);
@@ -665,18 +748,28 @@ std::vector<std::pair<ComponentObjectRef,VectorObjectRef>> ComponentManager::fin
         }
     }
 
+    // Same order as before, by ID
+    std::sort(compRefs.begin(), compRefs.end(),
+              [](const ComponentObjectRef &a,const ComponentObjectRef &b) { return a->getId() < b->getId(); });
+
     std::vector<std::pair<ComponentObjectRef,VectorObjectRef> > rets;
     rets.reserve((resultLimit > 0) ? resultLimit : compRefs.size());
 
     // Work through the vector objects
     for (const auto &compObj: compRefs)
     {
-        const Point2d coord = pt - compObj->vectorOffset;
+        // Offset vectors are rare, they get their own setup
+        std::unique_ptr<VectorNearQuery> offsetQuery;
+        if (compObj->vectorOffset.x() != 0.0 || compObj->vectorOffset.y() != 0.0)
+        {
+            offsetQuery = std::make_unique<VectorNearQuery>(viewState, frameSize,
+                                                            pt - compObj->vectorOffset, (float)maxDist);
+        }
+        const VectorNearQuery &compQuery = offsetQuery ? *offsetQuery : query;
 
         for (const auto &vecObj: compObj->vecObjs)
         {
-            if (vecObj->pointInside(pt) ||
-                vecObj->pointNearLinear(coord, (float)maxDist, viewState, frameSize))
+            if (vecObj->pointInside(pt) || vecObj->pointNearLinear(compQuery))
             {
                 rets.emplace_back(compObj, vecObj);
             }
@@ -18,12 +18,38 @@
 
 #import "Platform.h"
 #import "CoordSystem.h"
+#import <algorithm>
+#import <limits>
 
 using namespace Eigen;
 
 namespace WhirlyKit
 {
 
+void CoordSystem::localToGeographicBatch(const Point3d *in,Point2d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = localToGeographicD(in[ii]);
+}
+
+void CoordSystem::geographicToLocalBatch(const Point2d *in,Point3d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = geographicToLocal(in[ii]);
+}
+
+void CoordSystem::localToGeocentricBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = localToGeocentric(in[ii]);
+}
+
+void CoordSystem::geocentricToLocalBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = geocentricToLocal(in[ii]);
+}
+
 Point3f CoordSystemConvert(const CoordSystem *inSystem,const CoordSystem *outSystem,const Point3f &inCoord)
 {
     // Easy if the coordinate systems are the same
@@ -44,6 +70,146 @@ Point3d CoordSystemConvert3d(const CoordSystem *inSystem,const CoordSystem *outS
     return outSystem->geocentricToLocal(inSystem->localToGeocentric(inCoord));
 }
 
+void CoordSystemConvert3d(const CoordSystem *inSystem,const CoordSystem *outSystem,const Point3d *inCoords,Point3d *outCoords,size_t num)
+{
+    if (inSystem->isSameAs(outSystem))
+    {
+        if (inCoords != outCoords)
+            std::copy(inCoords, inCoords + num, outCoords);
+        return;
+    }
+
+    inSystem->localToGeocentricBatch(inCoords, outCoords, num);
+    outSystem->geocentricToLocalBatch(outCoords, outCoords, num);
+}
+
+CoordSystemConvertGrid::CoordSystemConvertGrid(const CoordSystem *inSystem,const CoordSystem *outSystem,
+                                               const MbrD &mbr,double maxError,int maxCells) :
+    inSystem(inSystem), outSystem(outSystem), mbr(mbr), cells(0), cellSize(0,0)
+{
+    const Point2d span = mbr.ur() - mbr.ll();
+    if (!mbr.valid() || span.x() <= 0.0 || span.y() <= 0.0)
+        return;
+
+    // Double the resolution until the middles of the cells come out close enough
+    Point3dVector centers,exact;
+    for (int num = 4; num <= maxCells; num *= 2)
+    {
+        cells = num;
+        cellSize = Point2d(span.x() / num, span.y() / num);
+        samples.resize((num+1)*(num+1));
+        for (int iy=0;iy<=num;iy++)
+            for (int ix=0;ix<=num;ix++)
+                samples[iy*(num+1)+ix] = Point3d(mbr.ll().x()+ix*cellSize.x(),mbr.ll().y()+iy*cellSize.y(),0.0);
+        CoordSystemConvert3d(inSystem, outSystem, samples.data(), samples.data(), samples.size());
+
+        centers.resize(num*num);
+        for (int iy=0;iy<num;iy++)
+            for (int ix=0;ix<num;ix++)
+                centers[iy*num+ix] = Point3d(mbr.ll().x()+(ix+0.5)*cellSize.x(),mbr.ll().y()+(iy+0.5)*cellSize.y(),0.0);
+        exact.resize(centers.size());
+        CoordSystemConvert3d(inSystem, outSystem, centers.data(), exact.data(), centers.size());
+
+        double err = 0.0;
+        for (size_t ii=0;ii<centers.size();ii++)
+        {
+            const Point3d diff = interpolate(centers[ii]) - exact[ii];
+            // NaNs fail too
+            if (!(std::abs(diff.x()) <= maxError && std::abs(diff.y()) <= maxError))
+            {
+                err = std::numeric_limits<double>::infinity();
+                break;
+            }
+            err = std::max(err, std::max(std::abs(diff.x()), std::abs(diff.y())));
+        }
+        if (err <= maxError)
+            return;
+    }
+
+    // Too curvy to approximate this way
+    cells = 0;
+    samples.clear();
+}
+
+Point3d CoordSystemConvertGrid::interpolate(const Point3d &pt) const
+{
+    const double fx = (pt.x() - mbr.ll().x()) / cellSize.x();
+    const double fy = (pt.y() - mbr.ll().y()) / cellSize.y();
+    const int ix = std::min(std::max((int)fx, 0), cells-1);
+    const int iy = std::min(std::max((int)fy, 0), cells-1);
+    const double tx = fx - ix, ty = fy - iy;
+
+    const Point3d &p00 = samples[iy*(cells+1)+ix];
+    const Point3d &p10 = samples[iy*(cells+1)+ix+1];
+    const Point3d &p01 = samples[(iy+1)*(cells+1)+ix];
+    const Point3d &p11 = samples[(iy+1)*(cells+1)+ix+1];
+    const Point3d bottom = p00 + (p10 - p00) * tx;
+    const Point3d top = p01 + (p11 - p01) * tx;
+    Point3d ret = bottom + (top - bottom) * ty;
+    // The samples were taken at zero height, which just carries through
+    ret.z() += pt.z();
+
+    return ret;
+}
+
+void CoordSystemConvertGrid::convert(const Point3d *in,Point3d *out,size_t num) const
+{
+    if (!isValid())
+    {
+        CoordSystemConvert3d(inSystem, outSystem, in, out, num);
+        return;
+    }
+
+    // Anything outside gets done the slow way, all together
+    std::vector<size_t> outside;
+    Point3dVector outsidePts;
+    for (size_t ii=0;ii<num;ii++)
+    {
+        const Point3d &pt = in[ii];
+        if (pt.x() >= mbr.ll().x() && pt.y() >= mbr.ll().y() &&
+            pt.x() <= mbr.ur().x() && pt.y() <= mbr.ur().y())
+        {
+            out[ii] = interpolate(pt);
+        }
+        else
+        {
+            outside.push_back(ii);
+            outsidePts.push_back(pt);
+        }
+    }
+
+    if (!outside.empty())
+    {
+        CoordSystemConvert3d(inSystem, outSystem, outsidePts.data(), outsidePts.data(), outsidePts.size());
+        for (size_t ii=0;ii<outside.size();ii++)
+            out[outside[ii]] = outsidePts[ii];
+    }
+}
+
+void CoordSystemDisplayAdapter::localToDisplayBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = localToDisplay(in[ii]);
+}
+
+void CoordSystemDisplayAdapter::displayToLocalBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = displayToLocal(in[ii]);
+}
+
+void CoordSystemDisplayAdapter::normalForLocalBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = normalForLocal(in[ii]);
+}
+
+void CoordSystemDisplayAdapter::geographicToDisplayBatch(const Point2d *in,Point3d *out,size_t num) const
+{
+    coordSys->geographicToLocalBatch(in, out, num);
+    localToDisplayBatch(out, out, num);
+}
+
 GeneralCoordSystemDisplayAdapter::GeneralCoordSystemDisplayAdapter(CoordSystem *coordSys,const Point3d &ll,const Point3d &ur,
                                                                    const Point3d &inCenter,const Point3d &inScale) :
     CoordSystemDisplayAdapter(coordSys,inCenter),
@@ -103,4 +269,30 @@ Point3d GeneralCoordSystemDisplayAdapter::displayToLocal(Point3d dispPt) const
             center;
 }
 
+void GeneralCoordSystemDisplayAdapter::localToDisplayBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    const double sx = scale.x(), sy = scale.y(), sz = scale.z();
+    const double cx = center.x(), cy = center.y(), cz = center.z();
+    for (size_t ii=0;ii<num;ii++)
+    {
+        const Point3d &pt = in[ii];
+        out[ii] = Point3d(pt.x()*sx - cx, pt.y()*sy - cy, pt.z()*sz - cz);
+    }
+}
+
+void GeneralCoordSystemDisplayAdapter::displayToLocalBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    const double cx = center.x(), cy = center.y(), cz = center.z();
+    for (size_t ii=0;ii<num;ii++)
+    {
+        const Point3d &pt = in[ii];
+        out[ii] = Point3d(pt.x()/scale.x() + cx, pt.y()/scale.y() + cy, pt.z()/scale.z() + cz);
+    }
+}
+
+void GeneralCoordSystemDisplayAdapter::normalForLocalBatch(const Point3d *,Point3d *out,size_t num) const
+{
+    std::fill(out, out + num, Point3d(0,0,1));
+}
+
 }
@@ -18,12 +18,66 @@
  *
  */
 
+#import <cstring>
 #import <sstream>
 #import "Dictionary.h"
 
 namespace WhirlyKit
 {
 
+namespace {
+    // Strings from views aren't necessarily terminated
+    template <typename T, typename F>
+    T parseView(std::string_view str, F f)
+    {
+        char buf[64];
+        if (str.size() < sizeof(buf))
+        {
+            memcpy(buf, str.data(), str.size());
+            buf[str.size()] = 0;
+            return (T)f(buf);
+        }
+        return (T)f(std::string(str).c_str());
+    }
+}
+
+// These follow the conversions done by DictionaryEntryC
+int64_t DictionaryEntryView::getInt64() const
+{
+    switch (type) {
+        case DictTypeInt:
+        case DictTypeInt64:
+        case DictTypeIdentity: return intVal;
+        case DictTypeDouble:   return (int64_t)doubleVal;
+        case DictTypeString:   return parseView<int64_t>(stringVal, [](const char *s){ return strtoull(s, nullptr, 10); });
+        default:               return 0;
+    }
+}
+
+double DictionaryEntryView::getDouble() const
+{
+    switch (type) {
+        case DictTypeInt:
+        case DictTypeInt64:
+        case DictTypeIdentity: return (double)intVal;
+        case DictTypeDouble:   return doubleVal;
+        case DictTypeString:   return parseView<double>(stringVal, [](const char *s){ return strtod(s, nullptr); });
+        default:               return 0.0;
+    }
+}
+
+bool DictionaryEntryView::appendString(std::string &str) const
+{
+    switch (type) {
+        case DictTypeString:   str.append(stringVal);                    return true;
+        case DictTypeInt:      str.append(std::to_string((int)intVal));  return true;
+        case DictTypeInt64:
+        case DictTypeIdentity: str.append(std::to_string(intVal));       return true;
+        case DictTypeDouble:   str.append(std::to_string(doubleVal));    return true;
+        default:               return false;
+    }
+}
+
 Dictionary::Dictionary()
 {
 }
@@ -541,6 +541,39 @@ DictionaryEntryCRef MutableDictionaryC::makeEntryRef(const Value &val) const
     }
 }
 
+bool MutableDictionaryC::getEntryView(const std::string &name,DictionaryEntryView &view) const
+{
+    const auto it = stringMap.find(name);
+    return (it != stringMap.end()) && getEntryView(it->second,view);
+}
+
+bool MutableDictionaryC::getEntryView(unsigned int key,DictionaryEntryView &view) const
+{
+    const auto it = valueMap.find(key);
+    if (it == valueMap.end())
+    {
+        view = DictionaryEntryView();
+        return false;
+    }
+
+    const auto &val = it->second;
+    view.type = val.type;
+    switch (val.type) {
+        case DictTypeInt:      view.intVal = intVals[val.entry];     break;
+        case DictTypeIdentity:
+        case DictTypeInt64:    view.intVal = int64Vals[val.entry];   break;
+        case DictTypeDouble:   view.doubleVal = dVals[val.entry];    break;
+        case DictTypeString:   view.stringVal = stringVals[val.entry]; break;
+        // Just the type for these
+        case DictTypeDictionary:
+        case DictTypeArray:
+        case DictTypeObject:
+        case DictTypeNone:
+            break;
+    }
+    return true;
+}
+
 std::vector<DictionaryEntryRef> MutableDictionaryC::getArray(const std::string &name) const
 {
     const auto it = stringMap.find(name);
@@ -554,7 +587,7 @@ std::vector<DictionaryEntryRef> MutableDictionaryC::getArray(unsigned int key) c
         return std::vector<DictionaryEntryRef>();
     }
 
-    const auto arrayVal = arrayVals[it->second.entry];
+    const auto &arrayVal = arrayVals[it->second.entry];
 
     std::vector<DictionaryEntryRef> rets;
     rets.reserve(arrayVal.size());
@@ -0,0 +1,176 @@
+/*
+ *  DrawableSpatialIndex.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "DrawableSpatialIndex.h"
+#import "BasicDrawable.h"
+
+namespace WhirlyKit
+{
+
+// Closed interval test, so points and lines on an edge count
+static inline bool Overlaps(const Mbr &a,const Mbr &b)
+{
+    return a.ll().x() <= b.ur().x() && b.ll().x() <= a.ur().x() &&
+           a.ll().y() <= b.ur().y() && b.ll().y() <= a.ur().y();
+}
+
+DrawableSpatialIndex::DrawableSpatialIndex(const Mbr &bounds) :
+    root(nullptr,bounds),
+    rootValid(bounds.valid() && !bounds.empty())
+{
+}
+
+DrawableSpatialIndex::~DrawableSpatialIndex()
+{
+}
+
+bool DrawableSpatialIndex::getCullMbr(const Drawable *draw,Mbr &mbr)
+{
+    // Anything with its own transform, instances, geometry that moves in the
+    //  shader, or geometry already in clip space may be drawn somewhere other
+    //  than its local MBR says
+    if (draw->getMatrix())
+        return false;
+    const auto basicDraw = dynamic_cast<const BasicDrawable *>(draw);
+    if (!basicDraw || basicDraw->hasMotion() || basicDraw->getClipCoords())
+        return false;
+
+    mbr = basicDraw->getLocalMbr();
+    return mbr.valid();
+}
+
+void DrawableSpatialIndex::addDrawable(Drawable *draw)
+{
+    const SimpleIdentity drawID = draw->getId();
+    removeDrawable(drawID);
+
+    Mbr mbr;
+    if (!rootValid || !getCullMbr(draw,mbr))
+    {
+        locations[drawID] = Location { nullptr, unbounded.size() };
+        unbounded.push_back(Entry { draw, mbr });
+        return;
+    }
+
+    // Walk down as long as the drawable fits in a child cell.
+    // Anything centered outside the bounds (wrapped data, mostly) stays at the top.
+    const Point2f span = mbr.span();
+    const Point2f center = mbr.mid();
+    Node *node = &root;
+    for (int depth = 0; depth < MaxDepth; depth++)
+    {
+        const Point2f childSpan = node->cell.span() / 2.0;
+        if (span.x() > childSpan.x() || span.y() > childSpan.y() ||
+            !node->cell.insideOrOnEdge(center))
+        {
+            break;
+        }
+
+        const Point2f mid = node->cell.mid();
+        const int which = (center.x() < mid.x() ? 0 : 1) + (center.y() < mid.y() ? 0 : 2);
+        auto &child = node->children[which];
+        if (!child)
+        {
+            const Point2f ll((which & 1) ? mid.x() : node->cell.ll().x(),
+                             (which & 2) ? mid.y() : node->cell.ll().y());
+            child = std::make_unique<Node>(node,Mbr(ll,ll + childSpan));
+        }
+        node = child.get();
+    }
+
+    locations[drawID] = Location { node, node->entries.size() };
+    node->entries.push_back(Entry { draw, mbr });
+    for (Node *n = node; n; n = n->parent)
+    {
+        n->count++;
+    }
+}
+
+void DrawableSpatialIndex::removeDrawable(SimpleIdentity drawID)
+{
+    const auto it = locations.find(drawID);
+    if (it == locations.end())
+        return;
+    const Location loc = it->second;
+    locations.erase(it);
+
+    // Swap the last one into the hole
+    auto &entries = loc.node ? loc.node->entries : unbounded;
+    if (loc.index + 1 < entries.size())
+    {
+        entries[loc.index] = entries.back();
+        locations[entries[loc.index].draw->getId()].index = loc.index;
+    }
+    entries.pop_back();
+
+    for (Node *n = loc.node; n; n = n->parent)
+    {
+        n->count--;
+    }
+}
+
+void DrawableSpatialIndex::clear()
+{
+    root.entries.clear();
+    for (auto &child : root.children)
+    {
+        child.reset();
+    }
+    root.count = 0;
+    unbounded.clear();
+    locations.clear();
+}
+
+void DrawableSpatialIndex::findDrawables(const Mbr &localMbr,std::vector<Drawable *> &draws) const
+{
+    draws.reserve(draws.size() + unbounded.size());
+    for (const auto &entry : unbounded)
+    {
+        draws.push_back(entry.draw);
+    }
+
+    findDrawables(&root,localMbr,draws);
+}
+
+void DrawableSpatialIndex::findDrawables(const Node *node,const Mbr &localMbr,std::vector<Drawable *> &draws) const
+{
+    for (const auto &entry : node->entries)
+    {
+        if (Overlaps(entry.mbr,localMbr))
+        {
+            draws.push_back(entry.draw);
+        }
+    }
+
+    for (const auto &child : node->children)
+    {
+        if (!child || child->count == 0)
+            continue;
+
+        // Children only hold drawables centered in them and no bigger than they are,
+        //  so those can hang over by half a cell at most
+        const Point2f pad = child->cell.span() / 2.0;
+        const Mbr loose(child->cell.ll() - pad,child->cell.ur() + pad);
+        if (Overlaps(loose,localMbr))
+        {
+            findDrawables(child.get(),localMbr,draws);
+        }
+    }
+}
+
+}
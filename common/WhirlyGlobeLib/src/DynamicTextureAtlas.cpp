@@ -16,6 +16,7 @@
  *  limitations under the License.
  */
 
+#import <climits>
 #import "DynamicTextureAtlas.h"
 #import "Scene.h"
 #import "SceneRenderer.h"
@@ -46,6 +47,15 @@ void DynamicTexture::setup(int inTexSize,int inCellSize,TextureType inType,bool
     layoutGrid = new bool[numCell * numCell];
     for (unsigned int ii=0;ii<numCell * numCell;ii++)
         layoutGrid[ii] = false;
+    usedCells = 0;
+
+    // All one big free rectangle to start with
+    Region all;
+    all.ex = numCell-1;  all.ey = numCell-1;
+    freeRects.clear();
+    if (numCell > 0)
+        freeRects.push_back(all);
+    freeRectsDirty = false;
 }
 
 DynamicTexture::~DynamicTexture()
@@ -73,11 +83,172 @@ void DynamicTexture::setRegion(const Region &region, bool enable)
     int sx = std::max(region.sx,0), sy = std::max(region.sy,0);
     int ex = std::min(region.ex,numCell-1), ey = std::min(region.ey,numCell-1);
     
+    if (ex < sx || ey < sy)
+        return;
+
     for (unsigned int ix=sx;ix<=ex;ix++)
         for (unsigned int iy=sy;iy<=ey;iy++)
         {
-            layoutGrid[iy*numCell+ix] = enable;
+            bool &cell = layoutGrid[iy*numCell+ix];
+            if (cell != enable)
+            {
+                usedCells += enable ? 1 : -1;
+                cell = enable;
+            }
+        }
+
+    if (enable)
+    {
+        // No point keeping the free list up to date if it's being rebuilt anyway
+        if (!freeRectsDirty)
+        {
+            Region used;
+            used.sx = sx;  used.sy = sy;  used.ex = ex;  used.ey = ey;
+            splitFreeRects(used);
+        }
+    } else {
+        // Freed space can join up with its neighbors in any number of ways,
+        //  so work it out from the grid the next time we need it
+        freeRectsDirty = true;
+    }
+}
+
+static inline bool RegionsOverlap(const DynamicTexture::Region &a,const DynamicTexture::Region &b)
+{
+    return a.sx <= b.ex && b.sx <= a.ex && a.sy <= b.ey && b.sy <= a.ey;
+}
+
+static inline bool RegionContains(const DynamicTexture::Region &outer,const DynamicTexture::Region &inner)
+{
+    return outer.sx <= inner.sx && inner.ex <= outer.ex && outer.sy <= inner.sy && inner.ey <= outer.ey;
+}
+
+void DynamicTexture::splitFreeRects(const Region &used)
+{
+    // Anything the region overlaps gets replaced by the (up to four) pieces around it
+    std::vector<Region> pieces;
+    size_t numKept = 0;
+    for (size_t ii=0;ii<freeRects.size();ii++)
+    {
+        const Region fr = freeRects[ii];
+        if (!RegionsOverlap(fr,used))
+        {
+            freeRects[numKept++] = fr;
+            continue;
+        }
+
+        Region piece = fr;
+        if (used.sx > fr.sx)
+        {
+            piece.ex = used.sx-1;
+            pieces.push_back(piece);
+            piece = fr;
+        }
+        if (used.ex < fr.ex)
+        {
+            piece.sx = used.ex+1;
+            pieces.push_back(piece);
+            piece = fr;
+        }
+        if (used.sy > fr.sy)
+        {
+            piece.ey = used.sy-1;
+            pieces.push_back(piece);
+            piece = fr;
+        }
+        if (used.ey < fr.ey)
+        {
+            piece.sy = used.ey+1;
+            pieces.push_back(piece);
+        }
+    }
+    freeRects.resize(numKept);
+
+    // The untouched rectangles were maximal already, so only the new pieces can be redundant
+    for (size_t ii=0;ii<pieces.size();ii++)
+    {
+        const Region &piece = pieces[ii];
+        bool contained = false;
+        for (size_t jj=0;jj<numKept && !contained;jj++)
+            contained = RegionContains(freeRects[jj],piece);
+        for (size_t jj=0;jj<pieces.size() && !contained;jj++)
+        {
+            // Of two identical pieces, keep the first
+            if (jj != ii && RegionContains(pieces[jj],piece) &&
+                (jj < ii || !RegionContains(piece,pieces[jj])))
+                contained = true;
         }
+        if (!contained)
+            freeRects.push_back(piece);
+    }
+}
+
+void DynamicTexture::rebuildFreeRects()
+{
+    freeRects.clear();
+    freeRectsDirty = false;
+    if (numCell <= 0)
+        return;
+
+    // Running count of used cells along each row, to check if a run of cells is all free
+    std::vector<int> usedBefore(numCell * (numCell+1));
+    for (int iy=0;iy<numCell;iy++)
+    {
+        int *row = &usedBefore[iy*(numCell+1)];
+        row[0] = 0;
+        for (int ix=0;ix<numCell;ix++)
+            row[ix+1] = row[ix] + (layoutGrid[iy*numCell+ix] ? 1 : 0);
+    }
+
+    // Go up the rows keeping the height of free cells in each column, then each
+    //  rectangle that fits under that histogram and can't grow sideways or down is maximal
+    std::vector<int> heights(numCell,0);
+    std::vector<std::pair<int,int>> stack;
+    for (int iy=0;iy<numCell;iy++)
+    {
+        for (int ix=0;ix<numCell;ix++)
+            heights[ix] = layoutGrid[iy*numCell+ix] ? 0 : heights[ix]+1;
+
+        const int *nextRow = (iy+1 < numCell) ? &usedBefore[(iy+1)*(numCell+1)] : nullptr;
+        stack.clear();
+        for (int ix=0;ix<=numCell;ix++)
+        {
+            const int height = (ix < numCell) ? heights[ix] : 0;
+            int start = ix;
+            while (!stack.empty() && stack.back().second > height)
+            {
+                start = stack.back().first;
+                const int topHeight = stack.back().second;
+                stack.pop_back();
+
+                // If the row above is free all the way across, it's not maximal
+                if (nextRow && nextRow[ix] - nextRow[start] == 0)
+                    continue;
+
+                Region fr;
+                fr.sx = start;  fr.ex = ix-1;
+                fr.sy = iy-topHeight+1;  fr.ey = iy;
+                freeRects.push_back(fr);
+            }
+            if (height > 0 && (stack.empty() || stack.back().second < height))
+                stack.emplace_back(start,height);
+        }
+    }
+}
+
+void DynamicTexture::applyReleasedRegions()
+{
+    // Don't sit on the lock, as the main thread uses it
+    std::vector<Region> toClear;
+    {
+        std::lock_guard<std::mutex> guardLock(regionLock);
+        toClear.swap(releasedRegions);
+    }
+
+    for (const auto &ii : toClear)
+    {
+        setRegion(ii, false);
+    }
 }
     
 void DynamicTexture::clearRegion(const Region &clearRegion,ChangeSet &changes,bool mainThreadMerge,unsigned char *emptyData)
@@ -98,47 +269,42 @@ void DynamicTexture::getReleasedRegions(std::vector<DynamicTexture::Region> &toC
 bool DynamicTexture::findRegion(int sizeX,int sizeY,Region &region)
 {
     // First thing we need to do is clear any outstanding regions
-    // Don't sit on the lock, as the main thread uses it
-    std::vector<Region> toClear;
-    {
-        std::lock_guard<std::mutex> guardLock(regionLock);
-        toClear = releasedRegions;
-        releasedRegions.clear();
-    }
+    applyReleasedRegions();
 
-    for (auto &ii : toClear)
+    if (sizeX <= 0 || sizeY <= 0 || sizeX > numCell || sizeY > numCell)
+        return false;
+
+    if (freeRectsDirty)
+        rebuildFreeRects();
+
+    // Pick the free rectangle that leaves the least on its shorter side
+    const Region *best = nullptr;
+    int bestShort = INT_MAX, bestLong = INT_MAX;
+    for (const auto &fr : freeRects)
     {
-        setRegion(ii, false);
-    }
-    
-    // Now look for a region that'll fit
-    // Look for a spot big enough
-    bool found = false;
-    int foundX=0,foundY=0;
-    for (int iy=0;iy<=numCell-sizeY && !found;iy++)
-        for (int ix=0;ix<=numCell-sizeX && !found;ix++)
+        const int leftX = fr.ex - fr.sx + 1 - sizeX;
+        const int leftY = fr.ey - fr.sy + 1 - sizeY;
+        if (leftX < 0 || leftY < 0)
+            continue;
+
+        const int shortSide = std::min(leftX,leftY);
+        const int longSide = std::max(leftX,leftY);
+        if (shortSide < bestShort || (shortSide == bestShort &&
+            (longSide < bestLong || (longSide == bestLong &&
+             (fr.sy < best->sy || (fr.sy == best->sy && fr.sx < best->sx))))))
         {
-            bool clear = true;
-            for (int testY=0;testY<sizeY && clear;testY++)
-                for (int testX=0;testX<sizeX && clear;testX++)
-                {
-                    if (layoutGrid[(testY+iy)*numCell+(testX+ix)])
-                        clear = false;
-                }
-            if (clear)
-            {
-                foundX = ix;
-                foundY = iy;
-                found = true;
-            }
+            best = &fr;
+            bestShort = shortSide;
+            bestLong = longSide;
         }
-    
-    if (!found)
+    }
+
+    if (!best)
         return false;
     
     // Found one, so fill it in
-    region.sx = foundX;  region.sy = foundY;
-    region.ex = foundX+sizeX-1;  region.ey = foundY+sizeY-1;
+    region.sx = best->sx;  region.sy = best->sy;
+    region.ex = best->sx+sizeX-1;  region.ey = best->sy+sizeY-1;
     
     return true;
 }
@@ -157,12 +323,20 @@ bool DynamicTexture::empty()
 void DynamicTexture::getUtilization(int &outNumCell,int &usedCell)
 {
     outNumCell = numCell*numCell;
-    usedCell = 0;
-    for (unsigned int ii=0;ii<numCell*numCell;ii++)
-    {
-        if (layoutGrid[ii])
-            usedCell++;
-    }
+    usedCell = usedCells;
+}
+
+void DynamicTexture::addStats(Stats &stats)
+{
+    applyReleasedRegions();
+    if (freeRectsDirty)
+        rebuildFreeRects();
+
+    stats.numCells += numCell*numCell;
+    stats.usedCells += usedCells;
+    stats.numFreeRects += (int)freeRects.size();
+    for (const auto &fr : freeRects)
+        stats.largestFree = std::max(stats.largestFree,(fr.ex-fr.sx+1)*(fr.ey-fr.sy+1));
 }
     
 void DynamicTextureClearRegion::execute(Scene *scene,SceneRenderer *renderer,View *view)
@@ -514,6 +688,12 @@ void DynamicTextureAtlas::getUsage(int &numRegions,int &dynamicTextures)
     dynamicTextures = textures.size();
 }
 
+void DynamicTextureAtlas::getStats(DynamicTexture::Stats &stats)
+{
+    for (auto *texVec : textures)
+        texVec->at(0)->addStats(stats);
+}
+
 void DynamicTextureAtlas::log()
 {
     int numCells=0,usedCells=0;
@@ -560,6 +740,13 @@ void DynamicTextureAtlas::log()
     wkLogLevel(Warn,"DynamicTextureAtlas: %ld textures, (%.2f MB)",textures.size(),textures.size() * texSize*texSize*texelSize/(float)(1024*1024));
     if (numCells > 0)
         wkLogLevel(Warn,"DynamicTextureAtlas: using %.2f%% of the cells",100 * usedCells / (float)numCells);
+
+    DynamicTexture::Stats stats;
+    getStats(stats);
+    const int freeCells = stats.numCells - stats.usedCells;
+    if (freeCells > 0)
+        wkLogLevel(Warn,"DynamicTextureAtlas: %d free rectangles, largest is %.2f%% of the free cells",
+                   stats.numFreeRects, 100 * stats.largestFree / (float)freeCells);
 }
 
 }
@@ -0,0 +1,842 @@
+/*
+ *  Earcut.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <algorithm>
+#import <cmath>
+#import <limits>
+#import <memory>
+#import "Earcut.h"
+
+namespace WhirlyKit
+{
+
+namespace
+{
+
+// The algorithm follows Mapbox's earcut (ISC license), working on a doubly linked
+//  list of vertices with a second list sorted by z-order for the hashed ear check.
+class Earcut
+{
+public:
+    bool run(const VectorRing *loops,size_t numLoops,VectorTriangles &tris);
+
+    static Earcut &get()
+    {
+        static thread_local Earcut earcut;
+        return earcut;
+    }
+
+protected:
+    struct Node
+    {
+        // Index of the vertex in the output
+        uint32_t i;
+        double x,y;
+        Node *prev,*next;
+        // z-order curve value and links
+        uint32_t z;
+        Node *prevZ,*nextZ;
+        // Holes that collapsed to a single point
+        bool steiner;
+    };
+
+    // Nodes come out of blocks that are kept between polygons
+    Node *newNode(uint32_t i,double x,double y);
+    void resetNodes();
+
+    Node *linkedList(uint32_t start,uint32_t end,bool clockwise);
+    Node *filterPoints(Node *start,Node *end = nullptr);
+    void earcutLinked(Node *ear,int pass);
+    bool isEar(Node *ear) const;
+    bool isEarHashed(Node *ear) const;
+    Node *cureLocalIntersections(Node *start);
+    void splitEarcut(Node *start);
+    Node *eliminateHoles(const std::vector<uint32_t> &holeStarts,Node *outerNode);
+    Node *eliminateHole(Node *hole,Node *outerNode);
+    Node *findHoleBridge(Node *hole,Node *outerNode) const;
+    void indexCurve(Node *start) const;
+    static Node *sortLinked(Node *list);
+    uint32_t zOrder(double x,double y) const;
+    static Node *getLeftmost(Node *start);
+    static bool pointInTriangle(double ax,double ay,double bx,double by,double cx,double cy,double px,double py);
+    static bool isValidDiagonal(Node *a,Node *b);
+    static double area(const Node *p,const Node *q,const Node *r);
+    static bool equals(const Node *p1,const Node *p2);
+    static bool intersects(const Node *p1,const Node *q1,const Node *p2,const Node *q2);
+    static bool onSegment(const Node *p,const Node *q,const Node *r);
+    static int sign(double val);
+    static bool intersectsPolygon(const Node *a,const Node *b);
+    static bool locallyInside(const Node *a,const Node *b);
+    static bool middleInside(const Node *a,const Node *b);
+    static bool sectorContainsSector(const Node *m,const Node *p);
+    Node *splitPolygon(Node *a,Node *b);
+    static void removeNode(Node *p);
+    double signedArea(uint32_t start,uint32_t end) const;
+
+    static constexpr size_t BlockSize = 256;
+    // Rings bigger than this get the z-order index
+    static constexpr size_t HashThreshold = 80;
+    // How far off the triangles' area can be before we give up on the result
+    static constexpr double MaxDeviation = 1e-6;
+
+    std::vector<std::unique_ptr<Node[]>> blocks;
+    size_t curBlock = 0, blockUsed = 0;
+
+    // Flattened vertices for the current polygon
+    std::vector<Point2d> verts;
+    std::vector<uint32_t> triIndices;
+    double minX = 0.0, minY = 0.0, invSize = 0.0;
+};
+
+Earcut::Node *Earcut::newNode(uint32_t i,double x,double y)
+{
+    if (blockUsed >= BlockSize)
+    {
+        curBlock++;
+        blockUsed = 0;
+    }
+    if (curBlock >= blocks.size())
+        blocks.emplace_back(new Node[BlockSize]);
+
+    Node *node = &blocks[curBlock][blockUsed++];
+    *node = Node { i, x, y, nullptr, nullptr, 0, nullptr, nullptr, false };
+    return node;
+}
+
+void Earcut::resetNodes()
+{
+    curBlock = 0;
+    blockUsed = 0;
+}
+
+bool Earcut::run(const VectorRing *loops,size_t numLoops,VectorTriangles &tris)
+{
+    resetNodes();
+    verts.clear();
+    triIndices.clear();
+    invSize = 0.0;
+
+    // Gather up the vertices, dropping the closing point if it's there
+    std::vector<uint32_t> holeStarts;
+    holeStarts.reserve(numLoops);
+    uint32_t outerEnd = 0;
+    for (size_t li = 0; li < numLoops; li++)
+    {
+        const VectorRing &ring = loops[li];
+        size_t numPts = ring.size();
+        if (numPts > 1 && ring[0] == ring[numPts-1])
+            numPts--;
+        if (li > 0)
+            holeStarts.push_back((uint32_t)verts.size());
+        for (size_t ii = 0; ii < numPts; ii++)
+            verts.emplace_back(ring[ii].x(), ring[ii].y());
+        if (li == 0)
+            outerEnd = (uint32_t)verts.size();
+    }
+    if (outerEnd < 3)
+        return false;
+
+    Node *outerNode = linkedList(0, outerEnd, true);
+    if (!outerNode || outerNode->next == outerNode->prev)
+        return false;
+
+    if (!holeStarts.empty())
+        outerNode = eliminateHoles(holeStarts, outerNode);
+
+    // Big enough to be worth hashing
+    if (verts.size() > HashThreshold)
+    {
+        minX = verts[0].x(), minY = verts[0].y();
+        double maxX = minX, maxY = minY;
+        for (uint32_t ii = 1; ii < outerEnd; ii++)
+        {
+            minX = std::min(minX, verts[ii].x());
+            minY = std::min(minY, verts[ii].y());
+            maxX = std::max(maxX, verts[ii].x());
+            maxY = std::max(maxY, verts[ii].y());
+        }
+        invSize = std::max(maxX - minX, maxY - minY);
+        invSize = invSize != 0.0 ? 32767.0 / invSize : 0.0;
+    }
+
+    earcutLinked(outerNode, 0);
+
+    // Make sure the triangles cover the polygon and nothing else.
+    // This is what catches self-intersections and bad holes.
+    double polyArea = std::abs(signedArea(0, outerEnd));
+    for (size_t hi = 0; hi < holeStarts.size(); hi++)
+    {
+        const uint32_t end = hi + 1 < holeStarts.size() ? holeStarts[hi+1] : (uint32_t)verts.size();
+        polyArea -= std::abs(signedArea(holeStarts[hi], end));
+    }
+    double triArea = 0.0;
+    for (size_t ii = 0; ii < triIndices.size(); ii += 3)
+    {
+        const Point2d &a = verts[triIndices[ii]], &b = verts[triIndices[ii+1]], &c = verts[triIndices[ii+2]];
+        triArea += std::abs((a.x() - c.x()) * (b.y() - a.y()) - (a.x() - b.x()) * (c.y() - a.y()));
+    }
+    if (!(polyArea > 0.0) || std::abs(triArea - polyArea) > MaxDeviation * polyArea)
+        return false;
+
+    // Wind them like the outer ring, which is what libtess does.
+    // We forced the outer ring clockwise (by earcut's reckoning), so its triangles come out one way.
+    const bool flip = signedArea(0, outerEnd) < 0.0;
+
+    const int startPoint = (int)tris.pts.size();
+    tris.pts.reserve(tris.pts.size() + verts.size());
+    for (const auto &pt : verts)
+        tris.pts.emplace_back((float)pt.x(), (float)pt.y(), 0.0f);
+    tris.tris.reserve(tris.tris.size() + triIndices.size() / 3);
+    for (size_t ii = 0; ii < triIndices.size(); ii += 3)
+    {
+        VectorTriangles::Triangle tri;
+        tri.pts[0] = (int)triIndices[ii] + startPoint;
+        tri.pts[1] = (int)triIndices[flip ? ii+2 : ii+1] + startPoint;
+        tri.pts[2] = (int)triIndices[flip ? ii+1 : ii+2] + startPoint;
+        tris.tris.push_back(tri);
+    }
+
+    return true;
+}
+
+// Create a circular list from the vertices in the given order
+Earcut::Node *Earcut::linkedList(uint32_t start,uint32_t end,bool clockwise)
+{
+    Node *last = nullptr;
+    const auto insert = [this,&last](uint32_t ii)
+    {
+        Node *p = newNode(ii, verts[ii].x(), verts[ii].y());
+        if (!last)
+        {
+            p->prev = p;
+            p->next = p;
+        }
+        else
+        {
+            p->next = last->next;
+            p->prev = last;
+            last->next->prev = p;
+            last->next = p;
+        }
+        last = p;
+    };
+
+    if (clockwise == (signedArea(start, end) > 0.0))
+    {
+        for (uint32_t ii = start; ii < end; ii++)
+            insert(ii);
+    }
+    else
+    {
+        for (uint32_t ii = end; ii > start; ii--)
+            insert(ii - 1);
+    }
+
+    if (last && equals(last, last->next))
+    {
+        removeNode(last);
+        last = last->next;
+    }
+
+    return last;
+}
+
+// Get rid of duplicate and collinear points
+Earcut::Node *Earcut::filterPoints(Node *start,Node *end)
+{
+    if (!start)
+        return start;
+    if (!end)
+        end = start;
+
+    Node *p = start;
+    bool again;
+    do
+    {
+        again = false;
+        if (!p->steiner && (equals(p, p->next) || area(p->prev, p, p->next) == 0.0))
+        {
+            removeNode(p);
+            p = end = p->prev;
+            if (p == p->next)
+                break;
+            again = true;
+        }
+        else
+        {
+            p = p->next;
+        }
+    }
+    while (again || p != end);
+
+    return end;
+}
+
+void Earcut::earcutLinked(Node *ear,int pass)
+{
+    if (!ear)
+        return;
+
+    if (pass == 0 && invSize != 0.0)
+        indexCurve(ear);
+
+    Node *stop = ear;
+    while (ear->prev != ear->next)
+    {
+        Node *prev = ear->prev;
+        Node *next = ear->next;
+
+        if (invSize != 0.0 ? isEarHashed(ear) : isEar(ear))
+        {
+            triIndices.push_back(prev->i);
+            triIndices.push_back(ear->i);
+            triIndices.push_back(next->i);
+
+            removeNode(ear);
+
+            // Skipping the next vertex leads to fewer sliver triangles
+            ear = next->next;
+            stop = next->next;
+            continue;
+        }
+
+        ear = next;
+
+        // Went all the way around without finding an ear
+        if (ear == stop)
+        {
+            if (pass == 0)
+            {
+                // Try again after cleaning up
+                earcutLinked(filterPoints(ear), 1);
+            }
+            else if (pass == 1)
+            {
+                // Then with small self-intersections fixed
+                ear = cureLocalIntersections(filterPoints(ear));
+                earcutLinked(ear, 2);
+            }
+            else if (pass == 2)
+            {
+                // As a last resort, split it in two
+                splitEarcut(ear);
+            }
+            break;
+        }
+    }
+}
+
+// Nothing else in the polygon can be inside the ear
+bool Earcut::isEar(Node *ear) const
+{
+    const Node *a = ear->prev, *b = ear, *c = ear->next;
+    if (area(a, b, c) >= 0.0)
+        return false;
+
+    const double minTX = std::min(a->x, std::min(b->x, c->x)), minTY = std::min(a->y, std::min(b->y, c->y));
+    const double maxTX = std::max(a->x, std::max(b->x, c->x)), maxTY = std::max(a->y, std::max(b->y, c->y));
+
+    for (const Node *p = c->next; p != a; p = p->next)
+    {
+        if (p->x >= minTX && p->x <= maxTX && p->y >= minTY && p->y <= maxTY &&
+            pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+            area(p->prev, p, p->next) >= 0.0)
+            return false;
+    }
+
+    return true;
+}
+
+// Same as isEar, but only looks at nodes within the triangle's range on the z-order curve
+bool Earcut::isEarHashed(Node *ear) const
+{
+    const Node *a = ear->prev, *b = ear, *c = ear->next;
+    if (area(a, b, c) >= 0.0)
+        return false;
+
+    const double minTX = std::min(a->x, std::min(b->x, c->x)), minTY = std::min(a->y, std::min(b->y, c->y));
+    const double maxTX = std::max(a->x, std::max(b->x, c->x)), maxTY = std::max(a->y, std::max(b->y, c->y));
+    const uint32_t minZ = zOrder(minTX, minTY);
+    const uint32_t maxZ = zOrder(maxTX, maxTY);
+
+    const auto blocks = [&](const Node *p)
+    {
+        return p != a && p != c &&
+            p->x >= minTX && p->x <= maxTX && p->y >= minTY && p->y <= maxTY &&
+            pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+            area(p->prev, p, p->next) >= 0.0;
+    };
+
+    // Look both ways along the curve at once, then finish off whichever is left
+    const Node *p = ear->prevZ;
+    const Node *n = ear->nextZ;
+    while (p && p->z >= minZ && n && n->z <= maxZ)
+    {
+        if (blocks(p))
+            return false;
+        p = p->prevZ;
+        if (blocks(n))
+            return false;
+        n = n->nextZ;
+    }
+    for (; p && p->z >= minZ; p = p->prevZ)
+    {
+        if (blocks(p))
+            return false;
+    }
+    for (; n && n->z <= maxZ; n = n->nextZ)
+    {
+        if (blocks(n))
+            return false;
+    }
+
+    return true;
+}
+
+// Clip off little self-intersections, where two edges a vertex apart cross
+Earcut::Node *Earcut::cureLocalIntersections(Node *start)
+{
+    Node *p = start;
+    do
+    {
+        Node *a = p->prev;
+        Node *b = p->next->next;
+
+        if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a))
+        {
+            triIndices.push_back(a->i);
+            triIndices.push_back(p->i);
+            triIndices.push_back(b->i);
+
+            removeNode(p);
+            removeNode(p->next);
+
+            p = start = b;
+        }
+        p = p->next;
+    }
+    while (p != start);
+
+    return filterPoints(p);
+}
+
+// Look for a valid diagonal to split the polygon and do the halves separately
+void Earcut::splitEarcut(Node *start)
+{
+    Node *a = start;
+    do
+    {
+        Node *b = a->next->next;
+        while (b != a->prev)
+        {
+            if (a->i != b->i && isValidDiagonal(a, b))
+            {
+                Node *c = splitPolygon(a, b);
+
+                a = filterPoints(a, a->next);
+                c = filterPoints(c, c->next);
+
+                earcutLinked(a, 0);
+                earcutLinked(c, 0);
+                return;
+            }
+            b = b->next;
+        }
+        a = a->next;
+    }
+    while (a != start);
+}
+
+// Link the holes into the outer ring, left to right
+Earcut::Node *Earcut::eliminateHoles(const std::vector<uint32_t> &holeStarts,Node *outerNode)
+{
+    std::vector<Node *> queue;
+    queue.reserve(holeStarts.size());
+    for (size_t hi = 0; hi < holeStarts.size(); hi++)
+    {
+        const uint32_t end = hi + 1 < holeStarts.size() ? holeStarts[hi+1] : (uint32_t)verts.size();
+        Node *list = linkedList(holeStarts[hi], end, false);
+        if (!list)
+            continue;
+        if (list == list->next)
+            list->steiner = true;
+        queue.push_back(getLeftmost(list));
+    }
+
+    std::sort(queue.begin(), queue.end(), [](const Node *a,const Node *b) { return a->x < b->x; });
+
+    for (Node *hole : queue)
+        outerNode = eliminateHole(hole, outerNode);
+
+    return outerNode;
+}
+
+Earcut::Node *Earcut::eliminateHole(Node *hole,Node *outerNode)
+{
+    Node *bridge = findHoleBridge(hole, outerNode);
+    if (!bridge)
+        return outerNode;
+
+    Node *bridgeReverse = splitPolygon(bridge, hole);
+
+    // Collinear points can show up around the bridge
+    filterPoints(bridgeReverse, bridgeReverse->next);
+    return filterPoints(bridge, bridge->next);
+}
+
+// David Eberly's algorithm for finding a vertex the hole can connect to
+Earcut::Node *Earcut::findHoleBridge(Node *hole,Node *outerNode) const
+{
+    Node *p = outerNode;
+    const double hx = hole->x;
+    const double hy = hole->y;
+    double qx = -std::numeric_limits<double>::infinity();
+    Node *m = nullptr;
+
+    // Find a segment intersected by a ray from the hole's leftmost point to the left.
+    // The segment's endpoint with the lesser x will be a potential connection point.
+    do
+    {
+        if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+        {
+            const double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+            if (x <= hx && x > qx)
+            {
+                qx = x;
+                m = p->x < p->next->x ? p : p->next;
+                if (x == hx)
+                    return m;
+            }
+        }
+        p = p->next;
+    }
+    while (p != outerNode);
+
+    if (!m)
+        return nullptr;
+
+    // Look for points inside the triangle of hole point, segment intersection and endpoint.
+    // If there are any, the one with the smallest angle to the ray is the connection point.
+    const Node *stop = m;
+    const double mx = m->x;
+    const double my = m->y;
+    double tanMin = std::numeric_limits<double>::infinity();
+
+    p = m;
+    do
+    {
+        if (hx >= p->x && p->x >= mx && hx != p->x &&
+            pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y))
+        {
+            const double tanCur = std::abs(hy - p->y) / (hx - p->x);
+            if (locallyInside(p, hole) &&
+                (tanCur < tanMin || (tanCur == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p))))))
+            {
+                m = p;
+                tanMin = tanCur;
+            }
+        }
+        p = p->next;
+    }
+    while (p != stop);
+
+    return m;
+}
+
+// Link the nodes in z-order
+void Earcut::indexCurve(Node *start) const
+{
+    Node *p = start;
+    do
+    {
+        if (p->z == 0)
+            p->z = zOrder(p->x, p->y);
+        p->prevZ = p->prev;
+        p->nextZ = p->next;
+        p = p->next;
+    }
+    while (p != start);
+
+    p->prevZ->nextZ = nullptr;
+    p->prevZ = nullptr;
+
+    sortLinked(p);
+}
+
+// Simon Tatham's linked list merge sort
+Earcut::Node *Earcut::sortLinked(Node *list)
+{
+    size_t inSize = 1;
+    size_t numMerges;
+    do
+    {
+        Node *p = list;
+        list = nullptr;
+        Node *tail = nullptr;
+        numMerges = 0;
+
+        while (p)
+        {
+            numMerges++;
+            Node *q = p;
+            size_t pSize = 0;
+            for (size_t ii = 0; ii < inSize; ii++)
+            {
+                pSize++;
+                q = q->nextZ;
+                if (!q)
+                    break;
+            }
+            size_t qSize = inSize;
+
+            while (pSize > 0 || (qSize > 0 && q))
+            {
+                Node *e;
+                if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z))
+                {
+                    e = p;
+                    p = p->nextZ;
+                    pSize--;
+                }
+                else
+                {
+                    e = q;
+                    q = q->nextZ;
+                    qSize--;
+                }
+
+                if (tail)
+                    tail->nextZ = e;
+                else
+                    list = e;
+                e->prevZ = tail;
+                tail = e;
+            }
+
+            p = q;
+        }
+
+        tail->nextZ = nullptr;
+        inSize *= 2;
+    }
+    while (numMerges > 1);
+
+    return list;
+}
+
+// Interleave the bits of the coordinates, scaled to 15 bits
+uint32_t Earcut::zOrder(double x,double y) const
+{
+    // Holes outside the outer ring can land off the end, which is harmless as long as it wraps
+    uint32_t zx = (uint32_t)(int32_t)((x - minX) * invSize);
+    uint32_t zy = (uint32_t)(int32_t)((y - minY) * invSize);
+
+    zx = (zx | (zx << 8)) & 0x00FF00FF;
+    zx = (zx | (zx << 4)) & 0x0F0F0F0F;
+    zx = (zx | (zx << 2)) & 0x33333333;
+    zx = (zx | (zx << 1)) & 0x55555555;
+
+    zy = (zy | (zy << 8)) & 0x00FF00FF;
+    zy = (zy | (zy << 4)) & 0x0F0F0F0F;
+    zy = (zy | (zy << 2)) & 0x33333333;
+    zy = (zy | (zy << 1)) & 0x55555555;
+
+    return zx | (zy << 1);
+}
+
+Earcut::Node *Earcut::getLeftmost(Node *start)
+{
+    Node *p = start;
+    Node *leftmost = start;
+    do
+    {
+        if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y))
+            leftmost = p;
+        p = p->next;
+    }
+    while (p != start);
+
+    return leftmost;
+}
+
+bool Earcut::pointInTriangle(double ax,double ay,double bx,double by,double cx,double cy,double px,double py)
+{
+    return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+           (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+           (bx - px) * (cy - py) >= (cx - px) * (by - py);
+}
+
+// The diagonal doesn't cross any edges and is inside the polygon
+bool Earcut::isValidDiagonal(Node *a,Node *b)
+{
+    return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon(a, b) &&
+           ((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b) &&
+             (area(a->prev, a, b->prev) != 0.0 || area(a, b->prev, b) != 0.0)) ||
+            (equals(a, b) && area(a->prev, a, a->next) > 0.0 && area(b->prev, b, b->next) > 0.0));
+}
+
+double Earcut::area(const Node *p,const Node *q,const Node *r)
+{
+    return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+}
+
+bool Earcut::equals(const Node *p1,const Node *p2)
+{
+    return p1->x == p2->x && p1->y == p2->y;
+}
+
+bool Earcut::intersects(const Node *p1,const Node *q1,const Node *p2,const Node *q2)
+{
+    const int o1 = sign(area(p1, q1, p2));
+    const int o2 = sign(area(p1, q1, q2));
+    const int o3 = sign(area(p2, q2, p1));
+    const int o4 = sign(area(p2, q2, q1));
+
+    if (o1 != o2 && o3 != o4)
+        return true;
+
+    // Collinear cases
+    if (o1 == 0 && onSegment(p1, p2, q1))
+        return true;
+    if (o2 == 0 && onSegment(p1, q2, q1))
+        return true;
+    if (o3 == 0 && onSegment(p2, p1, q2))
+        return true;
+    if (o4 == 0 && onSegment(p2, q1, q2))
+        return true;
+
+    return false;
+}
+
+// q lies on segment pr, given they're collinear
+bool Earcut::onSegment(const Node *p,const Node *q,const Node *r)
+{
+    return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) &&
+           q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+}
+
+int Earcut::sign(double val)
+{
+    return (val > 0.0) - (val < 0.0);
+}
+
+bool Earcut::intersectsPolygon(const Node *a,const Node *b)
+{
+    const Node *p = a;
+    do
+    {
+        if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+            intersects(p, p->next, a, b))
+            return true;
+        p = p->next;
+    }
+    while (p != a);
+
+    return false;
+}
+
+bool Earcut::locallyInside(const Node *a,const Node *b)
+{
+    return area(a->prev, a, a->next) < 0.0 ?
+        area(a, b, a->next) >= 0.0 && area(a, a->prev, b) >= 0.0 :
+        area(a, b, a->prev) < 0.0 || area(a, a->next, b) < 0.0;
+}
+
+// The middle of the diagonal is inside the polygon
+bool Earcut::middleInside(const Node *a,const Node *b)
+{
+    const Node *p = a;
+    bool inside = false;
+    const double px = (a->x + b->x) / 2.0;
+    const double py = (a->y + b->y) / 2.0;
+    do
+    {
+        if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+            (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x))
+            inside = !inside;
+        p = p->next;
+    }
+    while (p != a);
+
+    return inside;
+}
+
+bool Earcut::sectorContainsSector(const Node *m,const Node *p)
+{
+    return area(m->prev, m, p->prev) < 0.0 && area(p->next, m, m->next) < 0.0;
+}
+
+// Link a to b with a bridge, making two polygons if they're in the same
+//  ring or merging them if they're not.  Returns the copy of b.
+Earcut::Node *Earcut::splitPolygon(Node *a,Node *b)
+{
+    Node *a2 = newNode(a->i, a->x, a->y);
+    Node *b2 = newNode(b->i, b->x, b->y);
+    Node *an = a->next;
+    Node *bp = b->prev;
+
+    a->next = b;
+    b->prev = a;
+
+    a2->next = an;
+    an->prev = a2;
+
+    b2->next = a2;
+    a2->prev = b2;
+
+    bp->next = b2;
+    b2->prev = bp;
+
+    return b2;
+}
+
+void Earcut::removeNode(Node *p)
+{
+    p->next->prev = p->prev;
+    p->prev->next = p->next;
+
+    if (p->prevZ)
+        p->prevZ->nextZ = p->nextZ;
+    if (p->nextZ)
+        p->nextZ->prevZ = p->prevZ;
+}
+
+// Twice the area, positive for clockwise with y up
+double Earcut::signedArea(uint32_t start,uint32_t end) const
+{
+    double sum = 0.0;
+    for (uint32_t ii = start, jj = end - 1; ii < end; jj = ii++)
+        sum += (verts[jj].x() - verts[ii].x()) * (verts[ii].y() + verts[jj].y());
+    return sum;
+}
+
+}
+
+bool EarcutLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris)
+{
+    if (loops.empty())
+        return false;
+    return Earcut::get().run(loops.data(), loops.size(), *tris);
+}
+
+bool EarcutRing(const VectorRing &ring,VectorTrianglesRef tris)
+{
+    return Earcut::get().run(&ring, 1, *tris);
+}
+
+}
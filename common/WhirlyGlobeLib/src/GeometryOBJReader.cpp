@@ -19,7 +19,15 @@
  */
 
 #import <stdio.h>
+#import <fcntl.h>
+#import <unistd.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <climits>
 #import "GeometryOBJReader.h"
+#import "GeometryRawCache.h"
+#import "TaskScheduler.h"
+#import "WhirlyKitLog.h"
 
 namespace WhirlyKit
 {
@@ -167,218 +175,507 @@ bool GeometryModelOBJ::parseMaterials(FILE *fp)
     return success;
 }
 
-bool GeometryModelOBJ::parse(FILE *fp)
+namespace
+{
+// What a piece of an OBJ file turns into.  The vertex data is just appended
+//  when merging, but groups and materials depend on what came before.
+struct OBJChunk
 {
+    enum OpType { OpFace, OpGroup, OpUseMtl, OpMtlLib };
+    struct Op
+    {
+        OpType type;
+        // Index into faces or names
+        uint32_t which;
+    };
+    struct ChunkFace
+    {
+        uint32_t firstVert;
+        uint32_t numVerts;
+    };
+
+    Point3dVector verts;
+    Point2dVector texCoords;
+    Point3dVector norms;
+    std::vector<GeometryModelOBJ::Vertex> faceVerts;
+    std::vector<ChunkFace> faces;
+    std::vector<std::string> names;
+    // Everything that has to be applied in order
+    std::vector<Op> ops;
+    // If not, ops stop where the problem was
     bool success = true;
-    Group *activeGroup = NULL;
-    int activeMtl = -1;
-    
-    char line[2048],origLine[2048],tmpTok[2048];
-    int lineNo = 0;
-    
-    while (fgets(origLine, 2047, fp))
+};
+}
+
+// Pieces are at least this big, smaller files are parsed in one go
+static constexpr size_t OBJChunkSize = 1024*1024;
+
+static inline bool IsOBJSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline const char *SkipOBJSpace(const char *p,const char *end)
+{
+    while (p < end && IsOBJSpace(*p))
+        p++;
+    return p;
+}
+
+static inline const char *OBJTokenEnd(const char *p,const char *end)
+{
+    while (p < end && !IsOBJSpace(*p))
+        p++;
+    return p;
+}
+
+static inline bool OBJKeyIs(const char *key,size_t keyLen,const char *str)
+{
+    return keyLen == strlen(str) && !strncmp(key,str,keyLen);
+}
+
+// Powers of ten which are exact as doubles
+static const double OBJPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Parse a number out of a token, the way atof would.
+// The common case (up to 15 or so digits, small exponent) is done directly and
+//  comes out the same as strtod.  Anything else goes to strtod.
+static double ParseOBJDouble(const char *p,const char *end)
+{
+    const char *start = p;
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+'))
     {
-        lineNo++;
-        strcpy(line,origLine);
-        int lineLen = (int)strlen(line);
+        neg = (*p == '-');
+        p++;
+    }
 
-        // Empty line
-        if (lineLen == 0 || line[0] == '\n')
-            continue;
-        // Comment
-        if (line[0] == '#')
-            continue;
-        // Chop off a \r
-        if (line[lineLen-1]  == '\r')
+    uint64_t mant = 0;
+    int numDigits = 0, exp10 = 0;
+    bool anyDigits = false, slow = false;
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+    {
+        anyDigits = true;
+        if (numDigits < 19)
         {
-            line[lineLen-1] = 0;
-            lineLen--;
+            mant = mant * 10 + (*p - '0');
+            numDigits += (mant != 0);
         }
-        
-        std::vector<char *> toks;
-        // Parse the various tokens into an array
-        char *tok = NULL;
-        char *ptr = line;
-        char *next = NULL;
-        while ( (tok = strtok_r(ptr, " \t\n\r", &next)) )
+        else
         {
-            toks.push_back(tok);
-            ptr = next;
+            slow = true;
         }
-        
-        if (toks.empty())
-            continue;
-        
-        char *key = toks[0];
-        if (!strcmp(key,"mtllib"))
+    }
+    if (p < end && *p == '.')
+    {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++)
         {
-            if (toks.size() < 2)
+            anyDigits = true;
+            if (numDigits < 19)
             {
-                success = false;
-                break;
+                mant = mant * 10 + (*p - '0');
+                numDigits += (mant != 0);
+                exp10--;
             }
-
-            // The full name of the material file might contain spaces
-            strcpy(line,origLine);
-            strtok_r(line," \t\n\r", &next);
-            char *mtlFile = strtok_r(next,"\n\r", &next);
-            
-            if (!mtlFile)
+            else
             {
-                success = false;
-                break;
+                slow = true;
             }
-            
-            // Load the model
-            std::string fullPath = resourceDir.empty() ? mtlFile : resourceDir + "/" + mtlFile;
-            FILE *mtlFP = fopen(fullPath.c_str(),"r");
-            if (!mtlFP)
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        p++;
+        bool expNeg = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            expNeg = (*p == '-');
+            p++;
+        }
+        int expVal = 0;
+        bool expDigits = false;
+        for (; p < end && *p >= '0' && *p <= '9'; p++)
+        {
+            expDigits = true;
+            expVal = std::min(expVal * 10 + (*p - '0'), 10000);
+        }
+        slow |= !expDigits;
+        exp10 += expNeg ? -expVal : expVal;
+    }
+
+    if (anyDigits && !slow && mant <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22)
+    {
+        const double val = (exp10 < 0) ? (double)mant / OBJPow10[-exp10] : (double)mant * OBJPow10[exp10];
+        return neg ? -val : val;
+    }
+
+    // Odd looking numbers, nan, inf and so forth
+    char buf[64];
+    const size_t len = std::min((size_t)(end - start), sizeof(buf) - 1);
+    memcpy(buf, start, len);
+    buf[len] = 0;
+    return atof(buf);
+}
+
+// Parse an integer, returning where it stopped
+static const char *ParseOBJInt(const char *p,const char *end,int &val)
+{
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        neg = (*p == '-');
+        p++;
+    }
+    int64_t ret = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+    {
+        ret = std::min(ret * 10 + (*p - '0'), (int64_t)INT_MAX);
+    }
+    val = (int)(neg ? -ret : ret);
+    return p;
+}
+
+// Read a fixed number of values off the rest of a line
+template <typename T>
+static bool ParseOBJValues(const char *p,const char *eol,T &vals,int num)
+{
+    for (int ii=0;ii<num;ii++)
+    {
+        p = SkipOBJSpace(p, eol);
+        if (p >= eol)
+            return false;
+        const char *tokEnd = OBJTokenEnd(p, eol);
+        vals[ii] = ParseOBJDouble(p, tokEnd);
+        p = tokEnd;
+    }
+    return true;
+}
+
+// Parse the lines in [data,end) into a chunk
+static void ParseOBJChunk(const char *data,const char *end,OBJChunk &chunk)
+{
+    for (const char *line = data; line < end; )
+    {
+        const char *eol = (const char *)memchr(line, '\n', end - line);
+        if (!eol)
+            eol = end;
+        const char *p = SkipOBJSpace(line, eol);
+        line = eol + 1;
+
+        // Empty line or comment
+        if (p >= eol || *p == '#')
+            continue;
+
+        const char *key = p;
+        p = OBJTokenEnd(p, eol);
+        const size_t keyLen = p - key;
+
+        if (OBJKeyIs(key, keyLen, "v"))
+        {
+            // Regular vertex
+            Point3d vert;
+            if (!ParseOBJValues(p, eol, vert, 3))
             {
-                success = false;
+                chunk.success = false;
                 break;
             }
-            if (!parseMaterials(mtlFP))
+            chunk.verts.push_back(vert);
+        } else if (OBJKeyIs(key, keyLen, "vt"))
+        {
+            // Texture coordinate
+            Point2d texCoord;
+            if (!ParseOBJValues(p, eol, texCoord, 2))
             {
-                success = false;
+                chunk.success = false;
                 break;
             }
-            fclose(mtlFP);
-        } else if (!strcmp(key,"usemtl"))
+            chunk.texCoords.push_back(texCoord);
+        } else if (OBJKeyIs(key, keyLen, "vn"))
         {
-            // Use a pre-defined material
-            if (toks.size() < 1 || !activeGroup)
+            // Normal
+            Point3d norm;
+            if (!ParseOBJValues(p, eol, norm, 3))
             {
-                success = false;
+                chunk.success = false;
                 break;
             }
-            
-            // Look for the material
-            std::string mtlName = toks[1];
-            int whichMtl = -1;
-            for (unsigned int ii=0;ii<materials.size();ii++)
+            chunk.norms.push_back(norm);
+        } else if (OBJKeyIs(key, keyLen, "f"))
+        {
+            // Face.  We've either got numbers or collections of numbers separated by /
+            OBJChunk::ChunkFace face { (uint32_t)chunk.faceVerts.size(), 0 };
+            for (p = SkipOBJSpace(p, eol); p < eol; p = SkipOBJSpace(p, eol))
             {
-                if (mtlName == materials[ii].name)
+                const char *tokEnd = OBJTokenEnd(p, eol);
+                if (*p == '/')
                 {
-                    whichMtl = ii;
+                    chunk.success = false;
                     break;
                 }
-            }
 
-            // Note: Allowing materials we don't recognize
-            if (whichMtl < 0)
+                GeometryModelOBJ::Vertex vert;
+                const char *q = ParseOBJInt(p, tokEnd, vert.vert);
+                if (q < tokEnd && *q == '/')
+                {
+                    q++;
+                    if (q < tokEnd && *q == '/')
+                    {
+                        // Vertex and normal
+                        ParseOBJInt(q + 1, tokEnd, vert.norm);
+                    } else if (q < tokEnd) {
+                        q = ParseOBJInt(q, tokEnd, vert.texCoord);
+                        if (q < tokEnd && *q == '/' && q + 1 < tokEnd)
+                        {
+                            ParseOBJInt(q + 1, tokEnd, vert.norm);
+                        }
+                    }
+                }
+                chunk.faceVerts.push_back(vert);
+                face.numVerts++;
+                p = tokEnd;
+            }
+            if (!chunk.success)
+                break;
+            if (face.numVerts == 0)
             {
-                success = false;
+                chunk.success = false;
                 break;
             }
-            activeMtl = whichMtl;
-        } else if (!strcmp(key,"g"))
+            chunk.ops.push_back(OBJChunk::Op { OBJChunk::OpFace, (uint32_t)chunk.faces.size() });
+            chunk.faces.push_back(face);
+        } else if (OBJKeyIs(key, keyLen, "g"))
         {
-            groups.resize(groups.size()+1);
-            activeGroup = &groups.back();
-            
-            if (toks.size() > 1)
+            p = SkipOBJSpace(p, eol);
+            chunk.ops.push_back(OBJChunk::Op { OBJChunk::OpGroup, (uint32_t)chunk.names.size() });
+            chunk.names.emplace_back(p, OBJTokenEnd(p, eol));
+        } else if (OBJKeyIs(key, keyLen, "usemtl"))
+        {
+            // Use a pre-defined material
+            p = SkipOBJSpace(p, eol);
+            if (p >= eol)
             {
-                activeGroup->name = toks[1];
-            } else {
-                activeGroup->name = "";
+                chunk.success = false;
+                break;
             }
-        } else if (!strcmp(key,"f"))
+            chunk.ops.push_back(OBJChunk::Op { OBJChunk::OpUseMtl, (uint32_t)chunk.names.size() });
+            chunk.names.emplace_back(p, OBJTokenEnd(p, eol));
+        } else if (OBJKeyIs(key, keyLen, "mtllib"))
         {
-            // Face
-            if (toks.size() < 2 || !activeGroup)
+            // The full name of the material file might contain spaces
+            p = SkipOBJSpace(p, eol);
+            const char *nameEnd = eol;
+            while (nameEnd > p && IsOBJSpace(nameEnd[-1]))
+                nameEnd--;
+            if (p >= nameEnd)
             {
-                success = false;
+                chunk.success = false;
                 break;
             }
-            activeGroup->faces.resize(activeGroup->faces.size()+1);
-            Face &face = activeGroup->faces.back();
-            face.mtlID = activeMtl;
-            
-            // We've either got numbers of collections of numbers separated by /
-            for (unsigned int ii=1;ii<toks.size();ii++)
+            chunk.ops.push_back(OBJChunk::Op { OBJChunk::OpMtlLib, (uint32_t)chunk.names.size() });
+            chunk.names.emplace_back(p, nameEnd);
+        }
+    }
+}
+
+bool GeometryModelOBJ::parse(FILE *fp)
+{
+    // Read in whatever's left and parse it from memory
+    std::vector<char> data;
+    struct stat st;
+    if (fstat(fileno(fp), &st) == 0 && st.st_size > 0)
+    {
+        data.reserve((size_t)st.st_size);
+    }
+    char buf[64*1024];
+    size_t numRead;
+    while ((numRead = fread(buf, 1, sizeof(buf), fp)) > 0)
+    {
+        data.insert(data.end(), buf, buf + numRead);
+    }
+
+    return parse(data.data(), data.size());
+}
+
+bool GeometryModelOBJ::parseFile(const std::string &fileName)
+{
+    const int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    const size_t len = (size_t)st.st_size;
+    void *data = (len > 0) ? mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    // The mapping keeps its own reference
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        // Empty, or not something we can map, so read it instead
+        FILE *fp = fopen(fileName.c_str(), "r");
+        if (!fp)
+        {
+            return false;
+        }
+        const bool ret = parse(fp);
+        fclose(fp);
+        return ret;
+    }
+
+    // We're going to read all of it, so start paging it in
+    madvise(data, len, MADV_WILLNEED);
+    const bool ret = parse((const char *)data, len);
+    munmap(data, len);
+
+    return ret;
+}
+
+bool GeometryModelOBJ::parse(const char *data,size_t len)
+{
+    // Break it up at line boundaries
+    std::vector<const char *> bounds { data };
+    const char *end = data + len;
+    if (parallel && len >= 2 * OBJChunkSize)
+    {
+        for (const char *next = data + OBJChunkSize; next < end; next = bounds.back() + OBJChunkSize)
+        {
+            const char *eol = (const char *)memchr(next, '\n', end - next);
+            if (!eol || eol + 1 >= end)
+                break;
+            bounds.push_back(eol + 1);
+        }
+    }
+    bounds.push_back(end);
+
+    std::vector<OBJChunk> chunks(bounds.size() - 1);
+    if (chunks.size() == 1)
+    {
+        ParseOBJChunk(bounds[0], bounds[1], chunks[0]);
+    }
+    else
+    {
+        PlatformThreadInfo threadInfo;
+        TaskScheduler::getShared()->parallelFor(&threadInfo, chunks.size(), 1,
+            [&](PlatformThreadInfo *, size_t begin, size_t chunkEnd)
             {
-                strcpy(tmpTok, toks[ii]);
-                bool emptyTexCoord = false;
-                if (strstr(tmpTok,"//"))
-                    emptyTexCoord = true;
-                
-                std::vector<char *> vertToks;
-                char *vertTok = NULL;
-                char *vertPtr = tmpTok;
-                char *vertNext = NULL;
-                while ( (vertTok = strtok_r(vertPtr, "/", &vertNext)) )
-                {
-                    vertToks.push_back(vertTok);
-                    vertPtr = vertNext;
-                }
-                
-                face.verts.resize(face.verts.size()+1);
-                Vertex &vert = face.verts.back();
-                if (vertToks.size() == 0)
+                for (size_t ii = begin; ii < chunkEnd; ii++)
                 {
-                    success = false;
-                    break;
+                    ParseOBJChunk(bounds[ii], bounds[ii + 1], chunks[ii]);
                 }
-                if (vertToks.size() >= 1)
+            });
+    }
+
+    // Merge the pieces back together, in order
+    size_t numVerts = verts.size(), numTexCoords = texCoords.size(), numNorms = norms.size(), numFaceVerts = faceVerts.size();
+    for (const auto &chunk : chunks)
+    {
+        numVerts += chunk.verts.size();
+        numTexCoords += chunk.texCoords.size();
+        numNorms += chunk.norms.size();
+        numFaceVerts += chunk.faceVerts.size();
+    }
+    verts.reserve(numVerts);
+    texCoords.reserve(numTexCoords);
+    norms.reserve(numNorms);
+    faceVerts.reserve(numFaceVerts);
+
+    bool success = true;
+    Group *activeGroup = NULL;
+    int activeMtl = -1;
+    for (const auto &chunk : chunks)
+    {
+        const int baseFaceVert = (int)faceVerts.size();
+        faceVerts.insert(faceVerts.end(), chunk.faceVerts.begin(), chunk.faceVerts.end());
+        verts.insert(verts.end(), chunk.verts.begin(), chunk.verts.end());
+        texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+        norms.insert(norms.end(), chunk.norms.begin(), chunk.norms.end());
+
+        for (const auto &op : chunk.ops)
+        {
+            switch (op.type)
+            {
+                case OBJChunk::OpFace:
                 {
-                    vert.vert = atoi(vertToks[0]);
+                    if (!activeGroup)
+                    {
+                        success = false;
+                        break;
+                    }
+                    const auto &chunkFace = chunk.faces[op.which];
+                    activeGroup->faces.resize(activeGroup->faces.size()+1);
+                    Face &face = activeGroup->faces.back();
+                    face.mtlID = activeMtl;
+                    face.firstVert = baseFaceVert + (int)chunkFace.firstVert;
+                    face.numVerts = (int)chunkFace.numVerts;
                 }
-                if (emptyTexCoord)
+                    break;
+                case OBJChunk::OpGroup:
+                    groups.resize(groups.size()+1);
+                    activeGroup = &groups.back();
+                    activeGroup->name = chunk.names[op.which];
+                    break;
+                case OBJChunk::OpUseMtl:
                 {
-                    if (vertToks.size() >= 2)
-                        vert.norm = atoi(vertToks[1]);
-                } else {
-                    if (vertToks.size() >= 2)
+                    if (!activeGroup)
+                    {
+                        success = false;
+                        break;
+                    }
+
+                    // Look for the material
+                    const std::string &mtlName = chunk.names[op.which];
+                    int whichMtl = -1;
+                    for (unsigned int ii=0;ii<materials.size();ii++)
                     {
-                        vert.texCoord = atoi(vertToks[1]);
+                        if (mtlName == materials[ii].name)
+                        {
+                            whichMtl = ii;
+                            break;
+                        }
                     }
-                    if (vertToks.size() >= 3)
+
+                    // Note: Allowing materials we don't recognize
+                    if (whichMtl < 0)
                     {
-                        vert.norm = atoi(vertToks[2]);
+                        success = false;
+                        break;
                     }
+                    activeMtl = whichMtl;
                 }
+                    break;
+                case OBJChunk::OpMtlLib:
+                {
+                    // Load the model
+                    const std::string &mtlFile = chunk.names[op.which];
+                    std::string fullPath = resourceDir.empty() ? mtlFile : resourceDir + "/" + mtlFile;
+                    FILE *mtlFP = fopen(fullPath.c_str(),"r");
+                    if (!mtlFP)
+                    {
+                        success = false;
+                        break;
+                    }
+                    success = parseMaterials(mtlFP);
+                    fclose(mtlFP);
+                    mtlFiles.push_back(fullPath);
+                }
+                    break;
             }
-        } else if (!strcmp(key,"v"))
-        {
-            // Regular vertex
-            if (toks.size() < 4)
-            {
-                success = false;
-                break;
-            }
-            
-            verts.resize(verts.size()+1);
-            Point3d &vert = verts.back();
-            vert.x() = atof(toks[1]);
-            vert.y() = atof(toks[2]);
-            vert.z() = atof(toks[3]);
-        } else if (!strcmp(key,"vn"))
-        {
-            // Normal
-            if (toks.size() < 4)
-            {
-                success = false;
+            if (!success)
                 break;
-            }
-            
-            norms.resize(norms.size()+1);
-            Point3d &norm = norms.back();
-            norm.x() = atof(toks[1]);
-            norm.y() = atof(toks[2]);
-            norm.z() = atof(toks[3]);
-        } else if (!strcmp(key,"vt"))
+        }
+
+        if (!success || !chunk.success)
         {
-            // Texture coordinate
-            if (toks.size() < 3)
-            {
-                success = false;
-                break;
-            }
-            
-            texCoords.resize(texCoords.size()+1);
-            Point2d &texCoord = texCoords.back();
-            texCoord.x() = atof(toks[1]);
-            texCoord.y() = atof(toks[2]);
+            success = false;
+            break;
         }
     }
     
@@ -397,23 +694,6 @@ bool GeometryModelOBJ::parse(FILE *fp)
     return success;
 }
 
-// Used to sort faces by material
-class FaceBin
-{
-public:
-    FaceBin(GeometryModelOBJ::Face *face) { faces.push_back(face); mtlID = face->mtlID; }
-
-    bool operator < (const FaceBin &that) const
-    {
-        return mtlID < that.mtlID;
-    }
-    
-    int mtlID;
-    
-    std::vector<GeometryModelOBJ::Face *> faces;
-};
-typedef std::set<FaceBin> FaceBinSet;
-    
 void GeometryModelOBJ::toRawGeometry(std::vector<std::string> &textures,std::vector<GeometryRaw> &rawGeom)
 {
     // Unique list of textures
@@ -448,105 +728,199 @@ void GeometryModelOBJ::toRawGeometry(std::vector<std::string> &textures,std::vec
     for (auto it: textureMapping)
         textures[it.second] = it.first;
     
-    // Sort the faces by material
-    FaceBinSet faceBins;
-    for (unsigned int ii=0;ii<groups.size();ii++)
+    // Sort the faces by material, keeping them in order within each.
+    // The ones without a material come first.
+    std::vector<size_t> binStarts(materials.size()+2,0);
+    for (const auto &group : groups)
     {
-        Group *group = &groups[ii];
-        for (unsigned int jj=0;jj<group->faces.size();jj++)
+        for (const auto &face : group.faces)
         {
-            Face *face = &group->faces[jj];
-            
-            FaceBin faceBin(face);
-            const auto &it = faceBins.find(faceBin);
-            if (it == faceBins.end())
-                faceBins.insert(faceBin);
-            else {
-                faceBin.faces.insert(faceBin.faces.end(),it->faces.begin(), it->faces.end());
-                faceBins.erase(it);
-                faceBins.insert(faceBin);
+            binStarts[face.mtlID+2]++;
+        }
+    }
+    for (unsigned int ii=1;ii<binStarts.size();ii++)
+        binStarts[ii] += binStarts[ii-1];
+    std::vector<const Face *> sortedFaces(binStarts.back());
+    {
+        std::vector<size_t> binPos(binStarts.begin(),binStarts.end()-1);
+        for (const auto &group : groups)
+        {
+            for (const auto &face : group.faces)
+            {
+                sortedFaces[binPos[face.mtlID+1]++] = &face;
             }
         }
     }
-        
+
+    // Faces that refer to vertices we don't have are skipped
+    const auto faceValid = [&](const Face *face)
+    {
+        if (face->numVerts < 3)
+            return false;
+        for (int kk=0;kk<face->numVerts;kk++)
+        {
+            const int vertId = faceVerts[face->firstVert+kk].vert-1;
+            if (vertId < 0 || vertId >= verts.size())
+                return false;
+        }
+        return true;
+    };
+
     // Convert the face bins to raw geometry
-    for (auto it: faceBins)
+    for (unsigned int bin=0;bin<binStarts.size()-1;bin++)
     {
+        const int mtlID = (int)bin - 1;
+        const Material *mtl = (mtlID > -1) ? &materials[mtlID] : nullptr;
+
+        // Work out how big it's going to be first
+        size_t numPts = 0, numTris = 0;
+        for (size_t jj=binStarts[bin];jj<binStarts[bin+1];jj++)
+        {
+            const Face *face = sortedFaces[jj];
+            if (faceValid(face))
+            {
+                numPts += face->numVerts;
+                numTris += face->numVerts - 2;
+            }
+        }
+        if (numPts == 0)
+            continue;
+
         rawGeom.resize(rawGeom.size()+1);
         GeometryRaw &geom = rawGeom.back();
         geom.type = WhirlyKitGeometryTriangles;
         
         // Figure out if there's a texture ID
-        if (it.mtlID > -1)
+        if (mtl && mtl->tex_diffuseID > -1)
+            geom.texIDs.push_back(mtl->tex_diffuseID);
+
+        RGBAColor diffuse(255,255,255,255);
+        if (mtl && mtl->Kd[0] != -1)
         {
-            Material &mtl = materials[it.mtlID];
-            if (mtl.tex_diffuseID > -1)
-                geom.texIDs.push_back(mtl.tex_diffuseID);
+            diffuse.r = mtl->Kd[0] * 255;
+            diffuse.g = mtl->Kd[1] * 255;
+            diffuse.b = mtl->Kd[2] * 255;
+            diffuse.a = mtl->trans * 255;
         }
-        
+        const bool hasTexCoords = mtl && (mtl->tex_ambientID >= 0 || mtl->tex_diffuseID >= 0);
+
+        geom.pts.reserve(numPts);
+        geom.norms.reserve(numPts);
+        if (hasTexCoords)
+            geom.texCoords.reserve(numPts);
+        geom.colors.reserve(numPts);
+        geom.triangles.reserve(numTris);
+
         // Work through the faces
-        for (unsigned int jj=0;jj<it.faces.size();jj++)
+        for (size_t jj=binStarts[bin];jj<binStarts[bin+1];jj++)
         {
-            const Face *face = it.faces[jj];
+            const Face *face = sortedFaces[jj];
+            if (!faceValid(face))
+                continue;
+
             int basePt = (int)geom.pts.size();
-            for (unsigned int kk=0;kk<face->verts.size();kk++)
+            for (int kk=0;kk<face->numVerts;kk++)
             {
-                const Vertex &vert = face->verts[kk];
-                // Note: Should be range checking these
-                int vertId = vert.vert-1;
-                if (vertId < 0 || vertId >= verts.size())
-                    break;
-                Point3d pt = verts[vertId];
-                                    
+                const Vertex &vert = faceVerts[face->firstVert+kk];
+                geom.pts.push_back(verts[vert.vert-1]);
+
                 Point3d norm(0,0,1);
                 int normId = vert.norm-1;
                 if (normId >= 0 && normId < norms.size())
                     norm = norms[normId];
-                TexCoord texCoord(0,0);
-                int texId = vert.texCoord-1;
-                if (texId >= 0 && texId < texCoords.size())
-                {
-                    const Point2d &pt2d = texCoords[texId];
-                    texCoord = TexCoord(pt2d.x(),1.0-pt2d.y());
-                }
-                RGBAColor diffuse(255,255,255,255);
-                if (face->mat && face->mat->Kd[0] != -1)
-                {
-                    diffuse.r = face->mat->Kd[0] * 255;
-                    diffuse.g = face->mat->Kd[1] * 255;
-                    diffuse.b = face->mat->Kd[2] * 255;
-                    diffuse.a = face->mat->trans * 255;
-                }
-                
-                geom.pts.push_back(pt);
                 geom.norms.push_back(norm);
-                if (face->mat && (face->mat->tex_ambientID >= 0 || face->mat->tex_diffuseID >= 0))
+
+                if (hasTexCoords)
+                {
+                    TexCoord texCoord(0,0);
+                    int texId = vert.texCoord-1;
+                    if (texId >= 0 && texId < texCoords.size())
+                    {
+                        const Point2d &pt2d = texCoords[texId];
+                        texCoord = TexCoord(pt2d.x(),1.0-pt2d.y());
+                    }
                     geom.texCoords.push_back(texCoord);
+                }
                 geom.colors.push_back(diffuse);
             }
             
             // Assume these are convex for now
-            for (unsigned int kk = 2;kk<face->verts.size();kk++)
+            for (int kk = 2;kk<face->numVerts;kk++)
             {
-                geom.triangles.resize(geom.triangles.size()+1);
-                GeometryRaw::RawTriangle &tri = geom.triangles.back();
-                tri.verts[0] = basePt;
-                tri.verts[1] = basePt+kk-1;
-                tri.verts[2] = basePt+kk;
+                geom.triangles.emplace_back(basePt,basePt+kk-1,basePt+kk);
             }
-
-            // Force double-sided ness
-            // Assume these are convex for now
-//            for (unsigned int kk = 2;kk<face->verts.size();kk++)
-//            {
-//                geom.triangles.resize(geom.triangles.size()+1);
-//                GeometryRaw::RawTriangle &tri = geom.triangles.back();
-//                tri.verts[1] = basePt;
-//                tri.verts[0] = basePt+kk-1;
-//                tri.verts[2] = basePt+kk;
-//            }
         }
     }
 }
 
+bool GeometryModelOBJ::loadCached(const std::string &fileName,const std::string &cacheFile,
+                                  std::vector<std::string> &textures,std::vector<GeometryRaw> &rawGeom)
+{
+    if (!cacheFile.empty() && ReadGeometryCache(cacheFile, { fileName }, textures, rawGeom))
+        return true;
+
+    if (!parseFile(fileName))
+        return false;
+    toRawGeometry(textures, rawGeom);
+
+    // Material changes show up in the geometry too, so those count as sources
+    if (!cacheFile.empty())
+    {
+        std::vector<std::string> sourceFiles { fileName };
+        sourceFiles.insert(sourceFiles.end(), mtlFiles.begin(), mtlFiles.end());
+        WriteGeometryCache(cacheFile, sourceFiles, textures, rawGeom);
+    }
+
+    return true;
+}
+
+//#define OBJ_LOADER_BENCHMARK
+#if defined(OBJ_LOADER_BENCHMARK)
+// Load time for a generated model, per MB, so we can keep track of it
+static struct Benchmark {
+    Benchmark() {
+        // A grid of quads with texture coordinates and normals
+        constexpr int GridSize = 500;
+        std::string obj = "g benchmark\n";
+        char line[256];
+        for (int iy=0;iy<=GridSize;iy++)
+            for (int ix=0;ix<=GridSize;ix++)
+            {
+                snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn 0.0 0.0 1.0\n",
+                         ix * 0.125, iy * 0.125, sin(ix * 0.01) * cos(iy * 0.01),
+                         (double)ix / GridSize, (double)iy / GridSize);
+                obj += line;
+            }
+        for (int iy=0;iy<GridSize;iy++)
+            for (int ix=0;ix<GridSize;ix++)
+            {
+                const int v0 = iy * (GridSize + 1) + ix + 1, v1 = v0 + GridSize + 1;
+                snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n",
+                         v0, v0, v0, v0 + 1, v0 + 1, v0 + 1, v1 + 1, v1 + 1, v1 + 1, v1, v1, v1);
+                obj += line;
+            }
+        const double sizeMB = obj.size() / (1024.0 * 1024.0);
+
+        for (const bool parallel : { false, true })
+        {
+            GeometryModelOBJ model;
+            model.setParallel(parallel);
+            const TimeInterval startTime = TimeGetCurrent();
+            const bool success = model.parse(obj.data(), obj.size());
+            const TimeInterval parseTime = TimeGetCurrent();
+            std::vector<std::string> textures;
+            std::vector<GeometryRaw> rawGeom;
+            model.toRawGeometry(textures, rawGeom);
+            const TimeInterval convertTime = TimeGetCurrent();
+
+            wkLogLevel(Info, "OBJ loader (%s): %.1f MB, parse %.2f ms/MB, convert %.2f ms/MB%s",
+                       parallel ? "parallel" : "serial", sizeMB,
+                       1000.0 * (parseTime - startTime) / sizeMB,
+                       1000.0 * (convertTime - parseTime) / sizeMB,
+                       success ? "" : " (failed)");
+        }
+    }
+} benchmark;
+#endif
+
 }
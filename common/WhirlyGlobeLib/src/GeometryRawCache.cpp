@@ -0,0 +1,443 @@
+/*
+ *  GeometryRawCache.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import <stdio.h>
+#import <string.h>
+#import <algorithm>
+#import <fcntl.h>
+#import <unistd.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import "GeometryRawCache.h"
+#import "StringIndexer.h"
+#import "WhirlyKitLog.h"
+
+namespace WhirlyKit
+{
+
+namespace
+{
+// Bump this whenever the layout changes
+static constexpr uint32_t GeomCacheVersion = 1;
+static constexpr char GeomCacheMagic[8] = { 'W','K','G','E','O','M','\0','\0' };
+// Written in native order, so reading it back any other way means a different architecture
+static constexpr uint32_t GeomCacheByteOrder = 0x01020304;
+// Everything starts on one of these so the arrays are aligned in the mapping
+static constexpr size_t GeomCacheAlign = 8;
+
+// The arrays go out exactly as they sit in memory
+static_assert(sizeof(Point3d) == 3 * sizeof(double), "Unexpected Point3d layout");
+static_assert(sizeof(TexCoord) == 2 * sizeof(float), "Unexpected TexCoord layout");
+static_assert(sizeof(RGBAColor) == 4, "Unexpected RGBAColor layout");
+static_assert(sizeof(GeometryRaw::RawTriangle) == 3 * sizeof(int), "Unexpected triangle layout");
+
+struct GeomCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t idSize;
+    uint32_t numSources;
+    uint32_t numTextures;
+    uint32_t numGeom;
+    uint32_t numPoints;
+    uint32_t pad;
+};
+
+// What we know about a source file to tell if it's changed
+struct GeomCacheStamp
+{
+    int64_t size;
+    int64_t modTime;
+};
+
+static bool StampFile(const std::string &fileName,GeomCacheStamp &stamp)
+{
+    struct stat st;
+    if (stat(fileName.c_str(), &st) != 0)
+        return false;
+    stamp.size = (int64_t)st.st_size;
+    stamp.modTime = (int64_t)st.st_mtime;
+    return true;
+}
+
+// Accumulates the file contents
+class GeomCacheWriter
+{
+public:
+    void write(const void *data,size_t len)
+    {
+        const uint8_t *bytes = (const uint8_t *)data;
+        buf.insert(buf.end(), bytes, bytes + len);
+    }
+
+    template <typename T>
+    void writeVal(const T &val)
+    {
+        write(&val, sizeof(T));
+    }
+
+    void align()
+    {
+        buf.resize((buf.size() + GeomCacheAlign - 1) & ~(GeomCacheAlign - 1), 0);
+    }
+
+    void writeString(const std::string &str)
+    {
+        writeVal<uint64_t>(str.size());
+        write(str.data(), str.size());
+        align();
+    }
+
+    template <typename V>
+    void writeArray(const V &vec)
+    {
+        writeVal<uint64_t>(vec.size());
+        if (!vec.empty())
+            write(&vec[0], vec.size() * sizeof(vec[0]));
+        align();
+    }
+
+    std::vector<uint8_t> buf;
+};
+
+// Walks through the mapped file, checking that nothing runs off the end
+class GeomCacheReader
+{
+public:
+    GeomCacheReader(const uint8_t *data,size_t len) : pos(data), end(data + len) { }
+
+    bool read(void *data,size_t len)
+    {
+        if (len > (size_t)(end - pos))
+            return false;
+        memcpy(data, pos, len);
+        pos += len;
+        return true;
+    }
+
+    template <typename T>
+    bool readVal(T &val)
+    {
+        return read(&val, sizeof(T));
+    }
+
+    bool align()
+    {
+        const size_t skip = (GeomCacheAlign - ((uintptr_t)pos & (GeomCacheAlign - 1))) & (GeomCacheAlign - 1);
+        if (skip > (size_t)(end - pos))
+            return false;
+        pos += skip;
+        return true;
+    }
+
+    bool readString(std::string &str)
+    {
+        uint64_t len;
+        if (!readVal(len) || len > (uint64_t)(end - pos))
+            return false;
+        str.assign((const char *)pos, len);
+        pos += len;
+        return align();
+    }
+
+    template <typename V>
+    bool readArray(V &vec)
+    {
+        uint64_t num;
+        if (!readVal(num) || num > (uint64_t)(end - pos) / sizeof(vec[0]))
+            return false;
+        vec.resize(num);
+        if (num > 0 && !read(&vec[0], num * sizeof(vec[0])))
+            return false;
+        return align();
+    }
+
+    // Read into one of the point attribute types
+    template <typename A>
+    bool readAttr(GeomPointAttrData *attr)
+    {
+        A *typedAttr = dynamic_cast<A *>(attr);
+        return typedAttr && readArray(typedAttr->vals);
+    }
+
+    const uint8_t *pos,*end;
+};
+}
+
+bool WriteGeometryCache(const std::string &cacheFile,
+                        const std::vector<std::string> &sourceFiles,
+                        const std::vector<std::string> &textures,
+                        const std::vector<GeometryRaw> &rawGeom,
+                        const std::vector<const GeometryRawPoints *> &rawPoints)
+{
+    GeomCacheWriter writer;
+
+    GeomCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GeomCacheMagic, sizeof(header.magic));
+    header.version = GeomCacheVersion;
+    header.byteOrder = GeomCacheByteOrder;
+    header.idSize = sizeof(SimpleIdentity);
+    header.numSources = (uint32_t)sourceFiles.size();
+    header.numTextures = (uint32_t)textures.size();
+    header.numGeom = (uint32_t)rawGeom.size();
+    header.numPoints = (uint32_t)rawPoints.size();
+    writer.writeVal(header);
+
+    for (const auto &sourceFile : sourceFiles)
+    {
+        GeomCacheStamp stamp;
+        if (!StampFile(sourceFile, stamp))
+            return false;
+        writer.writeString(sourceFile);
+        writer.writeVal(stamp);
+    }
+
+    for (const auto &tex : textures)
+        writer.writeString(tex);
+
+    for (const auto &geom : rawGeom)
+    {
+        writer.writeVal<int64_t>(geom.type);
+        writer.writeArray(geom.pts);
+        writer.writeArray(geom.norms);
+        writer.writeArray(geom.texCoords);
+        writer.writeArray(geom.colors);
+        writer.writeArray(geom.triangles);
+        writer.writeArray(geom.texIDs);
+    }
+
+    for (const auto *points : rawPoints)
+    {
+        if (!points)
+            return false;
+        writer.writeVal<uint64_t>(points->attrData.size());
+        for (const auto *attr : points->attrData)
+        {
+            writer.writeVal<int64_t>(attr->dataType);
+            // String IDs are only good for this run, so save the name
+            writer.writeString(StringIndexer::getString(attr->nameID));
+            switch (attr->dataType)
+            {
+                case GeomRawIntType:
+                    writer.writeArray(((const GeomPointAttrDataInt *)attr)->vals);
+                    break;
+                case GeomRawFloatType:
+                    writer.writeArray(((const GeomPointAttrDataFloat *)attr)->vals);
+                    break;
+                case GeomRawFloat2Type:
+                    writer.writeArray(((const GeomPointAttrDataPoint2f *)attr)->vals);
+                    break;
+                case GeomRawFloat3Type:
+                    writer.writeArray(((const GeomPointAttrDataPoint3f *)attr)->vals);
+                    break;
+                case GeomRawFloat4Type:
+                    writer.writeArray(((const GeomPointAttrDataPoint4f *)attr)->vals);
+                    break;
+                case GeomRawDouble2Type:
+                    writer.writeArray(((const GeomPointAttrDataPoint2d *)attr)->vals);
+                    break;
+                case GeomRawDouble3Type:
+                    writer.writeArray(((const GeomPointAttrDataPoint3d *)attr)->vals);
+                    break;
+                default:
+                    return false;
+            }
+        }
+    }
+
+    // Write it to the side and move it into place when it's all there
+    const std::string tmpFile = cacheFile + ".tmp" + std::to_string((long)getpid());
+    FILE *fp = fopen(tmpFile.c_str(), "wb");
+    if (!fp)
+    {
+        wkLogLevel(Warn, "Unable to write geometry cache %s", cacheFile.c_str());
+        return false;
+    }
+    bool success = fwrite(writer.buf.data(), 1, writer.buf.size(), fp) == writer.buf.size();
+    success &= (fclose(fp) == 0);
+    if (success)
+        success = (rename(tmpFile.c_str(), cacheFile.c_str()) == 0);
+    if (!success)
+    {
+        unlink(tmpFile.c_str());
+        wkLogLevel(Warn, "Unable to write geometry cache %s", cacheFile.c_str());
+    }
+
+    return success;
+}
+
+static bool ReadGeometryCacheData(GeomCacheReader &reader,
+                                  const std::vector<std::string> &sourceFiles,
+                                  std::vector<std::string> &textures,
+                                  std::vector<GeometryRaw> &rawGeom,
+                                  std::vector<std::unique_ptr<GeometryRawPoints>> *rawPoints)
+{
+    GeomCacheHeader header;
+    if (!reader.readVal(header) ||
+        memcmp(header.magic, GeomCacheMagic, sizeof(header.magic)) != 0 ||
+        header.version != GeomCacheVersion ||
+        header.byteOrder != GeomCacheByteOrder ||
+        header.idSize != sizeof(SimpleIdentity))
+        return false;
+    if (header.numPoints > 0 && !rawPoints)
+        return false;
+
+    // Anything changed since this was written and it's no good
+    std::vector<std::string> cachedNames(header.numSources);
+    for (auto &cachedName : cachedNames)
+    {
+        GeomCacheStamp cachedStamp,stamp;
+        if (!reader.readString(cachedName) || !reader.readVal(cachedStamp) ||
+            !StampFile(cachedName, stamp) ||
+            cachedStamp.size != stamp.size || cachedStamp.modTime != stamp.modTime)
+            return false;
+    }
+    // And it has to have been made from what the caller expects
+    for (const auto &sourceFile : sourceFiles)
+    {
+        if (std::find(cachedNames.begin(), cachedNames.end(), sourceFile) == cachedNames.end())
+            return false;
+    }
+
+    textures.resize(header.numTextures);
+    for (auto &tex : textures)
+    {
+        if (!reader.readString(tex))
+            return false;
+    }
+
+    rawGeom.resize(header.numGeom);
+    for (auto &geom : rawGeom)
+    {
+        int64_t type;
+        if (!reader.readVal(type) || type < WhirlyKitGeometryNone || type > WhirlyKitGeometryTriangles)
+            return false;
+        geom.type = (WhirlyKitGeometryRawType)type;
+        if (!reader.readArray(geom.pts) ||
+            !reader.readArray(geom.norms) ||
+            !reader.readArray(geom.texCoords) ||
+            !reader.readArray(geom.colors) ||
+            !reader.readArray(geom.triangles) ||
+            !reader.readArray(geom.texIDs))
+            return false;
+    }
+
+    if (rawPoints)
+    {
+        rawPoints->clear();
+        rawPoints->reserve(header.numPoints);
+    }
+    for (unsigned int ii=0;ii<header.numPoints;ii++)
+    {
+        auto points = std::make_unique<GeometryRawPoints>();
+        uint64_t numAttrs;
+        if (!reader.readVal(numAttrs))
+            return false;
+        for (uint64_t jj=0;jj<numAttrs;jj++)
+        {
+            int64_t dataType;
+            std::string name;
+            if (!reader.readVal(dataType) || dataType < 0 || dataType >= GeomRawTypeMax ||
+                !reader.readString(name))
+                return false;
+            const int which = points->addAttribute(StringIndexer::getStringID(name), (GeomRawDataType)dataType);
+            if (which < 0)
+                return false;
+            GeomPointAttrData *attr = points->attrData[which];
+
+            bool ok = false;
+            switch (dataType)
+            {
+                case GeomRawIntType:
+                    ok = reader.readAttr<GeomPointAttrDataInt>(attr);
+                    break;
+                case GeomRawFloatType:
+                    ok = reader.readAttr<GeomPointAttrDataFloat>(attr);
+                    break;
+                case GeomRawFloat2Type:
+                    ok = reader.readAttr<GeomPointAttrDataPoint2f>(attr);
+                    break;
+                case GeomRawFloat3Type:
+                    ok = reader.readAttr<GeomPointAttrDataPoint3f>(attr);
+                    break;
+                case GeomRawFloat4Type:
+                    ok = reader.readAttr<GeomPointAttrDataPoint4f>(attr);
+                    break;
+                case GeomRawDouble2Type:
+                    ok = reader.readAttr<GeomPointAttrDataPoint2d>(attr);
+                    break;
+                case GeomRawDouble3Type:
+                    ok = reader.readAttr<GeomPointAttrDataPoint3d>(attr);
+                    break;
+            }
+            if (!ok)
+                return false;
+        }
+        rawPoints->push_back(std::move(points));
+    }
+
+    return true;
+}
+
+bool ReadGeometryCache(const std::string &cacheFile,
+                       const std::vector<std::string> &sourceFiles,
+                       std::vector<std::string> &textures,
+                       std::vector<GeometryRaw> &rawGeom,
+                       std::vector<std::unique_ptr<GeometryRawPoints>> *rawPoints)
+{
+    const int fd = open(cacheFile.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(GeomCacheHeader))
+    {
+        close(fd);
+        return false;
+    }
+    const size_t len = (size_t)st.st_size;
+    void *data = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+    madvise(data, len, MADV_SEQUENTIAL);
+
+    // Fill in copies so a bad file doesn't leave the outputs half done
+    std::vector<std::string> newTextures;
+    std::vector<GeometryRaw> newGeom;
+    std::vector<std::unique_ptr<GeometryRawPoints>> newPoints;
+    GeomCacheReader reader((const uint8_t *)data, len);
+    const bool success = ReadGeometryCacheData(reader, sourceFiles, newTextures, newGeom, rawPoints ? &newPoints : nullptr);
+    munmap(data, len);
+
+    if (!success)
+    {
+        wkLogLevel(Info, "Ignoring out of date or damaged geometry cache %s", cacheFile.c_str());
+        return false;
+    }
+
+    textures.swap(newTextures);
+    rawGeom.swap(newGeom);
+    if (rawPoints)
+        rawPoints->swap(newPoints);
+
+    return true;
+}
+
+}
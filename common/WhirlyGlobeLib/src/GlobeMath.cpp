@@ -20,6 +20,7 @@
 #import "GlobeMath.h"
 #import "FlatMath.h"
 #import "proj_api.h"
+#import <algorithm>
 
 using namespace Eigen;
 using namespace WhirlyKit;
@@ -83,6 +84,43 @@ Point3d GeoCoordSystem::GeocentricToLocal(Point3d geocPt)
     return Point3d(x,y,z);
 }
 
+// Proj4 walks through the coordinates with a stride, so it can work on our points directly
+static_assert(sizeof(Point3d) == 3 * sizeof(double), "Point3d must be packed");
+
+void GeoCoordSystem::LocalToGeocentric(const Point3d *in,Point3d *out,size_t num)
+{
+    if (num == 0)
+        return;
+    InitProj4();
+
+    if (in != out)
+        std::copy(in, in + num, out);
+    pj_transform(pj_latlon, pj_geocentric, (long)num, 3, &out[0].x(), &out[0].y(), &out[0].z());
+}
+
+void GeoCoordSystem::GeocentricToLocal(const Point3d *in,Point3d *out,size_t num)
+{
+    if (num == 0)
+        return;
+    InitProj4();
+
+    if (in != out)
+        std::copy(in, in + num, out);
+    pj_transform(pj_geocentric, pj_latlon, (long)num, 3, &out[0].x(), &out[0].y(), &out[0].z());
+}
+
+void GeoCoordSystem::localToGeographicBatch(const Point3d *in,Point2d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = Point2d(in[ii].x(),in[ii].y());
+}
+
+void GeoCoordSystem::geographicToLocalBatch(const Point2d *in,Point3d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = Point3d(in[ii].x(),in[ii].y(),0.0);
+}
+
 Mbr GeoCoordSystem::GeographicMbrToLocal(GeoMbr geoMbr)
 {
     Mbr localMbr;
@@ -125,6 +163,25 @@ Point3d FakeGeocentricDisplayAdapter::LocalToDisplay(Point3d geoPt)
     return pt;
 }
 
+void FakeGeocentricDisplayAdapter::LocalToDisplay(const Point3d *in,Point3d *out,size_t num)
+{
+    // Same as the single version, but without the call overhead
+    for (size_t ii=0;ii<num;ii++)
+    {
+        const double lon = in[ii].x(), lat = in[ii].y(), height = in[ii].z();
+        const double z = sin(lat);
+        const double rad = sqrt(1.0-z*z);
+        const double heightScale = (height != 0.0) ? 1.0 + height / EarthRadius : 1.0;
+        out[ii] = Point3d(rad*cos(lon)*heightScale,rad*sin(lon)*heightScale,z*heightScale);
+    }
+}
+
+void FakeGeocentricDisplayAdapter::DisplayToLocal(const Point3d *in,Point3d *out,size_t num)
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = DisplayToLocal(in[ii]);
+}
+
 Point3f FakeGeocentricDisplayAdapter::DisplayToLocal(Point3f pt)
 {
     pt.normalize();
@@ -178,6 +235,20 @@ Point3d GeocentricDisplayAdapter::DisplayToLocal(Point3d pt)
     return GeoCoordSystem::GeocentricToLocal(geoCpt);
 }
 
+void GeocentricDisplayAdapter::LocalToDisplay(const Point3d *in,Point3d *out,size_t num)
+{
+    GeoCoordSystem::LocalToGeocentric(in,out,num);
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] /= EarthRadius;
+}
+
+void GeocentricDisplayAdapter::DisplayToLocal(const Point3d *in,Point3d *out,size_t num)
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = in[ii] * EarthRadius;
+    GeoCoordSystem::GeocentricToLocal(out,out,num);
+}
+
 float CheckPointAndNormFacing(const Point3f &dispLoc,const Point3f &norm,const Matrix4f &viewAndModelMat,const Matrix4f &viewModelNormalMat)
 {
     Vector4f pt = viewAndModelMat * Vector4f(dispLoc.x(),dispLoc.y(),dispLoc.z(),1.0);
@@ -48,7 +48,156 @@ OutCode ComputeOutCode(double x, double y, const Mbr &mbr)
     
     return code;
 }
-    
+
+// One Sutherland-Hodgman pass, keeping the side of the line (axis == val) given by keepAbove
+static void ClipRingToLine(const VectorRing &in,int axis,float val,bool keepAbove,VectorRing &out)
+{
+    out.clear();
+    if (in.empty())
+        return;
+
+    const auto inside = [axis,val,keepAbove](const Point2f &pt)
+        { return keepAbove ? pt[axis] >= val : pt[axis] <= val; };
+    const auto add = [&out](const Point2f &pt)
+        { if (out.empty() || out.back() != pt) out.push_back(pt); };
+
+    Point2f prev = in.back();
+    bool prevIn = inside(prev);
+    for (const Point2f &pt : in)
+    {
+        const bool ptIn = inside(pt);
+        if (ptIn != prevIn)
+        {
+            const double t = ((double)val - prev[axis]) / ((double)pt[axis] - prev[axis]);
+            Point2f cross;
+            cross[axis] = val;
+            cross[1-axis] = (float)(prev[1-axis] + t * ((double)pt[1-axis] - prev[1-axis]));
+            add(cross);
+        }
+        if (ptIn)
+            add(pt);
+        prev = pt;
+        prevIn = ptIn;
+    }
+    if (out.size() > 1 && out.front() == out.back())
+        out.pop_back();
+}
+
+// Clip a closed ring to the MBR without going through Clipper.
+// Sutherland-Hodgman is only right when the result is in one piece, which it will be
+//  if the ring crosses the edge of the MBR no more than twice.  Most tile boundary clips
+//  are like that.  Returns false, having added nothing, if Clipper needs to do it.
+static bool ClipRingToMbrFast(const VectorRing &ring,const Mbr &mbr,std::vector<VectorRing> &rets)
+{
+    size_t numPts = ring.size();
+    if (numPts > 1 && ring[0] == ring[numPts-1])
+        numPts--;
+    if (numPts < 3)
+        return true;
+
+    // Count the crossings, being conservative about edges that might cut a corner
+    OutCode allCodes = ~0, anyCodes = 0;
+    int numCross = 0;
+    OutCode prevCode = ComputeOutCode(ring[numPts-1].x(), ring[numPts-1].y(), mbr);
+    for (size_t ii = 0; ii < numPts; ii++)
+    {
+        const OutCode code = ComputeOutCode(ring[ii].x(), ring[ii].y(), mbr);
+        if ((code == INSIDE) != (prevCode == INSIDE))
+            numCross++;
+        else if (code != INSIDE && !(code & prevCode))
+            numCross += 2;
+        if (numCross > 2)
+            return false;
+        allCodes &= code;
+        anyCodes |= code;
+        prevCode = code;
+    }
+
+    // Entirely on one side of the MBR
+    if (allCodes != INSIDE)
+        return true;
+
+    // Clipper hands back outer loops counter-clockwise, so we'll do the same
+    VectorRing outRing;
+    if (anyCodes == INSIDE)
+    {
+        // Nothing to clip
+        outRing.assign(ring.begin(), ring.begin() + numPts);
+    }
+    else if (numCross == 0)
+    {
+        // The MBR is either inside the ring or not anywhere near it
+        if (!PointInPolygon(mbr.mid(), ring))
+            return true;
+        mbr.asPoints(outRing);
+    }
+    else
+    {
+        VectorRing tmpRing;
+        outRing.assign(ring.begin(), ring.begin() + numPts);
+        ClipRingToLine(outRing, 0, mbr.ll().x(), true, tmpRing);
+        ClipRingToLine(tmpRing, 0, mbr.ur().x(), false, outRing);
+        ClipRingToLine(outRing, 1, mbr.ll().y(), true, tmpRing);
+        ClipRingToLine(tmpRing, 1, mbr.ur().y(), false, outRing);
+    }
+
+    if (outRing.size() < 3)
+        return true;
+    const double area = CalcLoopArea(outRing);
+    if (area == 0.0)
+        return true;
+    if (area < 0.0)
+        std::reverse(outRing.begin(), outRing.end());
+
+    rets.push_back(std::move(outRing));
+    return true;
+}
+
+// Clip an outer ring and its holes, if the holes don't cross the MBR
+static bool ClipRingsToMbrFast(const std::vector<VectorRing> &rings,const Mbr &mbr,std::vector<VectorRing> &rets)
+{
+    if (rings.empty())
+        return true;
+
+    // Holes inside the MBR come through untouched, anything else needs Clipper to join them up
+    std::vector<const VectorRing *> holes;
+    for (size_t ii = 1; ii < rings.size(); ii++)
+    {
+        const VectorRing &hole = rings[ii];
+        OutCode allCodes = ~0, anyCodes = 0;
+        for (const Point2f &pt : hole)
+        {
+            const OutCode code = ComputeOutCode(pt.x(), pt.y(), mbr);
+            allCodes &= code;
+            anyCodes |= code;
+        }
+        if (hole.size() < 3 || allCodes != INSIDE)
+            continue;
+        if (anyCodes != INSIDE || !PointInPolygon(hole[0], rings[0]))
+            return false;
+        holes.push_back(&hole);
+    }
+
+    const size_t startRet = rets.size();
+    if (!ClipRingToMbrFast(rings[0], mbr, rets))
+        return false;
+    if (rets.size() == startRet)
+        return true;
+
+    // Holes go clockwise
+    for (const VectorRing *hole : holes)
+    {
+        VectorRing outRing(*hole);
+        if (outRing.front() == outRing.back())
+            outRing.pop_back();
+        if (CalcLoopArea(outRing) > 0.0)
+            std::reverse(outRing.begin(), outRing.end());
+        rets.push_back(std::move(outRing));
+    }
+
+    return true;
+}
+
 // Clip the given loop to the given MBR
 bool ClipLoopToMbr(const VectorRing &ring,const Mbr &mbr, bool closed,std::vector<VectorRing> &rets,double polyScale)
 {
@@ -126,6 +275,11 @@ bool ClipLoopToMbr(const VectorRing &ring,const Mbr &mbr, bool closed,std::vecto
             rets.push_back(outRing);
     } else
     {
+        if (ClipRingToMbrFast(ring, mbr, rets))
+        {
+            return true;
+        }
+
         Path subject(ring.size());
         for (unsigned int ii=0;ii<ring.size();ii++)
         {
@@ -170,6 +324,11 @@ bool ClipLoopsToMbr(const std::vector<VectorRing> &rings,const Mbr &mbr, bool cl
     if (polyScale == 0.0)
         polyScale = PolyScale;
 
+    if (closed && ClipRingsToMbrFast(rings, mbr, rets))
+    {
+        return true;
+    }
+
     Clipper c;
     
     for (const auto &ring: rings)
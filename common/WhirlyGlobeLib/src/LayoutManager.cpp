@@ -325,6 +325,20 @@ void LayoutManager::setFadeOutTime(TimeInterval time)
     hasUpdates = true;
 }
 
+void LayoutManager::setRetainedMode(bool retained)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    retainedMode = retained;
+    hasUpdates = true;
+}
+
+void LayoutManager::setClusterIndexing(bool enable)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    clusterIndexing = enable;
+    hasUpdates = true;
+}
+
 // Return the screen space objects in a form the selection manager can understand
 void LayoutManager::getScreenSpaceObjects(const SelectionManager::PlacementInfo &pInfo,
                                           std::vector<ScreenSpaceObjectLocation> &screenSpaceObjs)
@@ -478,13 +492,20 @@ static const float ScreenBuffer = 0.1;
 bool LayoutManager::calcScreenPt(Point2f &objPt,const LayoutObject *layoutObj,
                                  const ViewStateRef &viewState,
                                  const Mbr &screenMbr,const Point2f &frameBufferSize)
+{
+    return calcScreenPt(objPt,layoutObj->worldLoc,viewState,screenMbr,frameBufferSize);
+}
+
+bool LayoutManager::calcScreenPt(Point2f &objPt,const Point3d &worldLoc,
+                                 const ViewStateRef &viewState,
+                                 const Mbr &screenMbr,const Point2f &frameBufferSize)
 {
     // Figure out where this will land
     bool isInside = false;
     for (unsigned int offi=0;offi<viewState->viewMatrices.size();offi++)
     {
         Eigen::Matrix4d modelTrans = viewState->fullMatrices[offi];
-        Point2f thisObjPt = viewState->pointOnScreenFromDisplay(layoutObj->worldLoc,&modelTrans,frameBufferSize);
+        Point2f thisObjPt = viewState->pointOnScreenFromDisplay(worldLoc,&modelTrans,frameBufferSize);
         if (screenMbr.inside(Point2f(thisObjPt.x(),thisObjPt.y())))
         {
             isInside = true;
@@ -641,6 +662,7 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
     // View related matrix stuff
     const Matrix4d modelTrans = viewState->fullMatrices[0];
     const Matrix4d fullMatrix = viewState->fullMatrices[0];
+    const bool indexClusters = clusterIndexing;
     const Matrix4d fullNormalMatrix = viewState->fullNormalMatrices[0];
     const Matrix4d normalMat = viewState->fullMatrices[0].inverse().transpose();
 
@@ -671,8 +693,9 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
                 }
             }
 
-            // Make sure this one isn't behind the globe
-            if (use && globeViewState)
+            // Make sure this one isn't behind the globe.
+            // Indexed clusters check that themselves, so the groups don't change as the globe turns.
+            if (use && globeViewState && !(indexClusters && obj->obj.clusterGroup > -1))
             {
                 // Layout shape following doesn't work with this check
                 if (obj->obj.layoutShape.empty())
@@ -778,7 +801,7 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
     if (clusterGen)
     {
         runLayoutClustering(threadInfo, layoutObjs, clusterGroups, clusterEntries,
-                            outClusterParams, viewState, mapViewState, globeViewState,
+                            outClusterParams, indexClusters, viewState, mapViewState, globeViewState,
                             frameBufferSize, screenMbr, modelTrans, normalMat);
     }
 
@@ -1007,11 +1030,264 @@ bool LayoutManager::runLayoutRules(PlatformThreadInfo *threadInfo,
     return hadChanges;
 }
 
+// Clustering is done in spherical mercator, scaled to a unit square
+static const double MaxClusterLat = 85.05112878 * M_PI / 180.0;
+
+static Point2d ClusterUnitsFromDisplay(CoordSystemDisplayAdapter *coordAdapter,const Point3d &dispPt)
+{
+    const Point3d localPt = coordAdapter->displayToLocal(dispPt);
+    const Point2d geoPt = coordAdapter->getCoordSystem()->localToGeographicD(localPt);
+    const double lat = std::min(std::max(geoPt.y(),-MaxClusterLat),MaxClusterLat);
+    return { geoPt.x() / (2.0 * M_PI) + 0.5, std::asinh(std::tan(lat)) / (2.0 * M_PI) + 0.5 };
+}
+
+static Point3d DisplayFromClusterUnits(CoordSystemDisplayAdapter *coordAdapter,const Point2d &pt)
+{
+    const Point2d geoPt((pt.x() - 0.5) * 2.0 * M_PI,std::atan(std::sinh((pt.y() - 0.5) * 2.0 * M_PI)));
+    return coordAdapter->localToDisplay(coordAdapter->getCoordSystem()->geographicToLocal(geoPt));
+}
+
+static bool DisplayFromScreen(const Point2f &screenPt,
+                              Maply::MapViewState *mapViewState,
+                              WhirlyGlobe::GlobeViewState *globeViewState,
+                              const Matrix4d &modelTrans,
+                              const Point2f &frameBufferSize,
+                              Point3d &dispPt)
+{
+    if (globeViewState)
+    {
+        return globeViewState->pointOnSphereFromScreen(screenPt,modelTrans,frameBufferSize,dispPt);
+    }
+    return mapViewState && mapViewState->pointOnPlaneFromScreen(screenPt,modelTrans,frameBufferSize,dispPt,false);
+}
+
+int LayoutManager::assignToCluster(const std::vector<LayoutObjectEntryRef> &objsForCluster,int clusterEntryID)
+{
+    // Figure out if all the objects in this new cluster come from the same old cluster
+    //  and assign the new cluster ID
+    int whichOldCluster = -1;
+    for (const auto &obj : objsForCluster)
+    {
+        if (obj->currentCluster > -1 && whichOldCluster != -2)
+        {
+            if (whichOldCluster == -1)
+            {
+                whichOldCluster = obj->currentCluster;
+            }
+            else if (whichOldCluster != obj->currentCluster)
+            {
+                whichOldCluster = -2;
+            }
+        }
+        obj->newCluster = clusterEntryID;
+    }
+
+    // If the children all agree about the old cluster, let's reflect that
+    return (whichOldCluster == -2) ? -1 : whichOldCluster;
+}
+
+bool LayoutManager::runIndexedClustering(PlatformThreadInfo *threadInfo,
+                                         const ClusteredObjects &clusterGroup,
+                                         const ClusterGenerator::ClusterClassParams &params,
+                                         LayoutContainerVec &layoutObjs,
+                                         std::vector<ClusterEntry> &clusterEntries,
+                                         int clusterParamID,
+                                         const ViewStateRef &viewState,
+                                         Maply::MapViewState *mapViewState,
+                                         WhirlyGlobe::GlobeViewState *globeViewState,
+                                         const Point2f &frameBufferSize,
+                                         const Mbr &screenMbr,
+                                         const Matrix4d &modelTrans)
+{
+    auto *coordAdapter = scene->getCoordAdapter();
+    const float resScale = renderer->getScale();
+
+    // Work out the scale in the middle of the screen.  If we can't, the caller will do it the old way.
+    const Point2f screenCenter = frameBufferSize / 2.0;
+    Point3d centerDisp;
+    if (!DisplayFromScreen(screenCenter,mapViewState,globeViewState,modelTrans,frameBufferSize,centerDisp))
+    {
+        return false;
+    }
+    const Point2d center = ClusterUnitsFromDisplay(coordAdapter,centerDisp);
+    const Point2f centerScreen = viewState->pointOnScreenFromDisplay(centerDisp,&modelTrans,frameBufferSize);
+
+    // Step east and see how far that moves on the screen.  The second time around
+    //  the step is a few pixels, whatever the scale, so it's both linear and precise.
+    double pixelsPerUnit = 0.0;
+    double step = 1e-3;
+    for (int ii=0;ii<2;ii++)
+    {
+        const Point3d stepDisp = DisplayFromClusterUnits(coordAdapter,Point2d(center.x() + step,center.y()));
+        const Point2f stepScreen = viewState->pointOnScreenFromDisplay(stepDisp,&modelTrans,frameBufferSize);
+        pixelsPerUnit = (stepScreen - centerScreen).norm() / step;
+        if (!std::isfinite(pixelsPerUnit) || pixelsPerUnit <= 0.0)
+        {
+            return false;
+        }
+        step = std::min(16.0 / pixelsPerUnit,1e-2);
+    }
+
+    // Rebuild the index if the objects in the group changed
+    ClusterIndexEntry &entry = clusterIndexes[clusterGroup.clusterID];
+    entry.inUse = true;
+    const auto &groupObjs = clusterGroup.getLayoutObjects();
+    if (entry.objs.size() != groupObjs.size() ||
+        !std::equal(groupObjs.begin(),groupObjs.end(),entry.objs.begin()))
+    {
+        entry.objs.assign(groupObjs.begin(),groupObjs.end());
+        entry.clusters.clear();
+        entry.cacheZoom = -1;
+
+        Point2dVector pts;
+        pts.reserve(entry.objs.size());
+        for (const auto &obj : entry.objs)
+        {
+            pts.push_back(ClusterUnitsFromDisplay(coordAdapter,obj->obj.worldLoc));
+        }
+        if (!entry.index.load(pts,&cancelLayout))
+        {
+            // Cancelled, so start over next time
+            entry.objs.clear();
+            return true;
+        }
+    }
+
+    const double mergeDist = std::max(params.clusterSize.x(),params.clusterSize.y()) * resScale;
+    const int zoom = entry.index.zoomForScale(pixelsPerUnit,mergeDist);
+    if (zoom != entry.cacheZoom)
+    {
+        entry.clusters.clear();
+        entry.cacheZoom = zoom;
+    }
+
+    // Objects around the back of the globe are in the index, so they're checked here
+    const Matrix4d &fullNormalMatrix = viewState->fullNormalMatrices[0];
+    const auto isFacing = [&](const Point3d &worldLoc)
+    {
+        return !globeViewState ||
+               CheckPointAndNormFacing(worldLoc,worldLoc.normalized(),modelTrans,fullNormalMatrix) > 0.0;
+    };
+
+    // Look at the area under the screen if we can work it out, otherwise everything.
+    // Wrapped maps show more than one copy of the world, so they get everything too.
+    Point2d ll(-1.0,-1.0),ur(2.0,2.0);
+    if (viewState->viewMatrices.size() == 1)
+    {
+        const Point2f &sll = screenMbr.ll(),&sur = screenMbr.ur();
+        const Point2f smid = screenMbr.mid();
+        const Point2f samples[8] = { sll, Point2f(smid.x(),sll.y()), Point2f(sur.x(),sll.y()), Point2f(sur.x(),smid.y()),
+                                     sur, Point2f(smid.x(),sur.y()), Point2f(sll.x(),sur.y()), Point2f(sll.x(),smid.y()) };
+        Point2d sampleLL(MAXFLOAT,MAXFLOAT),sampleUR(-MAXFLOAT,-MAXFLOAT);
+        bool allHit = true;
+        for (const auto &sample : samples)
+        {
+            Point3d dispPt;
+            if (!DisplayFromScreen(sample,mapViewState,globeViewState,modelTrans,frameBufferSize,dispPt))
+            {
+                allHit = false;
+                break;
+            }
+            const Point2d pt = ClusterUnitsFromDisplay(coordAdapter,dispPt);
+            sampleLL = sampleLL.cwiseMin(pt);
+            sampleUR = sampleUR.cwiseMax(pt);
+        }
+
+        if (allHit)
+        {
+            // On a globe the edges of the screen curve, and a pole can be in view without being on an edge
+            if (globeViewState)
+            {
+                const Point3d northPole(0,0,1),southPole(0,0,-1);
+                Point2f polePt;
+                if (isFacing(northPole) && calcScreenPt(polePt,northPole,viewState,screenMbr,frameBufferSize))
+                    sampleUR.y() = 1.0;
+                if (isFacing(southPole) && calcScreenPt(polePt,southPole,viewState,screenMbr,frameBufferSize))
+                    sampleLL.y() = 0.0;
+            }
+            const Point2d pad = (sampleUR - sampleLL) * 0.1 + Point2d::Constant(entry.index.getRadius(zoom));
+            ll = sampleLL - pad;
+            ur = sampleUR + pad;
+        }
+    }
+
+    std::vector<uint32_t> nodeIDs;
+    entry.index.getClusters(ll,ur,zoom,nodeIDs);
+
+    std::vector<uint32_t> leaves;
+    for (const uint32_t nodeID : nodeIDs)
+    {
+        if (UNLIKELY(cancelLayout))
+        {
+            break;
+        }
+
+        // Single objects go into the mix like everything else
+        const ClusterIndex::Node &node = entry.index.getNode(zoom,nodeID);
+        if (node.numPoints == 1)
+        {
+            const LayoutObjectEntryRef &objEntry = entry.objs[node.pointIndex];
+            Point2f objPt;
+            if (isFacing(objEntry->obj.worldLoc) &&
+                calcScreenPt(objPt,&objEntry->obj,viewState,screenMbr,frameBufferSize))
+            {
+                layoutObjs.emplace_back(objEntry);
+                objEntry->newEnable = true;
+                objEntry->newCluster = -1;
+            }
+            continue;
+        }
+
+        ClusterIndexEntry::Cluster &cluster = entry.clusters[nodeID];
+        if (cluster.objs.empty())
+        {
+            cluster.worldLoc = DisplayFromClusterUnits(coordAdapter,Point2d(node.x,node.y));
+            leaves.clear();
+            entry.index.getLeaves(zoom,nodeID,leaves);
+            cluster.objs.reserve(leaves.size());
+            for (const uint32_t which : leaves)
+            {
+                cluster.objs.push_back(entry.objs[which]);
+            }
+        }
+
+        Point2f clusterPt;
+        if (!isFacing(cluster.worldLoc) ||
+            !calcScreenPt(clusterPt,cluster.worldLoc,viewState,screenMbr,frameBufferSize))
+        {
+            continue;
+        }
+
+        const int clusterEntryID = (int)clusterEntries.size();
+        clusterEntries.emplace_back();
+        ClusterEntry &clusterEntry = clusterEntries.back();
+
+        // The generators make new images every pass, so this can't be kept
+        clusterEntry.layoutObj.worldLoc = cluster.worldLoc;
+        clusterGen->makeLayoutObject(threadInfo,clusterGroup.clusterID,cluster.objs,clusterEntry.layoutObj);
+        if (!params.selectable)
+        {
+            clusterEntry.layoutObj.selectPts.clear();
+        }
+
+        clusterEntry.objectIDs.reserve(cluster.objs.size());
+        for (const auto &thisObj : cluster.objs)
+        {
+            clusterEntry.objectIDs.push_back(thisObj->obj.getId());
+        }
+        clusterEntry.clusterParamID = clusterParamID;
+        clusterEntry.childOfCluster = assignToCluster(cluster.objs,clusterEntryID);
+    }
+
+    return true;
+}
+
 void LayoutManager::runLayoutClustering(PlatformThreadInfo *threadInfo,
                                         LayoutContainerVec &layoutObjs,
                                         ClusteredObjectsSet &clusterGroups,
                                         std::vector<ClusterEntry> &clusterEntries,
                                         std::vector<ClusterGenerator::ClusterClassParams> &outClusterParams,
+                                        bool indexClusters,
                                         const ViewStateRef &viewState,
                                         Maply::MapViewState *mapViewState,
                                         WhirlyGlobe::GlobeViewState *globeViewState,
@@ -1022,6 +1298,25 @@ void LayoutManager::runLayoutClustering(PlatformThreadInfo *threadInfo,
 {
     const float resScale = renderer->getScale();
 
+    // Cluster objects we've held on to are only good for the generator that made them
+    if (!indexClusters)
+    {
+        clusterIndexes.clear();
+    }
+    else if (clusterGen != indexClusterGen)
+    {
+        for (auto &it : clusterIndexes)
+        {
+            it.second.clusters.clear();
+            it.second.cacheZoom = -1;
+        }
+    }
+    indexClusterGen = clusterGen;
+
+    // Indexed groups include objects around the back of the globe
+    const bool checkFacing = indexClusters && globeViewState;
+    const Matrix4d &fullNormalMatrix = viewState->fullNormalMatrices[0];
+
     clusterGen->startLayoutObjects(threadInfo);
 
     // Lay out the cluster groups in order
@@ -1031,13 +1326,27 @@ void LayoutManager::runLayoutClustering(PlatformThreadInfo *threadInfo,
         ClusterGenerator::ClusterClassParams &params = outClusterParams.back();
         clusterGen->paramsForClusterClass(threadInfo,cluster->clusterID,params);
 
+        if (indexClusters &&
+            runIndexedClustering(threadInfo,*cluster,params,layoutObjs,clusterEntries,
+                                 (int)(outClusterParams.size() - 1),viewState,mapViewState,
+                                 globeViewState,frameBufferSize,screenMbr,modelTrans))
+        {
+            if (UNLIKELY(cancelLayout))
+            {
+                break;
+            }
+            continue;
+        }
+
         ClusterHelper clusterHelper(screenMbr,OverlapSampleX,OverlapSampleY,resScale,params.clusterSize);
 
         // Add all the various objects to the cluster and figure out overlaps
         for (const auto &entry : cluster->getLayoutObjects())
         {
             // Project the point and figure out the rotation
-            bool isActive = true;
+            bool isActive = !checkFacing ||
+                            CheckPointAndNormFacing(entry->obj.worldLoc,entry->obj.worldLoc.normalized(),
+                                                    modelTrans,fullNormalMatrix) > 0.0;
             Point2f objPt;
             bool isInside = calcScreenPt(objPt,&entry->obj,viewState,screenMbr,frameBufferSize);
 
@@ -1137,28 +1446,24 @@ void LayoutManager::runLayoutClustering(PlatformThreadInfo *threadInfo,
                     }
                 }
                 clusterEntry.clusterParamID = (int)(outClusterParams.size() - 1);
+                clusterEntry.childOfCluster = assignToCluster(objsForCluster,clusterEntryID);
+            }
+        }
+    }
 
-                // Figure out if all the objects in this new cluster come from the same old cluster
-                //  and assign the new cluster ID
-                int whichOldCluster = -1;
-                for (const auto &obj : objsForCluster)
-                {
-                    if (obj->currentCluster > -1 && whichOldCluster != -2)
-                    {
-                        if (whichOldCluster == -1)
-                        {
-                            whichOldCluster = obj->currentCluster;
-                        }
-                        else if (whichOldCluster != obj->currentCluster)
-                        {
-                            whichOldCluster = -2;
-                        }
-                    }
-                    obj->newCluster = clusterEntryID;
-                }
-
-                // If the children all agree about the old cluster, let's reflect that
-                clusterEntry.childOfCluster = (whichOldCluster == -2) ? -1 : whichOldCluster;
+    // Let go of the indices for groups that have gone away
+    if (!cancelLayout)
+    {
+        for (auto it = clusterIndexes.begin(); it != clusterIndexes.end(); )
+        {
+            if (it->second.inUse)
+            {
+                it->second.inUse = false;
+                ++it;
+            }
+            else
+            {
+                it = clusterIndexes.erase(it);
             }
         }
     }
@@ -1558,23 +1863,8 @@ void LayoutManager::buildDrawables(ScreenSpaceBuilder &ssBuild,
                 }
             }
 
-            // It's a single point placement
             SimpleIDUnorderedSet tempSet;
-            if (layoutObj->obj.layoutShape.empty())
-            {
-                ssBuild.addScreenObject(layoutObj->obj, layoutObj->obj.worldLoc,
-                                        &layoutObj->obj.geometry, nullptr, &tempSet);
-            }
-            else
-            {
-                // One or more placements along a path
-                for (unsigned int ii=0;ii<layoutObj->obj.layoutPlaces.size();ii++)
-                {
-                    ssBuild.addScreenObject(layoutObj->obj, layoutObj->obj.layoutModelPlaces[ii],
-                                            &layoutObj->obj.geometry, &layoutObj->obj.layoutPlaces[ii],
-                                            &tempSet);
-                }
-            }
+            addLayoutObject(ssBuild, layoutObj->obj, &tempSet);
             if (drawIDSet)
             {
                 drawIDSet->insert(tempSet.begin(), tempSet.end());
@@ -1641,6 +1931,347 @@ void LayoutManager::buildDrawables(ScreenSpaceBuilder &ssBuild,
     }
 }
 
+void LayoutManager::addLayoutObject(ScreenSpaceBuilder &ssBuild,const LayoutObject &obj,SimpleIDUnorderedSet *drawIDs)
+{
+    if (obj.layoutShape.empty())
+    {
+        // It's a single point placement
+        ssBuild.addScreenObject(obj, obj.worldLoc, &obj.geometry, nullptr, drawIDs);
+    }
+    else
+    {
+        // One or more placements along a path
+        for (unsigned int ii=0;ii<obj.layoutPlaces.size();ii++)
+        {
+            ssBuild.addScreenObject(obj, obj.layoutModelPlaces[ii], &obj.geometry, &obj.layoutPlaces[ii], drawIDs);
+        }
+    }
+}
+
+ScreenSpaceBuilder::DrawableState LayoutManager::retainedStateFor(const LayoutObject &obj)
+{
+    // The builder splits these up further by geometry, but this is what it starts from
+    ScreenSpaceBuilder::DrawableState state = obj.state;
+    state.enable = obj.enable;
+    state.startEnable = obj.startEnable;
+    state.endEnable = obj.endEnable;
+    return state;
+}
+
+void LayoutManager::addRetained(const LayoutObjectEntryRef &entry)
+{
+    const bool alongShape = !entry->obj.layoutShape.empty();
+    auto state = retainedStateFor(entry->obj);
+
+    // Fill up the existing groups for this state before starting a new one
+    auto &buckets = retainedBuckets[state];
+    RetainedBucketRef bucket;
+    for (const auto &b : buckets)
+    {
+        if (b->alongShape == alongShape && b->objs.size() < MaxRetainedBucketObjects)
+        {
+            bucket = b;
+            break;
+        }
+    }
+    if (!bucket)
+    {
+        bucket = std::make_shared<RetainedBucket>();
+        bucket->state = std::move(state);
+        bucket->alongShape = alongShape;
+        buckets.push_back(bucket);
+    }
+
+    bucket->objs.insert(entry);
+    if (!bucket->dirty)
+    {
+        bucket->dirty = true;
+        dirtyBuckets.push_back(bucket);
+    }
+    retainedObjs[entry->getId()] = RetainedObject { entry, std::move(bucket) };
+}
+
+void LayoutManager::removeRetained(std::unordered_map<SimpleIdentity,RetainedObject>::iterator it)
+{
+    const auto &bucket = it->second.bucket;
+    bucket->objs.erase(it->second.entry);
+    if (!bucket->dirty)
+    {
+        bucket->dirty = true;
+        dirtyBuckets.push_back(bucket);
+    }
+    retainedObjs.erase(it);
+}
+
+void LayoutManager::updateRetained(TimeInterval curTime,
+                                   TimeInterval &maxAnimTime,
+                                   const LayoutEntrySet &localLayoutObjects,
+                                   bool hadRemoves,
+                                   const std::vector<ClusterEntry> &oldClusters,
+                                   const std::vector<ClusterGenerator::ClusterClassParams> &oldClusterParams,
+                                   std::vector<BasicDrawableRef> &newDraws,
+                                   ChangeSet &changes)
+{
+    auto *coordAdapter = scene->getCoordAdapter();
+
+    // Unique IDs that started or stopped showing.  The counts are only updated
+    //  at the end so an object can hand off to another with the same ID.
+    std::vector<const std::string *> shownIDs, hiddenIDs;
+    LayoutEntrySet hiddenObjs;
+
+    // Objects the caller removed entirely
+    if (hadRemoves)
+    {
+        for (auto it = retainedObjs.begin(); it != retainedObjs.end(); )
+        {
+            const auto cur = it++;
+            const auto &entry = cur->second.entry;
+            if (localLayoutObjects.find(entry) == localLayoutObjects.end())
+            {
+                if (!entry->obj.uniqueID.empty())
+                {
+                    hiddenIDs.push_back(&entry->obj.uniqueID);
+                    hiddenObjs.insert(entry);
+                }
+                removeRetained(cur);
+            }
+        }
+    }
+
+    // Objects moving into or out of clusters are animated, which we rebuild every time
+    LayoutEntrySet transitionObjs;
+
+    for (const auto &layoutObj : localLayoutObjects)
+    {
+        auto it = retainedObjs.find(layoutObj->getId());
+        if (it != retainedObjs.end() && it->second.entry != layoutObj)
+        {
+            // It was replaced by a new object with the same ID, which may have a different unique ID.
+            // Treat the old one as hidden and the new one as something that just showed up.
+            const auto &oldEntry = it->second.entry;
+            if (!oldEntry->obj.uniqueID.empty())
+            {
+                hiddenIDs.push_back(&oldEntry->obj.uniqueID);
+                hiddenObjs.insert(oldEntry);
+            }
+            removeRetained(it);
+            it = retainedObjs.end();
+        }
+        const bool isRetained = (it != retainedObjs.end());
+        auto &obj = layoutObj->obj;
+
+        const bool intoCluster = layoutObj->currentEnable && !layoutObj->newEnable && layoutObj->newCluster >= 0;
+        const bool outOfCluster = !layoutObj->currentEnable && layoutObj->newEnable &&
+                                  layoutObj->currentCluster > -1 && layoutObj->newCluster == -1;
+        if (intoCluster || outOfCluster)
+        {
+            if (isRetained)
+            {
+                if (!obj.uniqueID.empty())
+                {
+                    hiddenIDs.push_back(&obj.uniqueID);
+                }
+                removeRetained(it);
+            }
+            // This updates the current state for us
+            transitionObjs.insert(layoutObj);
+            continue;
+        }
+
+        if (layoutObj->newEnable)
+        {
+            if (isRetained)
+            {
+                // Most of the time nothing about it changed
+                const auto &bucket = it->second.bucket;
+                if (!layoutObj->changed && !bucket->alongShape &&
+                    obj.offset == layoutObj->offset && obj.enable == bucket->state.enable)
+                {
+                    layoutObj->currentEnable = layoutObj->newEnable;
+                    layoutObj->currentCluster = layoutObj->newCluster;
+                    continue;
+                }
+                removeRetained(it);
+            }
+            else
+            {
+                if (!obj.uniqueID.empty())
+                {
+                    // Fade it in if it just showed up, unless it's taking over for another with the same ID
+                    if (fadeEnabled && !layoutObj->currentEnable && retainedUniqueIDs.count(obj.uniqueID) == 0)
+                    {
+                        obj.setFade(curTime+newObjectFadeIn, curTime);
+                        maxAnimTime = std::max(maxAnimTime, curTime+newObjectFadeIn);
+                    }
+                    shownIDs.push_back(&obj.uniqueID);
+                }
+            }
+
+            obj.offset = layoutObj->offset;
+            addRetained(layoutObj);
+        }
+        else if (isRetained)
+        {
+            if (!obj.uniqueID.empty())
+            {
+                hiddenIDs.push_back(&obj.uniqueID);
+                hiddenObjs.insert(layoutObj);
+            }
+            removeRetained(it);
+        }
+
+        layoutObj->currentEnable = layoutObj->newEnable;
+        layoutObj->currentCluster = layoutObj->newCluster;
+        layoutObj->changed = false;
+    }
+
+    for (const auto *uid : shownIDs)
+    {
+        retainedUniqueIDs[*uid]++;
+    }
+    for (const auto *uid : hiddenIDs)
+    {
+        const auto it = retainedUniqueIDs.find(*uid);
+        if (it != retainedUniqueIDs.end() && --it->second <= 0)
+        {
+            retainedUniqueIDs.erase(it);
+        }
+    }
+
+    // The rebuilt drawables go into a separate set of changes which is only handed
+    //  to the caller once we're done.  If we're cancelled part way through, the groups
+    //  are left dirty and the drawables from last time stay put until the next pass.
+    ChangeSet newChanges;
+    const auto discardChanges = [&newChanges]()
+    {
+        for (auto *change : newChanges)
+        {
+            delete change;
+        }
+        newChanges.clear();
+    };
+
+    // Clusters and the animations into and out of them
+    ScreenSpaceBuilder transBuild(renderer,coordAdapter,renderer->getScale());
+    buildDrawables(transBuild, /*doFades=*/false, /*doClusters=*/true, curTime, &maxAnimTime,
+                   transitionObjs, oldClusters, oldClusterParams, nullptr, nullptr);
+    if (cancelLayout)
+    {
+        return;
+    }
+    SimpleIDSet newTransientDrawIDs;
+    newDraws = transBuild.flushChanges(newChanges, newTransientDrawIDs);
+
+    // Rebuild just the groups which changed
+    std::vector<std::pair<RetainedBucketRef,SimpleIDSet>> rebuilt;
+    rebuilt.reserve(dirtyBuckets.size());
+    for (const auto &bucket : dirtyBuckets)
+    {
+        if (UNLIKELY(cancelLayout || !renderer))
+        {
+            discardChanges();
+            return;
+        }
+        if (!bucket->dirty)
+        {
+            continue;
+        }
+
+        SimpleIDSet bucketDrawIDs;
+        if (!bucket->objs.empty())
+        {
+            ScreenSpaceBuilder ssBuild(renderer,coordAdapter,renderer->getScale());
+            for (const auto &entry : bucket->objs)
+            {
+                addLayoutObject(ssBuild, entry->obj, nullptr);
+            }
+            auto draws = ssBuild.flushChanges(newChanges, bucketDrawIDs);
+            newDraws.insert(newDraws.end(), std::make_move_iterator(draws.begin()), std::make_move_iterator(draws.end()));
+        }
+        rebuilt.emplace_back(bucket, std::move(bucketDrawIDs));
+    }
+
+    // Done, swap out the old drawables for the new ones
+    for (const auto drawID : transientDrawIDs)
+    {
+        changes.push_back(new RemDrawableReq(drawID));
+    }
+    transientDrawIDs.swap(newTransientDrawIDs);
+
+    for (auto &rebuiltBucket : rebuilt)
+    {
+        const auto &bucket = rebuiltBucket.first;
+        for (const auto drawID : bucket->drawIDs)
+        {
+            changes.push_back(new RemDrawableReq(drawID));
+        }
+        bucket->drawIDs = std::move(rebuiltBucket.second);
+        bucket->dirty = false;
+
+        if (bucket->objs.empty())
+        {
+            const auto bit = retainedBuckets.find(bucket->state);
+            if (bit != retainedBuckets.end())
+            {
+                auto &buckets = bit->second;
+                buckets.erase(std::remove(buckets.begin(), buckets.end(), bucket), buckets.end());
+                if (buckets.empty())
+                {
+                    retainedBuckets.erase(bit);
+                }
+            }
+        }
+    }
+    dirtyBuckets.clear();
+
+    changes.insert(changes.end(), newChanges.begin(), newChanges.end());
+
+    // Fade out the ones which went away, unless something else took their place
+    if (fadeEnabled && oldObjectFadeOut > 0 && !hiddenObjs.empty())
+    {
+        ScreenSpaceBuilder fadeBuild(renderer,coordAdapter,renderer->getScale());
+        for (const auto &entry : hiddenObjs)
+        {
+            if (retainedUniqueIDs.count(entry->obj.uniqueID) == 0)
+            {
+                addLayoutObject(fadeBuild, entry->obj, nullptr);
+            }
+        }
+
+        const auto fade = curTime + oldObjectFadeOut;
+        for (const auto &draw : fadeBuild.flushChanges(changes))
+        {
+            const auto drawID = draw->getId();
+            changes.push_back(new FadeChangeRequest(drawID, curTime, fade));
+            changes.push_back(new RemDrawableReq(drawID, fade));
+        }
+        maxAnimTime = std::max(maxAnimTime, fade);
+    }
+}
+
+void LayoutManager::clearRetained(ChangeSet &changes)
+{
+    for (const auto &kv : retainedBuckets)
+    {
+        for (const auto &bucket : kv.second)
+        {
+            for (const auto drawID : bucket->drawIDs)
+            {
+                changes.push_back(new RemDrawableReq(drawID));
+            }
+        }
+    }
+    for (const auto drawID : transientDrawIDs)
+    {
+        changes.push_back(new RemDrawableReq(drawID));
+    }
+    retainedBuckets.clear();
+    retainedObjs.clear();
+    retainedUniqueIDs.clear();
+    dirtyBuckets.clear();
+    transientDrawIDs.clear();
+}
+
 void LayoutManager::handleFadeOut(const TimeInterval curTime,
                                   TimeInterval &maxAnimTime,
                                   const LayoutEntrySet &localLayoutObjects,
@@ -1855,7 +2486,8 @@ void LayoutManager::updateLayout(PlatformThreadInfo *threadInfo,const ViewStateR
         layoutChanges = true;
     }
 
-    if (!layoutChanges && !hadRemoves)
+    // Switching modes means rebuilding everything
+    if (!layoutChanges && !hadRemoves && retainedMode == builtRetained && dirtyBuckets.empty())
     {
         return;
     }
@@ -1866,46 +2498,81 @@ void LayoutManager::updateLayout(PlatformThreadInfo *threadInfo,const ViewStateR
     const TimeInterval curTime = scene->getCurrentTime();
     TimeInterval maxAnimTime = 0.0;
 
-    // Save the drawable mapping from the previous iteration
-    const auto oldUniqueDrawableMap = std::move(uniqueDrawableIDs);
-    uniqueDrawableIDs.clear();
-
-    // Generate the drawables.
-    // Note that the renderer is not managed by a shared pointer, and will be destroyed
-    // during shutdown, so we must stop using it quickly if controller shutdown is initiated.
-    ScreenSpaceBuilder ssBuild(renderer,coordAdapter,renderer->getScale());
+    std::vector<BasicDrawableRef> newDraws;
+    if (retainedMode)
+    {
+        if (!builtRetained)
+        {
+            // Get rid of everything from the last full build
+            for (const auto &drawID : drawIDs)
+            {
+                changes.push_back(new RemDrawableReq(drawID));
+            }
+            drawIDs.clear();
+            uniqueDrawableIDs.clear();
+            builtRetained = true;
+        }
 
-    //wkLog("Starting Layout t=%f", curTime);
+        updateRetained(curTime, maxAnimTime, localLayoutObjects, hadRemoves,
+                       oldClusters, oldClusterParams, newDraws, changes);
 
-    buildDrawables(ssBuild, fadeEnabled, /*doClusters=*/true, curTime, &maxAnimTime,
-                   localLayoutObjects, oldClusters, oldClusterParams,
-                   &uniqueDrawableIDs, &oldUniqueDrawableMap);
+        if (cancelLayout)
+        {
+            cancelLayout = false;
+            return;
+        }
 
-    if (cancelLayout)
-    {
-        cancelLayout = false;
-        return;
+        prevLayoutObjects.swap(localLayoutObjects);
     }
+    else
+    {
+        if (builtRetained)
+        {
+            clearRetained(changes);
+            builtRetained = false;
+        }
+
+        // Save the drawable mapping from the previous iteration
+        const auto oldUniqueDrawableMap = std::move(uniqueDrawableIDs);
+        uniqueDrawableIDs.clear();
+
+        // Generate the drawables.
+        // Note that the renderer is not managed by a shared pointer, and will be destroyed
+        // during shutdown, so we must stop using it quickly if controller shutdown is initiated.
+        ScreenSpaceBuilder ssBuild(renderer,coordAdapter,renderer->getScale());
+
+        //wkLog("Starting Layout t=%f", curTime);
 
-    // Add the new ones
-    SimpleIDSet newDrawIDs;
-    const auto newDraws = ssBuild.flushChanges(changes, newDrawIDs);
+        buildDrawables(ssBuild, fadeEnabled, /*doClusters=*/true, curTime, &maxAnimTime,
+                       localLayoutObjects, oldClusters, oldClusterParams,
+                       &uniqueDrawableIDs, &oldUniqueDrawableMap);
+
+        if (cancelLayout)
+        {
+            cancelLayout = false;
+            return;
+        }
+
+        // Add the new ones
+        SimpleIDSet newDrawIDs;
+        newDraws = ssBuild.flushChanges(changes, newDrawIDs);
 
 //        NSLog(@"Got %lu clusters",clusters.size());
 
-    // Get rid of the last set of drawables
-    for (const auto &drawID : drawIDs)
-    {
-        changes.push_back(new RemDrawableReq(drawID));
-    }
+        // Get rid of the last set of drawables
+        for (const auto &drawID : drawIDs)
+        {
+            changes.push_back(new RemDrawableReq(drawID));
+        }
 
-    handleFadeOut(curTime, maxAnimTime, localLayoutObjects, drawIDs, newDraws,
-                  oldClusters, oldClusterParams, oldUniqueDrawableMap, uniqueDrawableIDs, changes);
+        handleFadeOut(curTime, maxAnimTime, localLayoutObjects, drawIDs, newDraws,
+                      oldClusters, oldClusterParams, oldUniqueDrawableMap, uniqueDrawableIDs, changes);
 
-    drawIDs.clear();
-    drawIDs.swap(newDrawIDs);
+        drawIDs.clear();
+        drawIDs.swap(newDrawIDs);
 
-    prevLayoutObjects.swap(localLayoutObjects);
+        prevLayoutObjects.swap(localLayoutObjects);
+    }
 
     // That all may have taken a while, so update some the times for animation.
     // Also add a jiffy for finishing up here and actually processing the change
@@ -63,19 +63,24 @@ void LoadedTileNew::makeDrawables(SceneRenderer *sceneRender,TileGeomManager *ge
     const Point2d texOffset(0.0,0.0);   // Note: Not using this
     
     // Snap to the designated area
+    bool clipped = false;
     if (theMbr.ll().x() < geomManage->mbr.ll().x()) {
         theMbr.ll().x() = geomManage->mbr.ll().x();
+        clipped = true;
     }
     if (theMbr.ur().x() > geomManage->mbr.ur().x()) {
         texScale.x() = (geomManage->mbr.ur().x()-theMbr.ll().x())/(theMbr.ur().x()-theMbr.ll().x());
         theMbr.ur().x() = geomManage->mbr.ur().x();
+        clipped = true;
     }
     if (theMbr.ll().y() < geomManage->mbr.ll().y()) {
         theMbr.ll().y() = geomManage->mbr.ll().y();
+        clipped = true;
     }
     if (theMbr.ur().y() > geomManage->mbr.ur().y()) {
         texScale.y() = (geomManage->mbr.ur().y()-theMbr.ll().y())/(theMbr.ur().y()-theMbr.ll().y());
         theMbr.ur().y() = geomManage->mbr.ur().y();
+        clipped = true;
     }
 
     // Calculate a center for the tile
@@ -119,12 +124,16 @@ void LoadedTileNew::makeDrawables(SceneRenderer *sceneRender,TileGeomManager *ge
     // Texture increment for each tessellation
     const TexCoord texIncr(1.0/(float)sphereTessX * texScale.x(),1.0/(float)sphereTessY * texScale.y());
     
-    // We need the corners in geographic for the cullable
+    // Drawable bounds are in local coordinates, the same as everything else's
     const Point2d chunkLL(theMbr.ll().x(),theMbr.ll().y());
     const Point2d chunkUR(theMbr.ur().x(),theMbr.ur().y());
     //    Point2d chunkMid = (chunkLL+chunkUR)/2.0;
-    const GeoCoord geoLL(geomManage->coordSys->localToGeographic(Point3d(chunkLL.x(),chunkLL.y(),0.0)));
-    const GeoCoord geoUR(geomManage->coordSys->localToGeographic(Point3d(chunkUR.x(),chunkUR.y(),0.0)));
+    Mbr chunkMbr;
+    for (const Point2d &corner : { chunkLL, Point2d(chunkUR.x(),chunkLL.y()), chunkUR, Point2d(chunkLL.x(),chunkUR.y()) })
+    {
+        const Point3d scenePt = CoordSystemConvert3d(geomManage->coordSys.get(),sceneCoordSys,Point3d(corner.x(),corner.y(),0.0));
+        chunkMbr.addPoint(Point2d(scenePt.x(),scenePt.y()));
+    }
     
     BasicDrawableBuilderRef chunk = sceneRender->makeBasicDrawableBuilder("LoadedTileNew chunk");
     chunk->reserve((sphereTessX+1)*(sphereTessY+1),2*sphereTessX*sphereTessY);
@@ -146,7 +155,7 @@ void LoadedTileNew::makeDrawables(SceneRenderer *sceneRender,TileGeomManager *ge
     chunk->setDrawPriority(drawPriority);
     chunk->setVisibleRange(geomSettings.minVis, geomSettings.maxVis);
 //    chunk->setColor(geomSettings.color);
-    chunk->setLocalMbr(Mbr(Point2f(geoLL.x(),geoLL.y()),Point2f(geoUR.x(),geoUR.y())));
+    chunk->setLocalMbr(chunkMbr);
     chunk->setProgram(geomSettings.programID);
     chunk->setOnOff(false);
 
@@ -165,7 +174,7 @@ void LoadedTileNew::makeDrawables(SceneRenderer *sceneRender,TileGeomManager *ge
         poleChunk->setDrawPriority(drawPriority);
         poleChunk->setVisibleRange(geomSettings.minVis, geomSettings.maxVis);
 //        poleChunk->setColor(geomSettings.color);
-        poleChunk->setLocalMbr(Mbr(Point2f(geoLL.x(),geoLL.y()),Point2f(geoUR.x(),geoUR.y())));
+        // No bounds on this one, the pole caps reach past the tile
         poleChunk->setProgram(geomSettings.programID);
         poleChunk->setOnOff(false);
         drawInfo.push_back(DrawableInfo(DrawablePole,poleChunk->getDrawableID(),poleChunk->getDrawablePriority(),drawOrder));
@@ -206,7 +215,7 @@ void LoadedTileNew::makeDrawables(SceneRenderer *sceneRender,TileGeomManager *ge
     } else {
         chunk->setType(Triangles);
         // Generate point, texture coords, and normals
-        Point3dVector locs((sphereTessX+1)*(sphereTessY+1));
+        Point3dVector locs;
         std::vector<float> elevs;
         if (geomSettings.includeElev)
             elevs.resize((sphereTessX+1)*(sphereTessY+1));
@@ -215,23 +224,14 @@ void LoadedTileNew::makeDrawables(SceneRenderer *sceneRender,TileGeomManager *ge
         {
             for (unsigned int ix=0;ix<sphereTessX+1;ix++)
             {
-                float locZ = 0.0;
-                const auto cs = geomManage->coordSys.get();
-                auto loc3D = geomManage->coordAdapter->localToDisplay(CoordSystemConvert3d(cs,sceneCoordSys,Point3d(chunkLL.x()+ix*incr.x(),chunkLL.y()+iy*incr.y(),locZ)));
-                if (geomManage->coordAdapter->isFlat())
-                    loc3D.z() = locZ;
-                
-                // Use Z priority to sort the levels
-                //                    if (singleLevel != -1)
-                //                        loc3D.z() = (drawPriority + nodeInfo->ident.level * 0.01)/10000;
-                
-                locs[iy*(sphereTessX+1)+ix] = loc3D;
-                
                 // Do the texture coordinate separately
                 const TexCoord texCoord(ix*texIncr.x(),1.0-(iy*texIncr.y()));
                 texCoords[iy*(sphereTessX+1)+ix] = texCoord;
             }
         }
+
+        // Display coordinates for the grid, possibly borrowed from a neighbor
+        geomManage->buildTileGrid(ident,sphereTessX,sphereTessY,chunkLL,incr,!clipped,locs);
         
         // Without elevation data we can share the vertices
         for (unsigned int iy=0;iy<sphereTessY+1;iy++)
@@ -285,7 +285,7 @@ void LoadedTileNew::makeDrawables(SceneRenderer *sceneRender,TileGeomManager *ge
             skirtChunk->setDrawPriority(11);
             skirtChunk->setVisibleRange(geomSettings.minVis, geomSettings.maxVis);
 //            skirtChunk->setColor(geomSettings.color);
-            skirtChunk->setLocalMbr(Mbr(Point2f(geoLL.x(),geoLL.y()),Point2f(geoUR.x(),geoUR.y())));
+            skirtChunk->setLocalMbr(chunkMbr);
             skirtChunk->setType(Triangles);
             // We need the skirts rendered with the z buffer on, even if we're doing (mostly) pure sorting
             skirtChunk->setRequestZBuffer(true);
@@ -514,6 +514,107 @@ TileGeomManager::TileGeomManager() :
 {
 }
 
+Point3d TileGeomManager::localToDisplay(const Point3d &pt) const
+{
+    Point3d dispPt = coordAdapter->localToDisplay(CoordSystemConvert3d(coordSys.get(),coordAdapter->getCoordSystem(),pt));
+    if (coordAdapter->isFlat())
+        dispPt.z() = 0.0;
+    return dispPt;
+}
+
+void TileGeomManager::buildTileGrid(const QuadTreeNew::Node &ident,int tessX,int tessY,
+                                    const Point2d &chunkLL,const Point2d &incr,bool cacheable,
+                                    Point3dVector &locs)
+{
+    const int rowLen = tessX+1;
+    const size_t numLocs = (size_t)rowLen*(tessY+1);
+    const auto sample = [&](int ix,int iy) { return Point3d(chunkLL.x()+ix*incr.x(),chunkLL.y()+iy*incr.y(),0.0); };
+
+    // Tiles in a row on the globe are the same grid spun around the axis.
+    // We line up on the left end of the middle row and then check the corners, so
+    //  anything that doesn't actually move that way (or touches the poles) won't match.
+    // Flat maps are cheap enough to convert directly.
+    const int refX = 0, refY = tessY/2;
+    const TileGridKey key { ident.level, ident.y, tessX, tessY };
+    cacheable = cacheable && !coordAdapter->isFlat();
+    if (cacheable)
+    {
+        const auto it = gridCache.find(key);
+        if (it != gridCache.end() && it->second.size() == numLocs)
+        {
+            const Point3dVector &cached = it->second;
+            const Point3d refPt = localToDisplay(sample(refX,refY));
+            const Point3d &cacheRefPt = cached[refY*rowLen+refX];
+
+            const Point2d a = Point2d(cacheRefPt.x(),cacheRefPt.y()).normalized();
+            const Point2d b = Point2d(refPt.x(),refPt.y()).normalized();
+            const double cosA = a.dot(b);
+            const double sinA = a.x()*b.y() - a.y()*b.x();
+            const auto move = [&](const Point3d &pt)
+            {
+                return Point3d(cosA*pt.x()-sinA*pt.y(),sinA*pt.x()+cosA*pt.y(),pt.z());
+            };
+
+            bool fits = std::isfinite(cosA) && std::isfinite(sinA);
+            for (const auto &corner : { std::make_pair(0,0), std::make_pair(tessX,tessY) })
+            {
+                const Point3d exact = localToDisplay(sample(corner.first,corner.second));
+                const Point3d moved = move(cached[corner.second*rowLen+corner.first]);
+                if (!fits || !((exact-moved).norm() <= TileGridTolerance * (1.0 + exact.norm())))
+                {
+                    fits = false;
+                    break;
+                }
+            }
+
+            if (fits)
+            {
+                locs.resize(numLocs);
+                for (size_t ii=0;ii<numLocs;ii++)
+                    locs[ii] = move(cached[ii]);
+                return;
+            }
+        }
+    }
+
+    // Convert the whole grid to display coordinates at once
+    locs.resize(numLocs);
+    for (int iy=0;iy<=tessY;iy++)
+        for (int ix=0;ix<=tessX;ix++)
+            locs[iy*rowLen+ix] = sample(ix,iy);
+    const CoordSystem *sceneCoordSys = coordAdapter->getCoordSystem();
+    if (numLocs >= TileGridInterpMinPoints && !coordSys->isSameAs(sceneCoordSys))
+    {
+        // Reprojecting is the expensive part.  For a dense enough grid, convert a coarser
+        //  one and interpolate, as long as that stays well under a pixel.
+        // If it can't, the grid falls back to converting everything.
+        Point3d corners[2] = { sample(0,0), sample(tessX,tessY) };
+        CoordSystemConvert3d(coordSys.get(),sceneCoordSys,corners,corners,2);
+        const double maxError = (corners[1]-corners[0]).norm() * TileGridInterpError;
+        const MbrD tileMbr(Point2d(chunkLL.x(),chunkLL.y()),Point2d(chunkLL.x()+tessX*incr.x(),chunkLL.y()+tessY*incr.y()));
+        const CoordSystemConvertGrid grid(coordSys.get(),sceneCoordSys,tileMbr,maxError,TileGridInterpCells);
+        grid.convert(locs.data(),locs.data(),locs.size());
+    }
+    else
+    {
+        CoordSystemConvert3d(coordSys.get(),sceneCoordSys,locs.data(),locs.data(),locs.size());
+    }
+    coordAdapter->localToDisplayBatch(locs.data(),locs.data(),locs.size());
+    if (coordAdapter->isFlat())
+    {
+        for (auto &loc3D : locs)
+            loc3D.z() = 0.0;
+    }
+
+    if (cacheable)
+    {
+        // Rows come and go as the user moves around, so just start over now and then
+        if (gridCache.size() >= MaxTileGrids)
+            gridCache.clear();
+        gridCache[key] = locs;
+    }
+}
+
 void TileGeomManager::setup(SceneRenderer *inSceneRender,TileGeomSettings &geomSettings,
                             QuadTreeNew *inQuadTree,CoordSystemDisplayAdapter *inCoordAdapter,
                             CoordSystemRef inCoordSys,MbrD inMbr)
@@ -524,6 +625,7 @@ void TileGeomManager::setup(SceneRenderer *inSceneRender,TileGeomSettings &geomS
     coordAdapter = inCoordAdapter;
     coordSys = std::move(inCoordSys);
     mbr = inMbr;
+    gridCache.clear();
 }
     
 TileGeomManager::NodeChanges TileGeomManager::addRemoveTiles(
@@ -570,6 +672,7 @@ void TileGeomManager::cleanup(ChangeSet &changes)
     }
     
     tileMap.clear();
+    gridCache.clear();
 }
     
 std::vector<LoadedTileNewRef> TileGeomManager::getTiles(const QuadTreeNew::NodeSet &tiles)
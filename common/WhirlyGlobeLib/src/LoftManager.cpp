@@ -78,10 +78,9 @@ class DrawableBuilder2
 {
 public:
     DrawableBuilder2(Scene *scene,SceneRenderer *sceneRender,ChangeSet &changes,LoftedPolySceneRep *sceneRep,
-                     const LoftedPolyInfo &polyInfo,GeometryType primType,const GeoMbr &inDrawMbr)
+                     const LoftedPolyInfo &polyInfo,GeometryType primType)
     : scene(scene), sceneRender(sceneRender), sceneRep(sceneRep), polyInfo(polyInfo), drawable(NULL), primType(primType), changes(changes), centerValid(false), center(0,0,0), geoCenter(0,0)
     {
-        drawMbr = inDrawMbr;
     }
     
     ~DrawableBuilder2()
@@ -132,6 +131,7 @@ public:
             Point2f &geoPt = verts[ii];
             Point2d geoCoordD(geoPt.x()+geoCenter.x(),geoPt.y()+geoCenter.y());
             Point3d localPt = coordAdapter->getCoordSystem()->geographicToLocal(geoCoordD);
+            localMbr.addPoint(Point2f(localPt.x(),localPt.y()));
             Point3d dispPt = coordAdapter->localToDisplay(localPt);
             Point3d norm = coordAdapter->normalForLocal(localPt);
             Point3d pt1 = dispPt + norm * height - center;
@@ -191,6 +191,7 @@ public:
                 Point2f &geoPt = verts[jj];
                 Point2d geoCoordD(geoPt.x()+geoCenter.x(),geoPt.y()+geoCenter.y());
                 Point3d localPt = coordAdapter->getCoordSystem()->geographicToLocal(geoCoordD);
+                localMbr.addPoint(Point2f(localPt.x(),localPt.y()));
                 Point3d dispPt = coordAdapter->localToDisplay(localPt);
                 Point3d norm = coordAdapter->normalForLocal(localPt);
                 Point3d pt = dispPt + norm * height - center;
@@ -237,6 +238,7 @@ public:
             Point2f &geoPt = pts[jj];
             Point2d geoCoordD(geoPt.x()+geoCenter.x(),geoPt.y()+geoCenter.y());
             Point3d localPt = coordAdapter->getCoordSystem()->geographicToLocal(geoCoordD);
+            localMbr.addPoint(Point2f(localPt.x(),localPt.y()));
             Point3d norm = coordAdapter->normalForLocal(localPt);
             Point3d pt0 = coordAdapter->localToDisplay(localPt);
             Point3d pt1 = pt0 + norm * polyInfo.height;
@@ -324,6 +326,7 @@ public:
             Point2f &geoPt = pts[jj];
             Point2d geoCoordD(geoPt.x()+geoCenter.x(),geoPt.y()+geoCenter.y());
             Point3d localPt = coordAdapter->getCoordSystem()->geographicToLocal(geoCoordD);
+            localMbr.addPoint(Point2f(localPt.x(),localPt.y()));
             Point3d norm = coordAdapter->normalForLocal(localPt);
             Point3d pt0 = coordAdapter->localToDisplay(localPt);
             Point3d pt1 = pt0 + norm * polyInfo.height;
@@ -344,7 +347,8 @@ public:
         {
             if (drawable->getNumPoints() > 0)
             {
-                drawable->setLocalMbr(Mbr(Point2f(drawMbr.ll().x(),drawMbr.ll().y()),Point2f(drawMbr.ur().x(),drawMbr.ur().y())));
+                // Bounds of what went into this drawable, in the scene's local coordinates
+                drawable->setLocalMbr(localMbr);
                 if (centerValid)
                 {
                     Eigen::Affine3d trans(Eigen::Translation3d(center.x(),center.y(),center.z()));
@@ -360,6 +364,7 @@ public:
                 changes.push_back(new AddDrawableReq(drawable->getDrawable()));
             }
             drawable = NULL;
+            localMbr.reset();
         }
     }
     
@@ -368,7 +373,7 @@ protected:
     SceneRenderer *sceneRender;
     LoftedPolySceneRep *sceneRep;
     ChangeSet &changes;
-    GeoMbr drawMbr;
+    Mbr localMbr;
     BasicDrawableBuilderRef drawable;
     const LoftedPolyInfo &polyInfo;
     GeometryType primType;
@@ -399,14 +404,14 @@ void LoftManager::addGeometryToBuilder(LoftedPolySceneRep *sceneRep,const Lofted
     
     // Used to toss out drawables as we go
     // Its destructor will flush out the last drawable
-    DrawableBuilder2 drawBuild(scene,renderer,changes,sceneRep,polyInfo,Triangles,drawMbr);
+    DrawableBuilder2 drawBuild(scene,renderer,changes,sceneRep,polyInfo,Triangles);
     if (centerValid)
         drawBuild.setCenter(center,geoCenter);
     
     // Toss in the polygons for the sides
     if (polyInfo.height != 0.0)
     {
-        DrawableBuilder2 drawBuild2(scene,renderer,changes,sceneRep,polyInfo,Lines,drawMbr);
+        DrawableBuilder2 drawBuild2(scene,renderer,changes,sceneRep,polyInfo,Lines);
 
         for (ShapeSet::iterator it = shapes.begin(); it != shapes.end(); ++it)
         {
@@ -436,7 +441,7 @@ void LoftManager::addGeometryToBuilder(LoftedPolySceneRep *sceneRep,const Lofted
     // And do the top outline if it's there
     if (polyInfo.outline || polyInfo.outlineBottom)
     {
-        DrawableBuilder2 drawBuild2(scene,renderer,changes,sceneRep,polyInfo,Lines,drawMbr);
+        DrawableBuilder2 drawBuild2(scene,renderer,changes,sceneRep,polyInfo,Lines);
         if (centerValid)
             drawBuild2.setCenter(center,geoCenter);
         if (polyInfo.outline)
@@ -115,7 +115,36 @@ namespace {
     const static std::string geometryType("geometry_type");
 }
 
+void MapboxVectorFilter::compile(const MapboxVectorFilterProgramRef &sharedProgram)
+{
+    // Filters are shared between copies of a layer, only do this once
+    if (!program)
+    {
+        auto newProgram = sharedProgram ? sharedProgram : std::make_shared<MapboxVectorFilterProgram>();
+        programRoot = newProgram->add(*this);
+        program = std::move(newProgram);
+    }
+}
+
 bool MapboxVectorFilter::testFeature(const Dictionary &attrs,const QuadTreeIdentifier &tileID)
+{
+    if (program && attrs.supportsEntryViews())
+    {
+        return program->evaluate(programRoot, attrs, tileID);
+    }
+    return testFeatureTree(attrs, tileID);
+}
+
+bool MapboxVectorFilter::testFeature(MapboxVectorFilterProgram::Context &ctx,const Dictionary &attrs,const QuadTreeIdentifier &tileID)
+{
+    if (program && ctx.usable() && ctx.bind(program.get()))
+    {
+        return program->evaluate(programRoot, ctx);
+    }
+    return testFeature(attrs, tileID);
+}
+
+bool MapboxVectorFilter::testFeatureTree(const Dictionary &attrs,const QuadTreeIdentifier &tileID)
 {
     // Compare geometry type
     if (geomType != MBGeomNone)
@@ -133,14 +162,14 @@ bool MapboxVectorFilter::testFeature(const Dictionary &attrs,const QuadTreeIdent
     // Run each of the rules as either AND or OR
     case MBFilterAll:
         for (const auto &filter : subFilters) {
-            if (!filter->testFeature(attrs, tileID)) {
+            if (!filter->testFeatureTree(attrs, tileID)) {
                 return false;
             }
         }
         return true;
     case MBFilterAny:
         for (const auto &filter : subFilters) {
-            if (filter->testFeature(attrs, tileID)) {
+            if (filter->testFeatureTree(attrs, tileID)) {
                 return true;
             }
         }
@@ -201,4 +230,369 @@ bool MapboxVectorFilter::testFeature(const Dictionary &attrs,const QuadTreeIdent
     }
 }
 
+uint32_t MapboxVectorFilterProgram::addSlot(const std::string &attrName)
+{
+    const auto it = std::find(slots.begin(), slots.end(), attrName);
+    if (it != slots.end())
+    {
+        return (uint32_t)(it - slots.begin());
+    }
+    slots.push_back(attrName);
+    return (uint32_t)(slots.size() - 1);
+}
+
+uint32_t MapboxVectorFilterProgram::addLiteral(const DictionaryEntryRef &entry,bool numeric)
+{
+    Literal lit;
+    if (entry)
+    {
+        lit.type = entry->getType();
+        switch (lit.type)
+        {
+            case DictTypeString:
+                lit.strVal = entry->getString();
+                // Only convert if we're going to compare it with numbers, or we'll get warnings
+                if (numeric)
+                {
+                    lit.doubleVal = entry->getDouble();
+                }
+                break;
+            case DictTypeInt:
+            case DictTypeInt64:
+            case DictTypeIdentity:
+            case DictTypeDouble:
+                lit.intVal = entry->getInt();
+                lit.int64Val = (int64_t)entry->getIdentity();
+                lit.doubleVal = entry->getDouble();
+                break;
+            default:
+                wkLogLevel(Warn,"MapboxVectorFilter: Unsupported literal type %d", lit.type);
+                break;
+        }
+    }
+    literals.push_back(std::move(lit));
+    return (uint32_t)(literals.size() - 1);
+}
+
+MapboxVectorFilterProgram::Context::Context(const Dictionary &attrs,const QuadTreeIdentifier &tileID)
+    : attrs(attrs)
+    , tileID(tileID)
+    , useViews(attrs.supportsEntryViews())
+{
+    memset(evaluated, 0, sizeof(evaluated));
+}
+
+bool MapboxVectorFilterProgram::Context::bind(const MapboxVectorFilterProgram *inProgram)
+{
+    if (!program)
+    {
+        program = inProgram;
+    }
+    return program == inProgram;
+}
+
+namespace {
+    template <typename T>
+    void appendKey(std::string &key, const T &val)
+    {
+        key.append((const char *)&val, sizeof(val));
+    }
+}
+
+std::string MapboxVectorFilterProgram::instrKey(const Instruction &instr) const
+{
+    std::string key;
+    key.reserve(64);
+    appendKey(key, instr.op);
+    appendKey(key, instr.filterType);
+    switch (instr.op)
+    {
+        case OpGeomEqual:
+        case OpGeomNotEqual:
+            appendKey(key, instr.slot);
+            appendKey(key, instr.begin);
+            break;
+        case OpHas:
+        case OpNotHas:
+            appendKey(key, instr.slot);
+            break;
+        case OpIn:
+        case OpNotIn:
+        case OpCompare:
+            appendKey(key, instr.slot);
+            for (auto ii = instr.begin; ii < instr.end; ii++)
+            {
+                const auto &lit = literals[ii];
+                appendKey(key, lit.type);
+                appendKey(key, lit.intVal);
+                appendKey(key, lit.int64Val);
+                appendKey(key, lit.doubleVal);
+                appendKey(key, lit.strVal.size());
+                key.append(lit.strVal);
+            }
+            break;
+        case OpAll:
+        case OpAny:
+            for (auto ii = instr.begin; ii < instr.end; ii++)
+            {
+                appendKey(key, children[ii]);
+            }
+            break;
+        case OpFalse:
+            break;
+    }
+    return key;
+}
+
+uint32_t MapboxVectorFilterProgram::addInstr(const Instruction &instr,size_t literalStart,size_t childStart)
+{
+    const auto res = instrsByKey.insert(std::make_pair(instrKey(instr), (uint32_t)instrs.size()));
+    if (res.second)
+    {
+        instrs.push_back(instr);
+    }
+    else
+    {
+        // We've already got one of these, drop the bits we added for it
+        numShared++;
+        for (auto ii = childStart; ii < children.size(); ii++)
+        {
+            instrs[children[ii]].refs--;
+        }
+        literals.resize(literalStart);
+        children.resize(childStart);
+    }
+
+    const auto which = res.first->second;
+    instrs[which].refs++;
+    return which;
+}
+
+uint32_t MapboxVectorFilterProgram::add(const MapboxVectorFilter &filter)
+{
+    Instruction instr;
+    instr.filterType = filter.filterType;
+    // Where our own bits start, in case we turn out to be a duplicate
+    auto literalStart = literals.size();
+    auto childStart = children.size();
+
+    if (filter.geomType != MBGeomNone &&
+        (filter.filterType == MBFilterEqual || filter.filterType == MBFilterNotEqual))
+    {
+        instr.op = (filter.filterType == MBFilterEqual) ? OpGeomEqual : OpGeomNotEqual;
+        instr.slot = addSlot(geometryType);
+        instr.begin = filter.geomType;
+    }
+    else
+    {
+        switch (filter.filterType)
+        {
+            case MBFilterAll:
+            case MBFilterAny:
+            {
+                // Children first, so their own children don't get mixed in with ours
+                std::vector<uint32_t> subInstrs;
+                subInstrs.reserve(filter.subFilters.size());
+                for (const auto &subFilter : filter.subFilters)
+                {
+                    subInstrs.push_back(add(*subFilter));
+                }
+                instr.op = (filter.filterType == MBFilterAll) ? OpAll : OpAny;
+                literalStart = literals.size();
+                childStart = children.size();
+                instr.begin = (uint32_t)children.size();
+                children.insert(children.end(), subInstrs.begin(), subInstrs.end());
+                instr.end = (uint32_t)children.size();
+                break;
+            }
+            case MBFilterIn:
+            case MBFilterNotIn:
+                instr.op = (filter.filterType == MBFilterIn) ? OpIn : OpNotIn;
+                instr.slot = addSlot(filter.attrName);
+                instr.begin = (uint32_t)literals.size();
+                for (const auto &val : filter.attrVals)
+                {
+                    addLiteral(val, false);
+                }
+                instr.end = (uint32_t)literals.size();
+                break;
+            case MBFilterHas:
+            case MBFilterNotHas:
+                instr.op = (filter.filterType == MBFilterHas) ? OpHas : OpNotHas;
+                instr.slot = addSlot(filter.attrName);
+                break;
+            case MBFilterNone:
+                // Never matches
+                instr.op = OpFalse;
+                break;
+            default:
+                instr.op = OpCompare;
+                instr.slot = addSlot(filter.attrName);
+                instr.begin = addLiteral(filter.attrVal, true);
+                instr.end = instr.begin + 1;
+                break;
+        }
+    }
+
+    return addInstr(instr, literalStart, childStart);
+}
+
+const DictionaryEntryView &MapboxVectorFilterProgram::getAttr(uint32_t slot,Context &ctx,DictionaryEntryView &scratch) const
+{
+    // Each attribute is looked up only once per evaluation, if we have room to keep it
+    auto &view = (slot < MaxCachedSlots) ? ctx.views[slot] : scratch;
+    const uint32_t bit = (slot < MaxCachedSlots) ? (1U << slot) : 0;
+    if (!bit || !(ctx.fetched & bit))
+    {
+        if (!ctx.attrs.getEntryView(slots[slot], view))
+        {
+            view = DictionaryEntryView();
+        }
+        ctx.fetched |= bit;
+    }
+    return view;
+}
+
+// Same as DictionaryEntry::isEqual with the literal on the left
+bool MapboxVectorFilterProgram::matchLiteral(const Literal &lit,const DictionaryEntryView &val) const
+{
+    switch (lit.type)
+    {
+        case DictTypeString:   return val.getStringView() == lit.strVal;
+        case DictTypeInt:      return lit.intVal == (int)val.getInt64();
+        case DictTypeInt64:
+        case DictTypeIdentity: return lit.int64Val == val.getInt64();
+        case DictTypeDouble:   return lit.doubleVal == val.getDouble();
+        default:               return false;
+    }
+}
+
+bool MapboxVectorFilterProgram::evaluate(uint32_t root,const Dictionary &attrs,const QuadTreeIdentifier &tileID) const
+{
+    Context ctx(attrs, tileID);
+    return evaluate(root, ctx);
+}
+
+bool MapboxVectorFilterProgram::evaluate(uint32_t root,Context &ctx) const
+{
+    return ctx.bind(this) && evalInstr(root, ctx);
+}
+
+bool MapboxVectorFilterProgram::evalInstr(uint32_t which,Context &ctx) const
+{
+    // Only remember the results for instructions used in more than one place
+    if (instrs[which].refs < 2 || which >= MaxMemoWords * 64)
+    {
+        return evalInstrDirect(which, ctx);
+    }
+
+    const auto word = which / 64;
+    const auto bit = (uint64_t)1 << (which % 64);
+    if (ctx.evaluated[word] & bit)
+    {
+        return (ctx.results[word] & bit) != 0;
+    }
+
+    const bool result = evalInstrDirect(which, ctx);
+    ctx.evaluated[word] |= bit;
+    ctx.results[word] = result ? (ctx.results[word] | bit) : (ctx.results[word] & ~bit);
+    return result;
+}
+
+bool MapboxVectorFilterProgram::evalInstrDirect(uint32_t which,Context &ctx) const
+{
+    const auto &instr = instrs[which];
+    DictionaryEntryView scratch;
+
+    switch (instr.op)
+    {
+        case OpFalse:
+            return false;
+        case OpGeomEqual:
+        case OpGeomNotEqual:
+        {
+            // Same conversion as Dictionary::getInt
+            const auto &val = getAttr(instr.slot, ctx, scratch);
+            int attrGeomType = 0;
+            switch (val.type) {
+                case DictTypeInt:
+                case DictTypeInt64:  attrGeomType = (int)val.intVal; break;
+                case DictTypeDouble: attrGeomType = (int)val.doubleVal; break;
+                default: break;
+            }
+            attrGeomType -= 1;
+            return (instr.op == OpGeomEqual) == (attrGeomType == (int)instr.begin);
+        }
+        case OpAll:
+            for (auto ii = instr.begin; ii < instr.end; ii++) {
+                if (!evalInstr(children[ii], ctx)) {
+                    return false;
+                }
+            }
+            return true;
+        case OpAny:
+            for (auto ii = instr.begin; ii < instr.end; ii++) {
+                if (evalInstr(children[ii], ctx)) {
+                    return true;
+                }
+            }
+            return false;
+        case OpIn:
+        case OpNotIn:
+        {
+            const auto &val = getAttr(instr.slot, ctx, scratch);
+            if (val.type != DictTypeNone) {
+                for (auto ii = instr.begin; ii < instr.end; ii++) {
+                    if (matchLiteral(literals[ii], val)) {
+                        return (instr.op == OpIn);
+                    }
+                }
+            }
+            return (instr.op != OpIn);
+        }
+        case OpHas:
+            return getAttr(instr.slot, ctx, scratch).type != DictTypeNone;
+        case OpNotHas:
+            return getAttr(instr.slot, ctx, scratch).type == DictTypeNone;
+        case OpCompare:
+        {
+            const auto &val = getAttr(instr.slot, ctx, scratch);
+            const auto &lit = literals[instr.begin];
+            switch (val.type) {
+            case DictTypeNone:
+                // No attribute means no pass
+                // A missing value and != is valid
+                return (instr.filterType == MBFilterNotEqual);
+            case DictTypeString:
+                switch (instr.filterType) {
+                    case MBFilterEqual:    return val.stringVal == lit.strVal;
+                    case MBFilterNotEqual: return val.stringVal != lit.strVal;
+                    default: return true;  // Note: Not expecting other comparisons to strings
+                }
+            case DictTypeInt:
+            case DictTypeDouble:
+            {
+                const double val1 = val.getDouble();
+                const double val2 = lit.doubleVal;
+                switch (instr.filterType)
+                {
+                    case MBFilterEqual:            return val1 == val2;
+                    case MBFilterNotEqual:         return val1 != val2;
+                    case MBFilterGreaterThan:      return val1 > val2;
+                    case MBFilterGreaterThanEqual: return val1 >= val2;
+                    case MBFilterLessThan:         return val1 < val2;
+                    case MBFilterLessThanEqual:    return val1 <= val2;
+                    default: return true;
+                }
+            }
+            default:
+                wkLogLevel(Warn,"MapboxVectorFilter: Found numeric comparison that doesn't use numbers - '%s', %d/%d/%d",
+                           slots[instr.slot].c_str(), ctx.tileID.level, ctx.tileID.x, ctx.tileID.y);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 }
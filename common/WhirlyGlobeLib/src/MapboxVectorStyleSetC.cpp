@@ -114,6 +114,10 @@ std::string MapboxRegexField::build(const DictionaryRef &attrs) const
     std::string text;
     text.reserve(chunks.size() * 20);
 
+    // Look at the values in place if we can, rather than copying each one out
+    const bool useViews = attrs->supportsEntryViews();
+    DictionaryEntryView view;
+
     std::string keyVal;
     for (const auto &chunk : chunks) {
         if (!chunk.str.empty()) {
@@ -122,7 +126,15 @@ std::string MapboxRegexField::build(const DictionaryRef &attrs) const
         }
         for (const auto &key : chunk.keys) {
             didLookup = true;
-            if (attrs->hasField(key)) {
+            if (useViews) {
+                if (attrs->getEntryView(key, view)) {
+                    found = true;
+                    const auto len = text.size();
+                    if (view.appendString(text) && text.size() > len) {
+                        break;
+                    }
+                }
+            } else if (attrs->hasField(key)) {
                 found = true;
                 keyVal = attrs->getString(key);
                 if (!keyVal.empty()) {
@@ -517,6 +529,24 @@ void MapboxVectorStyleSetImpl::addLayer(PlatformThreadInfo *inst, MapboxVectorSt
         return;
     }
 
+    // Flatten the filter for quick evaluation.
+    // All the layers for a given source layer share one program, so predicates
+    // they have in common are only evaluated once per feature.
+    if (layer->filter)
+    {
+        MapboxVectorFilterProgramRef program;
+        if (!layer->sourceLayer.empty())
+        {
+            auto &sourceProgram = filterProgramsBySource[layer->sourceLayer];
+            if (!sourceProgram)
+            {
+                sourceProgram = std::make_shared<MapboxVectorFilterProgram>();
+            }
+            program = sourceProgram;
+        }
+        layer->filter->compile(program);
+    }
+
     // Sort into various buckets for quick lookup
     layersByName[layer->ident] = layer;
     layersByUUID[layer->getUuid(inst)] = layer;
@@ -987,11 +1017,14 @@ std::vector<VectorStyleImplRef> MapboxVectorStyleSetImpl::stylesForFeature(Platf
 {
     std::vector<VectorStyleImplRef> styles;
 
+    // Shared by all the filters for this source layer
+    MapboxVectorFilterProgram::Context filterCtx(attrs, tileID);
+
     const auto range = layersBySource.equal_range(layerName);
     for (auto i = range.first; i != range.second; ++i)
     {
         auto &layer = i->second;
-        if (!layer->filter || layer->filter->testFeature(attrs, tileID))
+        if (!layer->filter || layer->filter->testFeature(filterCtx, attrs, tileID))
         {
             if (styles.empty())
             {
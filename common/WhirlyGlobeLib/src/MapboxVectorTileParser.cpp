@@ -22,6 +22,7 @@
 #import "WhirlyKitLog.h"
 #import "DictionaryC.h"
 #import "VectorTilePBFParser.h"
+#import "TaskScheduler.h"
 
 #include <utility>
 #import <vector>
@@ -84,7 +85,7 @@ void VectorTileData::clear()
 }
 
 MapboxVectorTileParser::MapboxVectorTileParser(PlatformThreadInfo *inst,VectorStyleDelegateImplRef styleDelegate)
-    : localCoords(false), keepVectors(false), parseAll(false), styleDelegate(styleDelegate)
+    : localCoords(false), keepVectors(false), parseAll(false), parallel(true), styleDelegate(styleDelegate)
 {
     // Index all the categories ahead of time.  Once.
     std::vector<VectorStyleImplRef> allStyles = styleDelegate->allStyles(inst);
@@ -149,10 +150,13 @@ bool MapboxVectorTileParser::parse(PlatformThreadInfo *styleInst,
 //#endif
     const auto t0 = std::chrono::steady_clock::now();
 
+    const TaskSchedulerRef scheduler = (parallel && styleDelegate->supportsParallelParsing()) ?
+                                       TaskScheduler::getShared() : TaskSchedulerRef();
+
     VectorTilePBFParser parser(tileData, &*styleDelegate, styleInst, filterName, filterValues,
                                tileData->vecObjsByStyle, localCoords, parseAll,
                                keepVectors ? &tileData->vecObjs : nullptr, cancelFn);
-    if (!parser.parse(rawData->getRawData(), rawData->getLen()))
+    if (!parser.parse(rawData->getRawData(), rawData->getLen(), scheduler.get()))
     {
         if (parser.getParseCancelled())
         {
@@ -204,17 +208,36 @@ bool MapboxVectorTileParser::parse(PlatformThreadInfo *styleInst,
 //    }
     
     // Run the styles over their assembled data
-    for (const auto &it : tileData->vecObjsByStyle)
+    std::vector<std::pair<SimpleIdentity,std::vector<VectorObjectRef> *>> styleVecs(
+            tileData->vecObjsByStyle.begin(), tileData->vecObjsByStyle.end());
+    std::vector<VectorTileDataRef> styleDatas(styleVecs.size());
+    if (scheduler && styleVecs.size() > 1)
     {
-        std::vector<VectorObjectRef> &vecs = *it.second;
+        // Build them all at once, then merge them in style order below
+        scheduler->parallelFor(styleInst, styleVecs.size(), 1,
+                               [&](PlatformThreadInfo *threadInst, size_t begin, size_t end)
+        {
+            for (size_t ii = begin; ii < end; ii++)
+            {
+                styleDatas[ii] = std::make_shared<VectorTileData>(*tileData);
+                buildForStyle(threadInst,styleVecs[ii].first,*styleVecs[ii].second,styleDatas[ii],cancelFn);
+            }
+        });
+    }
 
-        auto styleData = std::make_shared<VectorTileData>(*tileData);
+    for (size_t ii = 0; ii < styleVecs.size(); ii++)
+    {
+        auto &styleData = styleDatas[ii];
+        if (!styleData)
+        {
+            styleData = std::make_shared<VectorTileData>(*tileData);
 
-        // Ask the subclass to run the style and fill in the VectorTileData
-        buildForStyle(styleInst,it.first,vecs,styleData,cancelFn);
+            // Ask the subclass to run the style and fill in the VectorTileData
+            buildForStyle(styleInst,styleVecs[ii].first,*styleVecs[ii].second,styleData,cancelFn);
+        }
 
         // Sort the results into categories if needed
-        auto catIt = styleCategories.find(it.first);
+        auto catIt = styleCategories.find(styleVecs[ii].first);
         if (catIt != styleCategories.end() && !styleData->compObjs.empty())
         {
             const std::string &category = catIt->second;
@@ -229,12 +252,21 @@ bool MapboxVectorTileParser::parse(PlatformThreadInfo *styleInst,
         
         // Merge this into the general return data
         tileData->mergeFrom(styleData.get());
+        styleData.reset();
 
         // The changes in `tileData` represent objects already tracked
         // in the managers they must be merged or we'll have leaks, so
         // we can't return between the build and the merge above.
+        // Anything built in parallel has to be merged before we bail out, too.
         if (cancelFn(styleInst))
         {
+            for (size_t jj = ii + 1; jj < styleDatas.size(); jj++)
+            {
+                if (styleDatas[jj])
+                {
+                    tileData->mergeFrom(styleDatas[jj].get());
+                }
+            }
             return false;
         }
     }
@@ -531,10 +531,11 @@ SimpleIdentity MarkerManager::addMarkers(const std::vector<Marker *> &markers,co
                     draw->addTexCoord(kk, texCoord[jj]);
                 }
 
-                const Point3f localLoc = coordAdapter->getCoordSystem()->geographicToLocal(marker->loc);
+                // Cover the corners, not just the center
+                const Point3d cornerLocal = coordAdapter->displayToLocal(Vector3fToVector3d(pt));
 
                 Mbr localMbr = draw->getLocalMbr();
-                localMbr.addPoint(Point2f(localLoc.x(),localLoc.y()));
+                localMbr.addPoint(Point2d(cornerLocal.x(),cornerLocal.y()));
                 draw->setLocalMbr(localMbr);
             }
             
@@ -0,0 +1,50 @@
+/*
+ *  MbrRTree.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "MbrRTree.h"
+
+namespace WhirlyKit
+{
+
+void MbrRTree::insert(SimpleIdentity ident,const MbrD &mbr)
+{
+    tree.remove(ident);
+    if (!mbr.valid())
+        return;
+
+    tree.insert(ident, Tree::Box { mbr.ll(), mbr.ur() });
+}
+
+void MbrRTree::findOverlapping(const MbrD &mbr,std::vector<SimpleIdentity> &idents) const
+{
+    if (!mbr.valid())
+        return;
+
+    const Tree::Box box { mbr.ll(), mbr.ur() };
+    tree.search([&box](const Tree::Box &that,const Payload &)
+                {
+                    return box.ll.x() <= that.ur.x() && that.ll.x() <= box.ur.x() &&
+                           box.ll.y() <= that.ur.y() && that.ll.y() <= box.ur.y();
+                },
+                [&idents](const Tree::Entry &entry)
+                {
+                    idents.push_back(entry.ident);
+                });
+}
+
+}
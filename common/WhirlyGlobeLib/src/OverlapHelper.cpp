@@ -40,6 +40,7 @@ OverlapHelper::OverlapHelper(const Mbr &mbr, int sizeX, int sizeY, size_t count)
     if (count > 0)
     {
         objects.reserve(count);
+        objectChecks.reserve(count);
     }
 }
 
@@ -66,7 +67,7 @@ bool OverlapHelper::addCheckObject(const Point2dVector &pts, const char* mergeID
     }
 
     // Okay, so it doesn't overlap.  Let's add it where needed.
-    addObject(pts, mergeID ? mergeID : std::string(),
+    addObject(pts, mergeID ? mergeID : std::string(), objMbr,
               sx, sy, ex, ey);
 
     return true;
@@ -86,26 +87,46 @@ static inline bool eq(const char* ida, const std::string &idb)
     return ida && ida == idb;
 }
 
-bool OverlapHelper::checkObject(const Point2dVector &pts, const Mbr &objMbr,
+// Same answer as ConvexPolyIntersect, which only compares the bounds
+static inline bool BoundsOverlap(const Mbr &a,const Mbr &b)
+{
+    return a.valid() && b.valid() &&
+           a.ll().x() <= b.ur().x() && b.ll().x() <= a.ur().x() &&
+           a.ll().y() <= b.ur().y() && b.ll().y() <= a.ur().y();
+}
+
+bool OverlapHelper::checkObject(__unused const Point2dVector &pts, const Mbr &objMbr,
                                 int sx, int sy, int ex, int ey, const char* mergeID)
 {
-    const auto sizeGuess = (int)std::ceil((ex - sx + 1) * (ey - sy + 1) / overlapHeuristic);
-    std::unordered_set<int> indexes(std::max(1, sizeGuess));
+    if (++curCheck == 0)
+    {
+        // Wrapped around, start the marks over
+        std::fill(objectChecks.begin(), objectChecks.end(), 0);
+        curCheck = 1;
+    }
 
-    // Gather all the matching indexes, ignoring duplicates
+    // Check each object once, unless it shares the same ID
     for (int ix=sx;ix<=ex;ix++)
     {
         for (int iy=sy;iy<=ey;iy++)
         {
-            const auto &cellIndexes = cellAt(ix, iy).objIndexes;
-            indexes.insert(cellIndexes.begin(), cellIndexes.end());
+            for (const int ii : cellAt(ix, iy).objIndexes)
+            {
+                if (objectChecks[ii] == curCheck)
+                {
+                    continue;
+                }
+                objectChecks[ii] = curCheck;
+
+                const auto &obj = objects[ii];
+                if (BoundsOverlap(obj.mbr, objMbr) && !eq(mergeID, obj.mergeID))
+                {
+                    return false;
+                }
+            }
         }
     }
-    // Check each unique object index, unless it shares the same ID
-    return !std::any_of(indexes.begin(), indexes.end(), [&](int ii) {
-            return !eq(mergeID, objects[ii].mergeID) &&
-                    ConvexPolyIntersect(objects[ii].pts,pts);
-        });
+    return true;
 }
 
 bool OverlapHelper::checkObject(const Point2dVector &pts, const char* mergeID)
@@ -124,13 +145,14 @@ void OverlapHelper::addObject(Point2dVector pts, std::string mergeID)
     calcCells(objMbr, sx,sy,ex,ey);
 
     // Okay, so it doesn't overlap.  Let's add it where needed.
-    addObject(std::move(pts), std::move(mergeID), sx, sy, ex, ey);
+    addObject(std::move(pts), std::move(mergeID), objMbr, sx, sy, ex, ey);
 }
 
-void OverlapHelper::addObject(Point2dVector pts, std::string mergeID,
+void OverlapHelper::addObject(Point2dVector pts, std::string mergeID, const Mbr &objMbr,
                               int sx, int sy, int ex, int ey)
 {
-    objects.emplace_back(std::move(pts), std::move(mergeID));
+    objects.emplace_back(std::move(pts), std::move(mergeID), objMbr);
+    objectChecks.push_back(0);
     const auto newId = (int)(objects.size() - 1);
     const auto sizeEstimate = std::max((int)std::ceil(totalObjs * overlapHeuristic),5);
 
@@ -20,6 +20,7 @@
 #import "Proj4CoordSystem.h"
 #import "GlobeMath.h"
 #import "proj_api.h"
+#import <algorithm>
 
 #define PJ_ERR_BOUNDS -14   // boring out-of-bounds error
 
@@ -199,6 +200,75 @@ Point3d Proj4CoordSystem::geocentricToLocal(Point3d geocPt) const
     return {x,y,z};
 }
 
+// Run a batch of points through proj.4 in place.
+// Some errors stop pj_transform partway through, in which case we go back to the
+//  original points and do them one at a time.  Either way, failures come out as zeros.
+template <typename GetOrig>
+static void Proj4TransformBatch(void *src,void *dst,Point3d *pts,size_t num,const GetOrig &getOrig)
+{
+    if (num == 0)
+        return;
+
+    if (pj_transform(src, dst, (long)num, 3, &pts[0].x(), &pts[0].y(), &pts[0].z()) == 0)
+    {
+        for (size_t ii=0;ii<num;ii++)
+        {
+            if (pts[ii].x() == HUGE_VAL || pts[ii].y() == HUGE_VAL)
+                pts[ii] = Point3d(0,0,0);
+        }
+        return;
+    }
+
+    for (size_t ii=0;ii<num;ii++)
+    {
+        Point3d &pt = pts[ii];
+        pt = getOrig(ii);
+        if (pj_transform(src, dst, 1, 1, &pt.x(), &pt.y(), &pt.z()) != 0)
+            pt = Point3d(0,0,0);
+    }
+}
+
+// Same, but for when the input may be the output
+static void Proj4TransformBatch(void *src,void *dst,const Point3d *in,Point3d *out,size_t num)
+{
+    if (in == out)
+    {
+        const Point3dVector orig(in, in + num);
+        Proj4TransformBatch(src, dst, out, num, [&](size_t ii) { return orig[ii]; });
+    }
+    else
+    {
+        std::copy(in, in + num, out);
+        Proj4TransformBatch(src, dst, out, num, [&](size_t ii) { return in[ii]; });
+    }
+}
+
+void Proj4CoordSystem::localToGeographicBatch(const Point3d *in,Point2d *out,size_t num) const
+{
+    Point3dVector pts(in, in + num);
+    Proj4TransformBatch(pj, pj_latlon, pts.data(), num, [&](size_t ii) { return in[ii]; });
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = Point2d(pts[ii].x(),pts[ii].y());
+}
+
+void Proj4CoordSystem::geographicToLocalBatch(const Point2d *in,Point3d *out,size_t num) const
+{
+    const auto getOrig = [&](size_t ii) { return Point3d(in[ii].x(),in[ii].y(),0.0); };
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = getOrig(ii);
+    Proj4TransformBatch(pj_latlon, pj, out, num, getOrig);
+}
+
+void Proj4CoordSystem::localToGeocentricBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    Proj4TransformBatch(pj, pj_geocentric, in, out, num);
+}
+
+void Proj4CoordSystem::geocentricToLocalBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    Proj4TransformBatch(pj_geocentric, pj, in, out, num);
+}
+
 bool Proj4CoordSystem::isSameAs(const CoordSystem *coordSys) const
 {
     const auto other = dynamic_cast<const Proj4CoordSystem *>(coordSys);
@@ -84,6 +84,12 @@ Scene::Scene(CoordSystemDisplayAdapter *adapter) :
     textures(100)
 {
     SetupDrawableStrings();
+
+    Mbr localBounds;
+    Point3f ll,ur;
+    if (coordAdapter && coordAdapter->getBounds(ll,ur))
+        localBounds = Mbr(Point2f(ll.x(),ll.y()),Point2f(ur.x(),ur.y()));
+    drawableIndex = std::make_unique<DrawableSpatialIndex>(localBounds);
     
     // Selection manager is used for object selection from any thread
     addManager(kWKSelectionManager,std::make_shared<SelectionManager>(this));
@@ -128,7 +134,6 @@ Scene::~Scene()
             std::unique_lock<std::mutex>(coordAdapterLock, std::try_to_lock),
             std::unique_lock<std::mutex>(drawablesLock, std::try_to_lock),
             std::unique_lock<std::mutex>(textureLock, std::try_to_lock),
-            std::unique_lock<std::mutex>(changeRequestLock, std::try_to_lock),
             std::unique_lock<std::mutex>(subTexLock, std::try_to_lock),
             std::unique_lock<std::mutex>(managerLock, std::try_to_lock),
             std::unique_lock<std::mutex>(programLock, std::try_to_lock),
@@ -173,6 +178,8 @@ Scene::~Scene()
     }
 #endif
 
+    takeIncomingChanges();
+
     auto theChangeRequests = std::move(changeRequests);
     for (auto *theChangeRequest : theChangeRequests)
     {
@@ -222,33 +229,114 @@ void Scene::setDisplayAdapter(CoordSystemDisplayAdapter *newCoordAdapter)
 // Add change requests to our list
 void Scene::addChangeRequests(const ChangeSet &newChanges)
 {
-    std::lock_guard<std::mutex> guardLock(changeRequestLock);
-    
-    for (ChangeRequest *change : newChanges)
+    if (newChanges.empty())
+        return;
+
+    auto batch = new ChangeBatch();
+    batch->changes = newChanges;
+
+    // Count these before they're visible so hasChanges can't miss them
+    int numUntimed = 0;
+    TimeInterval firstTimed = std::numeric_limits<TimeInterval>::max();
+    for (const auto *change : newChanges)
     {
-        if (change && change->when > 0.0)
-            timedChangeRequests.insert(change);
+        if (!change)
+            continue;
+        if (change->when > 0.0)
+            firstTimed = std::min(firstTimed, change->when);
         else
-            changeRequests.push_back(change);
+            numUntimed++;
+    }
+    numChangeRequests.fetch_add(numUntimed, std::memory_order_relaxed);
+
+    batch->next = incomingChanges.load(std::memory_order_relaxed);
+    while (!incomingChanges.compare_exchange_weak(batch->next, batch))
+    {
+    }
+
+    // Timed ones wake the renderer through the next start time.
+    // This has to come after the push, see updateNextTimedChange.
+    TimeInterval curNext = nextTimedChange.load();
+    while (firstTimed < curNext && !nextTimedChange.compare_exchange_weak(curNext, firstTimed))
+    {
     }
 }
 
 // Add a single change request
 void Scene::addChangeRequest(ChangeRequest *newChange)
 {
-    std::lock_guard<std::mutex> guardLock(changeRequestLock);
-
-    if (newChange && newChange->when > 0.0)
-        timedChangeRequests.insert(newChange);
-    else
-        changeRequests.push_back(newChange);
+    addChangeRequests(ChangeSet { newChange });
 }
 
 int Scene::getNumChangeRequests() const
 {
-    std::lock_guard<std::mutex> guardLock(changeRequestLock);
+    return std::max(0, numChangeRequests.load(std::memory_order_relaxed));
+}
+
+// Min-heap on start time
+static bool TimedChangeAfter(const ChangeRequest *a,const ChangeRequest *b)
+{
+    return a->when > b->when;
+}
+
+void Scene::takeIncomingChanges()
+{
+    if (takeIncomingBatches())
+        updateNextTimedChange();
+}
+
+bool Scene::takeIncomingBatches()
+{
+    ChangeBatch *batch = incomingChanges.exchange(nullptr);
+    if (!batch)
+        return false;
+
+    // They were pushed newest first, so flip them around
+    ChangeBatch *ordered = nullptr;
+    while (batch)
+    {
+        ChangeBatch *next = batch->next;
+        batch->next = ordered;
+        ordered = batch;
+        batch = next;
+    }
 
-    return changeRequests.size();
+    bool newTimed = false;
+    while (ordered)
+    {
+        for (auto *change : ordered->changes)
+        {
+            if (!change)
+                continue;
+            if (change->when > 0.0)
+            {
+                timedChangeRequests.push_back(change);
+                std::push_heap(timedChangeRequests.begin(), timedChangeRequests.end(), TimedChangeAfter);
+                newTimed = true;
+            }
+            else
+            {
+                changeRequests.push_back(change);
+            }
+        }
+        ChangeBatch *next = ordered->next;
+        delete ordered;
+        ordered = next;
+    }
+
+    return newTimed;
+}
+
+void Scene::updateNextTimedChange()
+{
+    // Producers lower this after pushing their batch.  If one got in between taking the
+    //  incoming list and this store we'd wipe out its start time, so pick it up and go again.
+    do
+    {
+        nextTimedChange.store(timedChangeRequests.empty() ? std::numeric_limits<TimeInterval>::max() :
+                                                            timedChangeRequests.front()->when);
+    }
+    while (takeIncomingBatches());
 }
 
 DrawableRef Scene::getDrawable(SimpleIdentity drawId) const
@@ -362,6 +450,16 @@ std::vector<Drawable *> Scene::getDrawables() const
     return retDraws;
 }
 
+std::vector<Drawable *> Scene::getDrawables(const Mbr &localMbr) const
+{
+    std::vector<Drawable *> retDraws;
+
+    std::lock_guard<std::mutex> guardLock(drawablesLock);
+    drawableIndex->findDrawables(localMbr, retDraws);
+
+    return retDraws;
+}
+
 void Scene::setCurrentTime(TimeInterval newTime)
 {
     currentTime = newTime;
@@ -390,22 +488,25 @@ TimeInterval Scene::getBaseTime() const
     
 int Scene::preProcessChanges(WhirlyKit::View *view,SceneRenderer *renderer,__unused TimeInterval now)
 {
-    ChangeSet preRequests;
+    takeIncomingChanges();
 
+    // Just doing the ones that require a pre-process
+    ChangeSet preRequests;
+    for (auto &req : changeRequests)
     {
-        std::lock_guard<std::mutex> guardLock(changeRequestLock);
-        // Just doing the ones that require a pre-process
-        for (auto &req : changeRequests)
+        if (req && req->needPreExecute())
         {
-            if (req && req->needPreExecute())
-            {
-                preRequests.push_back(req);
-                req = nullptr;
-            }
+            preRequests.push_back(req);
+            req = nullptr;
         }
     }
+    if (preRequests.empty())
+        return 0;
 
-    // Run these outside of the lock, since they might use the lock
+    changeRequests.erase(std::remove(changeRequests.begin(), changeRequests.end(), nullptr), changeRequests.end());
+    numChangeRequests.fetch_sub((int)preRequests.size(), std::memory_order_relaxed);
+
+    // These might add more changes, which will be picked up next time through
     for (auto req : preRequests)
     {
         req->execute(this,renderer,view);
@@ -416,64 +517,72 @@ int Scene::preProcessChanges(WhirlyKit::View *view,SceneRenderer *renderer,__unu
 }
 
 // Process outstanding changes.
-// We'll grab the lock and we're only expecting to be called in the rendering thread
+// Only the rendering thread touches the queues here, producers never wait on us.
 int Scene::processChanges(WhirlyKit::View *view,SceneRenderer *renderer,TimeInterval now)
 {
-    // Set up a local collection of approximately the same capacity before locking
-    decltype(changeRequests) localChanges;
-    localChanges.reserve(changeRequests.capacity());
+    takeIncomingChanges();
 
+    // See if any of the timed changes are ready
+    if (!timedChangeRequests.empty() && timedChangeRequests.front()->when <= now)
     {
-        std::lock_guard<std::mutex> guardLock(changeRequestLock);
-
-        // See if any of the timed changes are ready
-        if (!timedChangeRequests.empty())
+        int numReady = 0;
+        while (!timedChangeRequests.empty() && timedChangeRequests.front()->when <= now)
         {
-            // Establish the range of changes to be moved
-            const auto beg = timedChangeRequests.begin();
-            auto end = beg;
-            while (end != timedChangeRequests.end() && (*end)->when <= now)
-            {
-                ++end;
-            }
-
-            // Move them
-            if (end != beg)
-            {
-                std::copy(beg, end, std::back_inserter(changeRequests));
-                timedChangeRequests.erase(beg, end);
-            }
+            std::pop_heap(timedChangeRequests.begin(), timedChangeRequests.end(), TimedChangeAfter);
+            changeRequests.push_back(timedChangeRequests.back());
+            timedChangeRequests.pop_back();
+            numReady++;
         }
-
-        // Move the outstanding changes to the local collection and release the lock
-        localChanges.swap(changeRequests);
+        numChangeRequests.fetch_add(numReady, std::memory_order_relaxed);
+        updateNextTimedChange();
     }
 
-    for (auto req : localChanges)
+    const bool budgeted = (changeTimeBudget > 0.0 || changeCountBudget > 0);
+    const TimeInterval startTime = (changeTimeBudget > 0.0) ? TimeGetCurrent() : 0.0;
+
+    // Requests executed here may add more, so work from a local copy
+    ChangeSet localChanges;
+    localChanges.swap(changeRequests);
+
+    int numExecuted = 0;
+    auto it = localChanges.begin();
+    for (; it != localChanges.end(); ++it)
     {
-        if (req)
+        if (auto req = *it)
         {
+            // Stop once we've used up the budget, but always make some progress
+            if (budgeted && numExecuted > 0 &&
+                ((changeCountBudget > 0 && numExecuted >= changeCountBudget) ||
+                 (changeTimeBudget > 0.0 && TimeGetCurrent() - startTime >= changeTimeBudget)))
+            {
+                break;
+            }
+
             req->execute(this,renderer,view);
             delete req;
+            numExecuted++;
         }
     }
+    numChangeRequests.fetch_sub(numExecuted, std::memory_order_relaxed);
+
+    // Whatever is left stays in front of anything that comes in later, so the order holds
+    localChanges.erase(localChanges.begin(), it);
+    numDeferredChanges = (int)localChanges.size();
+    changeRequests.swap(localChanges);
+
+    return numExecuted;
+}
 
-    return localChanges.size();
+void Scene::setChangeBudget(TimeInterval maxTime,int maxCount)
+{
+    changeTimeBudget = std::max(maxTime, 0.0);
+    changeCountBudget = std::max(maxCount, 0);
 }
     
 bool Scene::hasChanges(TimeInterval now) const
 {
-    bool changes = false;
-    std::unique_lock<std::mutex> lock(changeRequestLock,std::try_to_lock);
-    if (lock.owns_lock())
-    {
-        changes = !changeRequests.empty();
-        
-        if (!changes && !timedChangeRequests.empty())
-            changes = now >= (*timedChangeRequests.begin())->when;
-
-        lock.unlock();
-    }
+    const bool changes = numChangeRequests.load(std::memory_order_relaxed) > 0 ||
+                         now >= nextTimedChange.load(std::memory_order_relaxed);
     
     // How about the active models?
     for (const auto& model : activeModels)
@@ -544,6 +653,7 @@ void Scene::addDrawable(DrawableRef draw)
 {
     std::lock_guard<std::mutex> guardLock(drawablesLock);
 
+    drawableIndex->addDrawable(draw.get());
     drawables[draw->getId()] = std::move(draw);
 }
     
@@ -558,7 +668,20 @@ void Scene::remDrawable(SimpleIdentity id)
 
     const auto it = drawables.find(id);
     if (it != drawables.end())
+    {
+        drawableIndex->removeDrawable(id);
         drawables.erase(it);
+    }
+}
+
+void Scene::updateDrawableBounds(Drawable *draw)
+{
+    std::lock_guard<std::mutex> guardLock(drawablesLock);
+
+    if (drawables.find(draw->getId()) != drawables.end())
+    {
+        drawableIndex->addDrawable(draw);
+    }
 }
 
 void Scene::addTexture(TextureBaseRef texRef)
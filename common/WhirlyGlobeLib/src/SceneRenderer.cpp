@@ -17,6 +17,7 @@
  */
 
 #import "SceneRenderer.h"
+#import "MaplyView.h"
 
 using namespace Eigen;
 
@@ -322,6 +323,41 @@ Mbr SceneRenderer::getFramebufferBoundScaled(float margin) const
     return { size * -margin, size * (1.0f + margin) };
 }
 
+bool SceneRenderer::calcVisibleLocalMbr(const Eigen::Matrix4d &mvpInvMat,float marginFrac,Mbr &localMbr) const
+{
+    const auto coordAdapter = scene ? scene->getCoordAdapter() : nullptr;
+    if (!coordAdapter || !dynamic_cast<const Maply::MapView *>(theView))
+        return false;
+
+    // Run each corner of the view from the near plane to the far plane and see
+    //  where it hits the map, which is at z = 0 in display space
+    localMbr.reset();
+    for (const Point2d &corner : { Point2d(-1,-1), Point2d(1,-1), Point2d(1,1), Point2d(-1,1) })
+    {
+        const Vector4d near4 = mvpInvMat * Vector4d(corner.x(),corner.y(),-1.0,1.0);
+        const Vector4d far4 = mvpInvMat * Vector4d(corner.x(),corner.y(),1.0,1.0);
+        if (near4.w() == 0.0 || far4.w() == 0.0)
+            return false;
+        const Vector3d nearPt = near4.head<3>() / near4.w();
+        const Vector3d farPt = far4.head<3>() / far4.w();
+
+        const double dz = nearPt.z() - farPt.z();
+        const double t = (dz != 0.0) ? nearPt.z() / dz : -1.0;
+        if (t < 0.0 || t > 1.0)
+            return false;
+
+        const Point3d dispPt = nearPt + t * (farPt - nearPt);
+        const Point3d localPt = coordAdapter->displayToLocal(dispPt);
+        localMbr.addPoint(Point2d(localPt.x(),localPt.y()));
+    }
+
+    const Point2f pad = localMbr.span() * marginFrac;
+    localMbr.ll() -= pad;
+    localMbr.ur() += pad;
+
+    return true;
+}
+
 void SceneRenderer::setRenderUntil(TimeInterval newRenderUntil)
 {
     renderUntil = std::max(renderUntil,newRenderUntil);
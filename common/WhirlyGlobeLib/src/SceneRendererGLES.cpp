@@ -36,6 +36,10 @@ using namespace WhirlyKit;
 namespace WhirlyKit
 {
 
+// Padding around the visible area when culling drawables, as a fraction of its size.
+// Tall geometry and shader offsets can reach in from outside.
+static constexpr float DrawableCullMargin = 0.25f;
+
 WorkGroupGLES::WorkGroupGLES(GroupType inGroupType)
 {
     groupType = inGroupType;
@@ -150,6 +154,7 @@ void SceneRendererGLES::setView(View *newView)
 void SceneRendererGLES::setScene(Scene *newScene)
 {
     SceneRenderer::setScene(newScene);
+    clearDrawOrder();
     auto *sceneGL = (SceneGLES *)newScene;
     setupInfo.memManager = sceneGL ? sceneGL->getMemManager() : nullptr;
 }
@@ -255,6 +260,103 @@ void SceneRendererGLES::setExtraFrameMode(bool newMode)
         extraFrameCount = 2;
 }
     
+void SceneRendererGLES::removeDrawable(DrawableRef draw,bool teardown,RenderTeardownInfoRef teardownInfo)
+{
+    const auto it = drawOrderPos.find(draw->getId());
+    if (it != drawOrderPos.end())
+    {
+        drawOrder.erase(it->second);
+        drawOrderPos.erase(it);
+    }
+
+    SceneRenderer::removeDrawable(std::move(draw), teardown, std::move(teardownInfo));
+}
+
+bool SceneRendererGLES::drawOrderBefore(const DrawOrderEntry &a,const DrawOrderEntry &b,bool sortLinesToEnd)
+{
+    if (a.drawPriority != b.drawPriority)
+        return a.drawPriority < b.drawPriority;
+    if (sortLinesToEnd && a.zBuffer != b.zBuffer)
+        return !a.zBuffer;
+    return a.drawID < b.drawID;
+}
+
+void SceneRendererGLES::beginDrawOrder(bool sortLinesToEnd)
+{
+    drawOrderFrame++;
+
+    // The entries carry their own keys, so this never touches the drawables.
+    // Only happens when the z buffer mode changes.
+    if (sortLinesToEnd != drawOrder.key_comp().sortLinesToEnd)
+    {
+        DrawOrderSet newOrder(DrawOrderSorter { sortLinesToEnd });
+        while (!drawOrder.empty())
+        {
+            const auto pos = newOrder.insert(drawOrder.extract(drawOrder.begin())).position;
+            drawOrderPos[pos->drawID] = pos;
+        }
+        drawOrder.swap(newOrder);
+    }
+}
+
+void SceneRendererGLES::markDrawOrder(DrawableGLES *draw,unsigned int offset)
+{
+    const SimpleIdentity drawID = draw->getId();
+    const unsigned int drawPriority = draw->getDrawPriority();
+    const bool zBuffer = draw->getRequestZBuffer();
+    const uint32_t offsetBit = 1U << offset;
+
+    const auto it = drawOrderPos.find(drawID);
+    if (it == drawOrderPos.end())
+    {
+        const auto pos = drawOrder.insert(DrawOrderEntry { drawPriority, zBuffer, drawID, draw, offsetBit, drawOrderFrame }).first;
+        drawOrderPos[drawID] = pos;
+        return;
+    }
+
+    auto pos = it->second;
+    if (pos->drawPriority != drawPriority || pos->zBuffer != zBuffer)
+    {
+        // Sort keys changed, so move just this one
+        auto node = drawOrder.extract(pos);
+        node.value().drawPriority = drawPriority;
+        node.value().zBuffer = zBuffer;
+        pos = drawOrder.insert(std::move(node)).position;
+        it->second = pos;
+    }
+    pos->draw = draw;
+    pos->offsetMask |= offsetBit;
+    pos->lastFrame = drawOrderFrame;
+}
+
+void SceneRendererGLES::finishDrawOrder(const std::function<void(DrawableGLES *,unsigned int)> &callback)
+{
+    for (auto it = drawOrder.begin(); it != drawOrder.end(); )
+    {
+        const auto &entry = *it;
+        if (entry.offsetMask)
+        {
+            for (unsigned int off = 0; entry.offsetMask; off++, entry.offsetMask >>= 1)
+                if (entry.offsetMask & 1)
+                    callback(entry.draw, off);
+        }
+        else if (drawOrderFrame - entry.lastFrame > DrawOrderEvictFrames)
+        {
+            // Not worth walking past every frame, it'll go back in if it shows up again
+            drawOrderPos.erase(entry.drawID);
+            it = drawOrder.erase(it);
+            continue;
+        }
+        ++it;
+    }
+}
+
+void SceneRendererGLES::clearDrawOrder()
+{
+    drawOrder.clear();
+    drawOrderPos.clear();
+}
+
 bool SceneRendererGLES::hasChanges()
 {
     return SceneRenderer::hasChanges();
@@ -430,7 +532,10 @@ void SceneRendererGLES::render(TimeInterval duration)
         scene->processChanges(theView,this,now + duration / 2);
 
         if (UNLIKELY(reportStats))
+        {
             perfTimer.stopTiming("Scene processing");
+            perfTimer.addCount("Deferred changes", scene->getNumDeferredChanges());
+        }
         
         // Work through the available offset matrices (only 1 if we're not wrapping)
         const std::vector<Matrix4d> &offsetMats = baseFrameInfo.offsetMatrices;
@@ -442,10 +547,38 @@ void SceneRendererGLES::render(TimeInterval duration)
         std::vector<Matrix4d> mvpInvMats;
         std::vector<Matrix4f> mvpMats4f;
         std::vector<Matrix4f> mvpInvMats4f;
+        std::vector<Matrix4d> mvMats;
+        std::vector<Matrix4d> mvNormalMats;
         mvpMats.resize(offsetMats.size());
         mvpInvMats.resize(offsetMats.size());
         mvpMats4f.resize(offsetMats.size());
         mvpInvMats4f.resize(offsetMats.size());
+        mvMats.resize(offsetMats.size());
+        mvNormalMats.resize(offsetMats.size());
+
+        // Add a drawable to the list with the matrices for the given offset
+        const auto addToDrawList = [&](DrawableGLES *theDrawable,unsigned int off)
+        {
+            if (const Matrix4d *localMat = theDrawable->getMatrix())
+            {
+                Matrix4d newMvpMat = mvpMats[off] * (*localMat);
+                Matrix4d newMvMat = mvMats[off] * (*localMat);
+                Matrix4d newMvNormalMat = newMvMat.inverse().transpose();
+                drawList.emplace_back(theDrawable,newMvpMat,newMvMat,newMvNormalMat);
+            }
+            else
+            {
+                drawList.emplace_back(theDrawable,mvpMats[off],mvMats[off],mvNormalMats[off]);
+            }
+        };
+
+        // The draw order is kept from frame to frame, so we only sort what changed.
+        // It can only track so many offsets, past that we sort the whole list.
+        const bool sortLinesToEnd = (zBufferMode == zBufferOffDefault);
+        const bool useDrawOrder = (offsetMats.size() <= MaxDrawOrderOffsets);
+        if (useDrawOrder)
+            beginDrawOrder(sortLinesToEnd);
+
         for (unsigned int off=0;off<offsetMats.size();off++)
         {
             RendererFrameInfoGLES offFrameInfo(baseFrameInfo);
@@ -459,7 +592,8 @@ void SceneRendererGLES::render(TimeInterval duration)
             mvpInvMats4f[off] = Matrix4dToMatrix4f(mvpInvMats[off]);
             modelAndViewNormalMat4d = modelAndViewMat4d.inverse().transpose();
             modelAndViewNormalMat = Matrix4dToMatrix4f(modelAndViewNormalMat4d);
-            const Matrix4d &thisMvpMat = mvpMats[off];
+            mvMats[off] = modelAndViewMat4d;
+            mvNormalMats[off] = modelAndViewNormalMat4d;
             offFrameInfo.mvpMat = mvpMats4f[off];
             offFrameInfo.mvpInvMat = mvpInvMats4f[off];
             mvpNormalMat4f = Matrix4dToMatrix4f(mvpMats[off].inverse().transpose());
@@ -470,31 +604,31 @@ void SceneRendererGLES::render(TimeInterval duration)
             offFrameInfo.pvMat = Matrix4dToMatrix4f(pvMat);
             offFrameInfo.pvMat4d = pvMat;
 
-            const auto rawDrawables = scene->getDrawables();
-            drawList.reserve(rawDrawables.size());
+            // For flat maps we can skip the drawables well outside the view
+            Mbr visibleMbr;
+            const auto rawDrawables = calcVisibleLocalMbr(mvpInvMats[off], DrawableCullMargin, visibleMbr) ?
+                                        scene->getDrawables(visibleMbr) : scene->getDrawables();
+            if (UNLIKELY(reportStats))
+                perfTimer.addCount("Drawables considered", (int)rawDrawables.size());
+            drawList.reserve(drawList.size() + rawDrawables.size());
             for (auto *draw : rawDrawables)
             {
                 auto *theDrawable = dynamic_cast<DrawableGLES *>(draw);
                 if (theDrawable && theDrawable->isOn(&offFrameInfo))
                 {
-                    if (const Matrix4d *localMat = theDrawable->getMatrix())
-                    {
-                        Matrix4d newMvpMat = thisMvpMat * (*localMat);
-                        Matrix4d newMvMat = modelAndViewMat4d * (*localMat);
-                        Matrix4d newMvNormalMat = newMvMat.inverse().transpose();
-                        drawList.emplace_back(theDrawable,newMvpMat,newMvMat,newMvNormalMat);
-                    }
+                    if (useDrawOrder)
+                        markDrawOrder(theDrawable, off);
                     else
-                    {
-                        drawList.emplace_back(theDrawable,thisMvpMat,modelAndViewMat4d,modelAndViewNormalMat4d);
-                    }
+                        addToDrawList(theDrawable, off);
                 }
             }
         }
         
         // Sort the drawables (possibly multiple of the same if we have offset matrices)
-        const bool sortLinesToEnd = (zBufferMode == zBufferOffDefault);
-        std::sort(drawList.begin(),drawList.end(),DrawListSortStruct2(sortLinesToEnd,&baseFrameInfo));
+        if (useDrawOrder)
+            finishDrawOrder(addToDrawList);
+        else
+            std::sort(drawList.begin(),drawList.end(),DrawListSortStruct2(sortLinesToEnd,&baseFrameInfo));
         
         if (UNLIKELY(reportStats))
             perfTimer.startTiming("Calculation Shaders");
@@ -87,11 +87,12 @@ DisplaySolid::DisplaySolid(const QuadTreeIdentifier &nodeIdent,
         for (int iy=0;iy<numSamplesY;iy++)
         {
             const double yt = iy/(double)(numSamplesY-1);
-            const Point3d srcPt = (srcPtx1 - srcPtx0) * yt + srcPtx0;
-            const Point3d localPt = CoordSystemConvert3d(srcSystem, displaySystem, srcPt);
-            dispPoints.push_back(coordAdapter->localToDisplay(localPt));
+            dispPoints.push_back((srcPtx1 - srcPtx0) * yt + srcPtx0);
         }
     }
+    // Convert them all at once
+    CoordSystemConvert3d(srcSystem, displaySystem, dispPoints.data(), dispPoints.data(), dispPoints.size());
+    coordAdapter->localToDisplayBatch(dispPoints.data(), dispPoints.data(), dispPoints.size());
     
     // Build polygons out of those samples (in display space)
     bool boundingBoxValid = false;
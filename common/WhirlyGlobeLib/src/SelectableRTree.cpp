@@ -0,0 +1,103 @@
+/*
+ *  SelectableRTree.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "SelectableRTree.h"
+#import <algorithm>
+
+using namespace Eigen;
+
+namespace WhirlyKit
+{
+
+void SelectableRTree::insert(SimpleIdentity selectID,const BBox &bounds,float screenPad)
+{
+    tree.remove(selectID);
+    if (!bounds.isValid())
+        return;
+
+    tree.insert(selectID, Tree::Box { bounds.ll(), bounds.ur() }, Payload { screenPad, true });
+}
+
+void SelectableRTree::setEnable(SimpleIdentity selectID,bool enable)
+{
+    if (const auto *entry = tree.find(selectID))
+    {
+        if (entry->payload.enable != enable)
+        {
+            Payload payload = entry->payload;
+            payload.enable = enable;
+            tree.setPayload(selectID, payload);
+        }
+    }
+}
+
+bool SelectableRTree::nearTouch(const Tree::Box &box,float pad,const TouchQuery &query)
+{
+    const Point2d halfFrameSize(query.frameSize.x()/2.0,query.frameSize.y()/2.0);
+    const double dist = query.maxDist + pad;
+
+    for (const auto &fullMat : *query.fullMatrices)
+    {
+        const Matrix4d mat = *query.projMatrix * fullMat;
+
+        Point2d ll(std::numeric_limits<double>::max(),std::numeric_limits<double>::max());
+        Point2d ur(std::numeric_limits<double>::lowest(),std::numeric_limits<double>::lowest());
+        for (int corner = 0; corner < 8; corner++)
+        {
+            const Vector4d pt = mat * Vector4d((corner & 1) ? box.ur.x() : box.ll.x(),
+                                               (corner & 2) ? box.ur.y() : box.ll.y(),
+                                               (corner & 4) ? box.ur.z() : box.ll.z(),
+                                               1.0);
+            // Crosses the eye plane, so the projection is meaningless.  Keep it.
+            if (pt.w() <= 1e-12)
+            {
+                return true;
+            }
+            const Point2d screenPt(pt.x()/pt.w() * halfFrameSize.x() + halfFrameSize.x(),
+                                   query.frameSize.y() - (pt.y()/pt.w() * halfFrameSize.y() + halfFrameSize.y()));
+            ll = ll.cwiseMin(screenPt);
+            ur = ur.cwiseMax(screenPt);
+        }
+
+        if (query.touchPt.x() >= ll.x() - dist && query.touchPt.x() <= ur.x() + dist &&
+            query.touchPt.y() >= ll.y() - dist && query.touchPt.y() <= ur.y() + dist)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SelectableRTree::findNearTouch(const TouchQuery &query,std::vector<SimpleIdentity> &selectIDs) const
+{
+    const size_t start = selectIDs.size();
+    tree.search([&query](const Tree::Box &box,const Payload &payload)
+                {
+                    return payload.enable && nearTouch(box, payload.pad, query);
+                },
+                [&selectIDs](const Tree::Entry &entry)
+                {
+                    selectIDs.push_back(entry.ident);
+                });
+
+    // Same order as the selectable sets
+    std::sort(selectIDs.begin() + start, selectIDs.end());
+}
+
+}
@@ -99,6 +99,75 @@ SelectionManager::SelectedObject::SelectedObject::operator=(SelectedObject&& oth
     return *this;
 }
 
+// Display space bounds for the spatial indexes
+static BBox SelectableBounds(const RectSelectable3D &sel)
+{
+    BBox bbox;
+    for (const auto &pt : sel.pts)
+    {
+        bbox.addPoint(pt.cast<double>());
+    }
+    return bbox;
+}
+
+static BBox SelectableBounds(const RectSelectable2D &sel)
+{
+    BBox bbox;
+    bbox.addPoint(sel.center);
+    return bbox;
+}
+
+static BBox SelectableBounds(const PolytopeSelectable &sel)
+{
+    BBox bbox;
+    bbox.addPoint(sel.centerPt);
+    for (const auto &poly : sel.polys)
+    {
+        for (const auto &pt : poly)
+        {
+            bbox.addPoint(pt.cast<double>() + sel.centerPt);
+        }
+    }
+    return bbox;
+}
+
+static BBox SelectableBounds(const LinearSelectable &sel)
+{
+    BBox bbox;
+    bbox.addPoints(sel.pts);
+    return bbox;
+}
+
+// Screen space rectangles are sized on the screen, around the center
+static float SelectableScreenPad(const Selectable &)
+{
+    return 0.0f;
+}
+
+static float SelectableScreenPad(const RectSelectable2D &sel)
+{
+    float pad = 0.0f;
+    for (const auto &pt : sel.pts)
+    {
+        pad = std::max(pad, pt.norm());
+    }
+    return pad;
+}
+
+template <typename T>
+static void IndexSelectable(SelectableRTree &index,const std::pair<typename std::set<T>::iterator,bool> &res)
+{
+    if (res.second)
+    {
+        const T &sel = *res.first;
+        index.insert(sel.selectID, SelectableBounds(sel), SelectableScreenPad(sel));
+        if (!sel.enable)
+        {
+            index.setEnable(sel.selectID, false);
+        }
+    }
+}
+
 SelectionManager::SelectionManager(Scene *scene)
     : scene(scene)
 {
@@ -122,7 +191,7 @@ void SelectionManager::addSelectableRect(SimpleIdentity selectId,const Point3f *
     }
 
     std::lock_guard<std::mutex> guardLock(lock);
-    rect3Dselectables.insert(std::move(newSelect));
+    IndexSelectable<RectSelectable3D>(rect3DIndex, rect3Dselectables.insert(std::move(newSelect)));
 }
 
 // Add a rectangle (in 3-space) for selection, but only between the given visibilities
@@ -144,7 +213,7 @@ void SelectionManager::addSelectableRect(SimpleIdentity selectId,const Point3f *
     }
 
     std::lock_guard<std::mutex> guardLock(lock);
-    rect3Dselectables.insert(std::move(newSelect));
+    IndexSelectable<RectSelectable3D>(rect3DIndex, rect3Dselectables.insert(std::move(newSelect)));
 }
 
 /// Add a screen space rectangle (2D) for selection, between the given visibilities
@@ -170,7 +239,7 @@ void SelectionManager::addSelectableScreenRect(SimpleIdentity selectId,const Poi
     }
     
     std::lock_guard<std::mutex> guardLock(lock);
-    rect2Dselectables.insert(std::move(newSelect));
+    IndexSelectable<RectSelectable2D>(rect2DIndex, rect2Dselectables.insert(std::move(newSelect)));
 }
 
 /// Add a screen space rectangle (2D) for selection, between the given visibilities
@@ -243,7 +312,7 @@ void SelectionManager::addSelectableRectSolid(SimpleIdentity selectId,const Poin
     
     {
         std::lock_guard<std::mutex> guardLock(lock);
-        polytopeSelectables.insert(std::move(newSelect));
+        IndexSelectable<PolytopeSelectable>(polytopeIndex, polytopeSelectables.insert(std::move(newSelect)));
     }
 }
 
@@ -282,7 +351,7 @@ void SelectionManager::addSelectableRectSolid(SimpleIdentity selectId,const Poin
     }
     
     std::lock_guard<std::mutex> guardLock(lock);
-    polytopeSelectables.insert(std::move(newSelect));
+    IndexSelectable<PolytopeSelectable>(polytopeIndex, polytopeSelectables.insert(std::move(newSelect)));
 }
 
 void SelectionManager::addSelectableRectSolid(SimpleIdentity selectId,const BBox &bbox,
@@ -331,7 +400,7 @@ void SelectionManager::addPolytope(SimpleIdentity selectId,
     }
     
     std::lock_guard<std::mutex> guardLock(lock);
-    polytopeSelectables.insert(std::move(newSelect));
+    IndexSelectable<PolytopeSelectable>(polytopeIndex, polytopeSelectables.insert(std::move(newSelect)));
 }
 
 void SelectionManager::addPolytopeFromBox(SimpleIdentity selectId,const Point3d &ll,const Point3d &ur,
@@ -470,7 +539,7 @@ void SelectionManager::addSelectableLinear(SimpleIdentity selectId,const Point3d
     newSelect.pts = pts;
 
     std::lock_guard<std::mutex> guardLock(lock);
-    linearSelectables.insert(std::move(newSelect));
+    IndexSelectable<LinearSelectable>(linearIndex, linearSelectables.insert(std::move(newSelect)));
 }
 
 void SelectionManager::addSelectableBillboard(SimpleIdentity selectId,const Point3d &center,
@@ -506,6 +575,7 @@ void SelectionManager::enableSelectable(SimpleIdentity selectID,bool enable)
         rect3Dselectables.erase(it);
         sel.enable = enable;
         rect3Dselectables.insert(std::move(sel));
+        rect3DIndex.setEnable(selectID, enable);
     }
 
     const auto it2 = rect2Dselectables.find(RectSelectable2D(selectID));
@@ -515,6 +585,7 @@ void SelectionManager::enableSelectable(SimpleIdentity selectID,bool enable)
         rect2Dselectables.erase(it2);
         sel.enable = enable;
         rect2Dselectables.insert(std::move(sel));
+        rect2DIndex.setEnable(selectID, enable);
     }
 
     const auto itM = movingRect2Dselectables.find(MovingRectSelectable2D(selectID));
@@ -533,6 +604,7 @@ void SelectionManager::enableSelectable(SimpleIdentity selectID,bool enable)
         polytopeSelectables.erase(it3);
         sel.enable = enable;
         polytopeSelectables.insert(std::move(sel));
+        polytopeIndex.setEnable(selectID, enable);
     }
 
     const auto it3a = movingPolytopeSelectables.find(MovingPolytopeSelectable(selectID));
@@ -551,6 +623,7 @@ void SelectionManager::enableSelectable(SimpleIdentity selectID,bool enable)
         linearSelectables.erase(it5);
         sel.enable = enable;
         linearSelectables.insert(std::move(sel));
+        linearIndex.setEnable(selectID, enable);
     }
 
     const auto it4 = billboardSelectables.find(BillboardSelectable(selectID));
@@ -577,6 +650,7 @@ void SelectionManager::enableSelectables(const SimpleIDSet &selectIDs,bool enabl
             rect3Dselectables.erase(it);
             sel.enable = enable;
             rect3Dselectables.insert(std::move(sel));
+            rect3DIndex.setEnable(selectID, enable);
         }
 
         const auto it2 = rect2Dselectables.find(RectSelectable2D(selectID));
@@ -586,6 +660,7 @@ void SelectionManager::enableSelectables(const SimpleIDSet &selectIDs,bool enabl
             rect2Dselectables.erase(it2);
             sel.enable = enable;
             rect2Dselectables.insert(std::move(sel));
+            rect2DIndex.setEnable(selectID, enable);
         }
 
         const auto itM = movingRect2Dselectables.find(MovingRectSelectable2D(selectID));
@@ -604,6 +679,7 @@ void SelectionManager::enableSelectables(const SimpleIDSet &selectIDs,bool enabl
             polytopeSelectables.erase(it3);
             sel.enable = enable;
             polytopeSelectables.insert(std::move(sel));
+            polytopeIndex.setEnable(selectID, enable);
         }
 
         const auto it3a = movingPolytopeSelectables.find(MovingPolytopeSelectable(selectID));
@@ -622,6 +698,7 @@ void SelectionManager::enableSelectables(const SimpleIDSet &selectIDs,bool enabl
             linearSelectables.erase(it5);
             sel.enable = enable;
             linearSelectables.insert(std::move(sel));
+            linearIndex.setEnable(selectID, enable);
         }
 
         const auto it4 = billboardSelectables.find(BillboardSelectable(selectID));
@@ -640,6 +717,11 @@ void SelectionManager::removeSelectable(SimpleIdentity selectID)
 {
     std::lock_guard<std::mutex> guardLock(lock);
 
+    rect3DIndex.remove(selectID);
+    rect2DIndex.remove(selectID);
+    polytopeIndex.remove(selectID);
+    linearIndex.remove(selectID);
+
     const auto it = rect3Dselectables.find(RectSelectable3D(selectID));
     if (it != rect3Dselectables.end())
         rect3Dselectables.erase(it);
@@ -676,6 +758,11 @@ void SelectionManager::removeSelectables(const SimpleIDSet &selectIDs)
     
     for (const SimpleIdentity selectID : selectIDs)
     {
+        rect3DIndex.remove(selectID);
+        rect2DIndex.remove(selectID);
+        polytopeIndex.remove(selectID);
+        linearIndex.remove(selectID);
+
         const auto it = rect3Dselectables.find(RectSelectable3D(selectID));
         if (it != rect3Dselectables.end())
         {
@@ -730,11 +817,19 @@ void SelectionManager::removeSelectables(const SimpleIDSet &selectIDs)
 //        NSLog(@"Tried to delete selectable that doesn't exist.");
 }
 
-void SelectionManager::getScreenSpaceObjects(const PlacementInfo &pInfo,std::vector<ScreenSpaceObjectLocation> &screenPts,TimeInterval now)
+void SelectionManager::getScreenSpaceObjects(const PlacementInfo &pInfo,const SelectableRTree::TouchQuery &query,
+                                             std::vector<ScreenSpaceObjectLocation> &screenPts,TimeInterval now)
 {
-    screenPts.reserve(screenPts.size() + rect2Dselectables.size() + movingRect2Dselectables.size());
-    for (const auto &sel : rect2Dselectables)
+    std::vector<SimpleIdentity> nearIDs;
+    rect2DIndex.findNearTouch(query, nearIDs);
+
+    screenPts.reserve(screenPts.size() + nearIDs.size() + movingRect2Dselectables.size());
+    for (const SimpleIdentity nearID : nearIDs)
     {
+        const auto it = rect2Dselectables.find(RectSelectable2D(nearID));
+        if (it == rect2Dselectables.end())
+            continue;
+        const auto &sel = *it;
         if (sel.selectID != EmptyIdentity && sel.enable)
         {
             if (sel.minVis == DrawVisibleInvalid ||
@@ -933,12 +1028,21 @@ void SelectionManager::pickObjects(const Point2f &touchPt,float maxDist,const Vi
 
     const auto layoutManager = scene->getManager<LayoutManager>(kWKLayoutManager);
 
+    // Only the selectables which project near the touch need a closer look
+    SelectableRTree::TouchQuery query;
+    query.fullMatrices = &pInfo.viewState->fullMatrices;
+    query.projMatrix = &pInfo.viewState->projMatrix;
+    query.frameSize = pInfo.frameSizeScale;
+    query.touchPt = touchPt;
+    query.maxDist = maxDist;
+    std::vector<SimpleIdentity> nearIDs;
+
     std::lock_guard<std::mutex> guardLock(lock);
 
     // Figure out where the screen space objects are, both layout manager
     //  controlled and other
     std::vector<ScreenSpaceObjectLocation> ssObjs;
-    getScreenSpaceObjects(pInfo,ssObjs,now);
+    getScreenSpaceObjects(pInfo,query,ssObjs,now);
     if (layoutManager)
         layoutManager->getScreenSpaceObjects(pInfo,ssObjs);
     
@@ -1036,11 +1140,17 @@ void SelectionManager::pickObjects(const Point2f &touchPt,float maxDist,const Vi
 
     const Point3d eyePos = pInfo.globeViewState ? pInfo.globeViewState->eyePos : pInfo.mapViewState->eyePos;
 
-    if (!polytopeSelectables.empty())
+    nearIDs.clear();
+    polytopeIndex.findNearTouch(query, nearIDs);
+    if (!nearIDs.empty())
     {
         // Work through the axis aligned rectangular solids
-        for (const auto &sel : polytopeSelectables)
+        for (const SimpleIdentity nearID : nearIDs)
         {
+            const auto it = polytopeSelectables.find(PolytopeSelectable(nearID));
+            if (it == polytopeSelectables.end())
+                continue;
+            const auto &sel = *it;
             if (sel.selectID != EmptyIdentity && sel.enable)
             {
                 if (sel.minVis == DrawVisibleInvalid ||
@@ -1146,10 +1256,16 @@ void SelectionManager::pickObjects(const Point2f &touchPt,float maxDist,const Vi
         }
     }
     
-    if (!linearSelectables.empty())
+    nearIDs.clear();
+    linearIndex.findNearTouch(query, nearIDs);
+    if (!nearIDs.empty())
     {
-        for (const auto &sel : linearSelectables)
+        for (const SimpleIdentity nearID : nearIDs)
         {
+            const auto it = linearSelectables.find(LinearSelectable(nearID));
+            if (it == linearSelectables.end())
+                continue;
+            const auto &sel = *it;
             if (sel.selectID != EmptyIdentity && sel.enable)
             {
                 if (sel.minVis == DrawVisibleInvalid ||
@@ -1195,11 +1311,17 @@ void SelectionManager::pickObjects(const Point2f &touchPt,float maxDist,const Vi
         }
     }
     
-    if (!rect3Dselectables.empty())
+    nearIDs.clear();
+    rect3DIndex.findNearTouch(query, nearIDs);
+    if (!nearIDs.empty())
     {
         // Work through the 3D rectangles
-        for (const auto &sel : rect3Dselectables)
+        for (const SimpleIdentity nearID : nearIDs)
         {
+            const auto it = rect3Dselectables.find(RectSelectable3D(nearID));
+            if (it == rect3Dselectables.end())
+                continue;
+            const auto &sel = *it;
             if (sel.selectID != EmptyIdentity && sel.enable)
             {
                 if (sel.minVis == DrawVisibleInvalid ||
@@ -98,6 +98,7 @@ void ShapeDrawableBuilder::addPoints(Point3dVector &pts,RGBAColor color,Mbr mbr,
         const Point3d &pt = pts[jj];
         const Point3d localPt = coordAdapter->displayToLocal(pt);
         const Point3d norm = coordAdapter->normalForLocal(localPt);
+        drawMbr.addPoint(Point2d(localPt.x(),localPt.y()));
 
         // Add to drawable
         // Depending on the type, we do this differently
@@ -252,6 +253,9 @@ void ShapeDrawableBuilderTri::addTriangle(Point3f p0,Point3f n0,RGBAColor c0,Poi
 
     drawable->addTriangle(BasicDrawable::Triangle(0+baseVert,2+baseVert,1+baseVert));
     drawMbr.expand(shapeMbr);
+    addToMbr(p0.cast<double>());
+    addToMbr(p1.cast<double>());
+    addToMbr(p2.cast<double>());
 }
 
 // Add a triangle with normals and texture coords
@@ -286,6 +290,9 @@ void ShapeDrawableBuilderTri::addTriangle(const Point3d &p0,const Point3d &n0,RG
     
     drawable->addTriangle(BasicDrawable::Triangle(0+baseVert,2+baseVert,1+baseVert));
     drawMbr.expand(shapeMbr);
+    addToMbr(p0);
+    addToMbr(p1);
+    addToMbr(p2);
 }
 
 // Add a triangle with normals
@@ -317,6 +324,9 @@ void ShapeDrawableBuilderTri::addTriangle(Point3d p0,Point3d n0,RGBAColor c0,Poi
 
     drawable->addTriangle(BasicDrawable::Triangle(0+baseVert,2+baseVert,1+baseVert));
     drawMbr.expand(shapeMbr);
+    addToMbr(p0);
+    addToMbr(p1);
+    addToMbr(p2);
 }
 
 // Add a group of pre-build triangles
@@ -347,6 +357,17 @@ void ShapeDrawableBuilderTri::addTriangles(Point3dVector &pts,Point3dVector &nor
             tri.verts[jj] += baseVert;
         drawable->addTriangle(tri);
     }
+    for (const auto &pt : pts)
+        addToMbr(pt);
+}
+
+// The shapes' own MBRs don't always cover everything, so track the vertices too
+void ShapeDrawableBuilderTri::addToMbr(const Point3d &dispPt)
+{
+    if (clipCoords)
+        return;
+    const Point3d localPt = coordAdapter->displayToLocal(dispPt);
+    drawMbr.addPoint(Point2d(localPt.x(),localPt.y()));
 }
 
 // Add a convex outline, triangulated
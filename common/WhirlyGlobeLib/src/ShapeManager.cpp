@@ -487,11 +487,22 @@ void Extruded::makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuild
     // Now add in the transform for orientation
     shiftMat = shiftMat * transform;
     
-    // Note: Should make this bigger
+    double z = loc.z()*scale;
+    double theThickness = thickness*scale;
+
+    // Footprint of the whole outline, top and bottom, in local coordinates
     Mbr shapeMbr;
-    shapeMbr.addPoint(Point2f(loc.x(),loc.y()));
-    
-    
+    for (const Point2d &pt : pts)
+    {
+        for (const double ptZ : { z - theThickness/2.0, z + theThickness/2.0 })
+        {
+            const Vector4d pt4d = shiftMat * Vector4d(pt.x()*scale,pt.y()*scale,ptZ,1.0);
+            const Point3d ptDisp = Point3d(pt4d.x(),pt4d.y(),pt4d.z())/pt4d.w() + dispPt;
+            const Point3d ptLocal = coordAdapter->displayToLocal(ptDisp);
+            shapeMbr.addPoint(Point2d(ptLocal.x(),ptLocal.y()));
+        }
+    }
+
     // Run around the outline, building top and bottom lists
     VectorRing ring(pts.size());
     for (unsigned int ii=0;ii<pts.size();ii++)
@@ -503,8 +514,6 @@ void Extruded::makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuild
     TesselateRing(ring,trisRef);
     
     std::vector<Point3dVector> polytope;
-    double z = loc.z()*scale;
-    double theThickness = thickness*scale;
     for (unsigned int ii=0;ii<trisRef->tris.size();ii++)
     {
         VectorTriangles::Triangle &tri = trisRef->tris[ii];
@@ -29,6 +29,13 @@ SphericalMercatorCoordSystem::SphericalMercatorCoordSystem(float originLon)
 
 // Keep things right below/above the poles
 static constexpr double PoleLimit = DegToRad(85.05113);
+
+// Projected Y for a latitude, shared by the single and batch versions so they agree exactly
+static inline double MercatorY(double lat)
+{
+    lat = std::min(PoleLimit, std::max(-PoleLimit, lat));
+    return std::log((1.0 + std::sin(lat)) / std::cos(lat));
+}
     
 /// Convert from the local coordinate system to lat/lon
 GeoCoord SphericalMercatorCoordSystem::localToGeographic(Point3f pt) const
@@ -87,16 +94,12 @@ Point3d SphericalMercatorCoordSystem::geographicToLocal3d(GeoCoord geo) const
 
 Point3d SphericalMercatorCoordSystem::geographicToLocal(Point2d geo) const
 {
-    const double lat = std::min(PoleLimit, std::max(-PoleLimit, geo.y()));
-    return { geo.x() - originLon,
-             std::log((1.0 + std::sin(lat)) / std::cos(lat)),
-             0.0 };
+    return { geo.x() - originLon, MercatorY(geo.y()), 0.0 };
 }
 
 Point2d SphericalMercatorCoordSystem::geographicToLocal2(const Point2d &geo) const
 {
-    const double lat = std::min(PoleLimit, std::max(-PoleLimit, geo.y()));
-    return { geo.x() - originLon, std::log((1.0 + std::sin(lat)) / std::cos(lat)) };
+    return { geo.x() - originLon, MercatorY(geo.y()) };
 }
 
 /// Convert from the local coordinate system to geocentric
@@ -127,6 +130,36 @@ Point3d SphericalMercatorCoordSystem::geocentricToLocal(Point3d geocPt) const
     return {localPt.x(),localPt.y(),geoCoordPlus.z()};
 }
 
+void SphericalMercatorCoordSystem::localToGeographicBatch(const Point3d *in,Point2d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = Point2d(in[ii].x() + originLon, atan(sinh(in[ii].y())));
+}
+
+void SphericalMercatorCoordSystem::geographicToLocalBatch(const Point2d *in,Point3d *out,size_t num) const
+{
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = Point3d(in[ii].x() - originLon, MercatorY(in[ii].y()), 0.0);
+}
+
+void SphericalMercatorCoordSystem::localToGeocentricBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    // Unproject in place, then let Proj4 do the rest all at once
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = Point3d(in[ii].x() + originLon, atan(sinh(in[ii].y())), in[ii].z());
+    GeoCoordSystem::LocalToGeocentric(out,out,num);
+}
+
+void SphericalMercatorCoordSystem::geocentricToLocalBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    GeoCoordSystem::GeocentricToLocal(in,out,num);
+    for (size_t ii=0;ii<num;ii++)
+    {
+        Point3d &pt = out[ii];
+        pt = Point3d(pt.x() - originLon, MercatorY(pt.y()), pt.z());
+    }
+}
+
 bool SphericalMercatorCoordSystem::isSameAs(const CoordSystem *coordSys) const
 {
     const auto other = dynamic_cast<const SphericalMercatorCoordSystem *>(coordSys);
@@ -197,4 +230,23 @@ WhirlyKit::Point3d SphericalMercatorDisplayAdapter::displayToLocal(WhirlyKit::Po
     return localPt;
 }
 
+void SphericalMercatorDisplayAdapter::localToDisplayBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    const Point3d off(org.x(),org.y(),0.0);
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = in[ii] - off;
+}
+
+void SphericalMercatorDisplayAdapter::displayToLocalBatch(const Point3d *in,Point3d *out,size_t num) const
+{
+    const Point3d off(org.x(),org.y(),0.0);
+    for (size_t ii=0;ii<num;ii++)
+        out[ii] = in[ii] + off;
+}
+
+void SphericalMercatorDisplayAdapter::normalForLocalBatch(const Point3d *,Point3d *out,size_t num) const
+{
+    std::fill(out, out + num, Point3d(0,0,1));
+}
+
 }
@@ -19,40 +19,190 @@
 #import "StringIndexer.h"
 #import "SceneRenderer.h"
 #import "Identifiable.h"
+#import "WhirlyKitLog.h"
 
 namespace WhirlyKit {
 
 StringIndexer StringIndexer::instance;
 
-StringIndexer::StringIndexer() : stringToIdent(500)
+StringIndexer::Table::Table(size_t size)
 {
-    identToString.reserve(500);
+    // Keep it no more than half full
+    size_t cap = 64;
+    while (cap < size * 2)
+        cap *= 2;
+    slots.resize(cap, nullptr);
+    mask = cap - 1;
 }
 
-StringIdentity StringIndexer::getStringID(const std::string &str)
+const StringIndexer::Entry *StringIndexer::Table::find(std::string_view str,size_t hash) const
+{
+    for (size_t ii = hash & mask;; ii = (ii + 1) & mask)
+    {
+        const Entry *entry = slots[ii];
+        if (!entry)
+            return nullptr;
+        if (entry->hash == hash && entry->str == str)
+            return entry;
+    }
+}
+
+void StringIndexer::Table::add(const Entry *entry)
+{
+    size_t ii = entry->hash & mask;
+    while (slots[ii])
+        ii = (ii + 1) & mask;
+    slots[ii] = entry;
+    count++;
+}
+
+StringIndexer::StringIndexer() : table(nullptr), nextID(0)
+{
+    for (auto &block : idBlocks)
+        block.store(nullptr, std::memory_order_relaxed);
+    for (auto &slot : readers)
+        slot.count.store(0, std::memory_order_relaxed);
+
+    tables.push_back(std::make_unique<Table>(500));
+    table.store(tables.back().get(), std::memory_order_release);
+}
+
+StringIndexer::~StringIndexer()
+{
+    for (auto &block : idBlocks)
+        delete [] block.load(std::memory_order_relaxed);
+}
+
+StringIdentity StringIndexer::getStringID(std::string_view str)
 {
     StringIndexer &index = getInstance();
 
-    // todo: upgradeable shared mutex would be perfect here
-    std::lock_guard<std::mutex> lock(index.mutex);
+    const size_t hash = std::hash<std::string_view>()(str);
+
+    // Let publish() know we're in the table.  This and the table load pair up with
+    //  the table store and slot checks in publish(), so they have to be sequentially consistent.
+    // Entries are never freed, so we're done with the table once we have one.
+    std::atomic<int> &readCount = index.readers[readerSlot()].count;
+    readCount.fetch_add(1, std::memory_order_seq_cst);
+    const Entry *entry = index.table.load(std::memory_order_seq_cst)->find(str, hash);
+    readCount.fetch_sub(1, std::memory_order_release);
+
+    return entry ? entry->ident : index.addString(str, hash);
+}
+
+size_t StringIndexer::readerSlot()
+{
+    static std::atomic<size_t> nextSlot(0);
+    static thread_local const size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % NumReaderSlots;
+    return slot;
+}
+
+StringIdentity StringIndexer::addString(std::string_view str,size_t hash)
+{
+    // Anything not in the read-only table yet is in its shard, so that's the final word
+    Shard &shard = shards[(hash >> 8) % NumShards];
+    StringIdentity strID;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        const auto it = shard.entries.find(str);
+        if (it != shard.entries.end())
+            return it->second->ident;
 
-    const auto it = index.stringToIdent.find(str);
-    if (it != index.stringToIdent.end())
-        return it->second;
+        strID = nextID.fetch_add(1);
+        shard.storage.push_back(std::make_unique<Entry>(str, hash, strID));
+        const Entry *entry = shard.storage.back().get();
+        shard.entries[entry->str] = entry;
+        setEntryForID(entry);
+    }
+
+    // Rebuilding the table is linear, so only do it when enough new strings have piled up.
+    // This keeps it cheap overall and leaves at most a small fraction to the shards.
+    const Table *cur = table.load(std::memory_order_acquire);
+    if ((nextID.load() - cur->count) * 8 >= cur->count)
+    {
+        std::unique_lock<std::mutex> lock(publishMutex, std::try_to_lock);
+        if (lock.owns_lock())
+            publish();
+    }
 
-    const int strID = index.identToString.size();
-    index.identToString.push_back(str);
-    index.stringToIdent[str] = strID;
     return strID;
 }
 
-std::string StringIndexer::getString(StringIdentity strID)
+void StringIndexer::publish()
+{
+    const Table *cur = table.load(std::memory_order_acquire);
+    const StringIdentity num = nextID.load();
+    if (num == cur->count)
+        return;
+
+    auto newTable = std::make_unique<Table>(num);
+    for (StringIdentity ii = 0; ii < num; ii++)
+    {
+        // An ID may have been handed out but not filled in yet.  That one stays in its shard.
+        if (const Entry *entry = entryForID(ii))
+            newTable->add(entry);
+    }
+
+    table.store(newTable.get(), std::memory_order_seq_cst);
+    tables.push_back(std::move(newTable));
+
+    reclaim();
+}
+
+void StringIndexer::reclaim()
 {
-    const StringIndexer &index = getInstance();
+    if (tables.size() < 2)
+        return;
+
+    // A reader counts itself before it loads the table.  If it's still counted,
+    //  it may have the old one.  If it isn't, it either finished or will load
+    //  the new table when it starts.  Readers that keep showing up just put this
+    //  off until the next time.
+    for (const auto &slot : readers)
+        if (slot.count.load(std::memory_order_seq_cst) != 0)
+            return;
 
-    std::lock_guard<std::mutex> lock(index.mutex);
+    tables.erase(tables.begin(), tables.end() - 1);
+}
 
-    return (strID < index.identToString.size()) ? index.identToString[strID] : std::string();
+const StringIndexer::Entry *StringIndexer::entryForID(StringIdentity strID) const
+{
+    if (strID >= IDBlockSize * MaxIDBlocks)
+        return nullptr;
+    const auto *block = idBlocks[strID / IDBlockSize].load(std::memory_order_acquire);
+    return block ? block[strID % IDBlockSize].load(std::memory_order_acquire) : nullptr;
+}
+
+void StringIndexer::setEntryForID(const Entry *entry)
+{
+    const size_t which = entry->ident / IDBlockSize;
+    if (which >= MaxIDBlocks)
+    {
+        wkLogLevel(Error, "StringIndexer: Out of string IDs");
+        return;
+    }
+
+    auto *block = idBlocks[which].load(std::memory_order_acquire);
+    if (!block)
+    {
+        std::lock_guard<std::mutex> lock(idBlockMutex);
+        block = idBlocks[which].load(std::memory_order_acquire);
+        if (!block)
+        {
+            block = new std::atomic<const Entry *>[IDBlockSize];
+            for (size_t ii = 0; ii < IDBlockSize; ii++)
+                block[ii].store(nullptr, std::memory_order_relaxed);
+            idBlocks[which].store(block, std::memory_order_release);
+        }
+    }
+    block[entry->ident % IDBlockSize].store(entry, std::memory_order_release);
+}
+
+std::string StringIndexer::getString(StringIdentity strID)
+{
+    const Entry *entry = getInstance().entryForID(strID);
+    return entry ? entry->str : std::string();
 }
  
 // Note: This is from OpenGL.  Doesn't hold anymore on iOS
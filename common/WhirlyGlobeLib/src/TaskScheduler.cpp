@@ -0,0 +1,339 @@
+/*
+ *  TaskScheduler.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Copyright 2011-2022 mousebird consulting
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#import "TaskScheduler.h"
+#import "WhirlyKitLog.h"
+
+namespace WhirlyKit
+{
+
+// Which scheduler and worker the current thread belongs to, if any
+static thread_local const TaskScheduler *curScheduler = nullptr;
+static thread_local int curWorker = -1;
+static thread_local PlatformThreadInfo *curThreadInfo = nullptr;
+
+static std::mutex sharedSchedulerLock;
+static TaskSchedulerRef sharedScheduler;
+
+TaskScheduler::TaskScheduler(unsigned int numThreads,ThreadSetupFunc setupFunc,ThreadTeardownFunc teardownFunc) :
+    setupFunc(std::move(setupFunc)),
+    teardownFunc(std::move(teardownFunc))
+{
+    if (numThreads == 0)
+    {
+        // Leave a core for whoever is submitting
+        const unsigned int numCores = std::thread::hardware_concurrency();
+        numThreads = (numCores > 1) ? numCores - 1 : 1;
+    }
+
+    workers.reserve(numThreads);
+    for (unsigned int ii = 0; ii < numThreads; ii++)
+    {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    // Start them after they all exist, since they look at each other
+    for (unsigned int ii = 0; ii < numThreads; ii++)
+    {
+        workers[ii]->thread = std::thread(&TaskScheduler::workerMain, this, ii);
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> guardLock(sleepLock);
+        shuttingDown = true;
+    }
+    wake.notify_all();
+
+    for (auto &worker : workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+
+    // Anything left over is dropped, but the groups need to hear about it
+    for (int pri = 0; pri < NumPriorities; pri++)
+    {
+        for (auto &worker : workers)
+        {
+            for (auto &entry : worker->queues[pri])
+                finishTask(entry.group);
+            worker->queues[pri].clear();
+        }
+        for (auto &entry : sharedQueues[pri])
+            finishTask(entry.group);
+        sharedQueues[pri].clear();
+    }
+}
+
+bool TaskScheduler::isWorkerThread() const
+{
+    return curScheduler == this;
+}
+
+void TaskScheduler::submit(const TaskGroupRef &group,Task task,Priority priority)
+{
+    if (!task)
+        return;
+    if (group)
+        group->pending++;
+
+    const int pri = std::min(std::max((int)priority, 0), NumPriorities-1);
+    if (curScheduler == this && curWorker >= 0)
+    {
+        auto &worker = *workers[curWorker];
+        std::lock_guard<std::mutex> guardLock(worker.lock);
+        worker.queues[pri].push_back(Entry { std::move(task), group });
+    }
+    else
+    {
+        std::lock_guard<std::mutex> guardLock(sharedLock);
+        sharedQueues[pri].push_back(Entry { std::move(task), group });
+    }
+
+    // Bump the count under the sleep lock so a worker can't miss it on its way to sleep
+    {
+        std::lock_guard<std::mutex> guardLock(sleepLock);
+        numQueued++;
+    }
+    wake.notify_one();
+}
+
+bool TaskScheduler::findTask(int which,Entry &entry)
+{
+    if (numQueued <= 0)
+        return false;
+
+    const int numWorkers = (int)workers.size();
+    for (int pri = 0; pri < NumPriorities; pri++)
+    {
+        // Our own work first, newest first since it's likely still in cache
+        if (which >= 0)
+        {
+            auto &worker = *workers[which];
+            std::lock_guard<std::mutex> guardLock(worker.lock);
+            auto &queue = worker.queues[pri];
+            if (!queue.empty())
+            {
+                entry = std::move(queue.back());
+                queue.pop_back();
+                numQueued--;
+                return true;
+            }
+        }
+
+        // Then anything submitted from outside
+        {
+            std::lock_guard<std::mutex> guardLock(sharedLock);
+            auto &queue = sharedQueues[pri];
+            if (!queue.empty())
+            {
+                entry = std::move(queue.front());
+                queue.pop_front();
+                numQueued--;
+                return true;
+            }
+        }
+
+        // Then steal the oldest from the other workers
+        for (int ii = 1; ii <= numWorkers; ii++)
+        {
+            const int victim = (std::max(which, 0) + ii) % numWorkers;
+            if (victim == which)
+                continue;
+            auto &worker = *workers[victim];
+            std::lock_guard<std::mutex> guardLock(worker.lock);
+            auto &queue = worker.queues[pri];
+            if (!queue.empty())
+            {
+                entry = std::move(queue.front());
+                queue.pop_front();
+                numQueued--;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void TaskScheduler::finishTask(const TaskGroupRef &group)
+{
+    if (group && --group->pending == 0)
+    {
+        // Take the lock so a waiter can't check and then sleep through this
+        {
+            std::lock_guard<std::mutex> guardLock(group->lock);
+            group->done.notify_all();
+        }
+
+        // Workers waiting on a group sleep along with the idle ones
+        if (numWaiting > 0)
+        {
+            std::lock_guard<std::mutex> guardLock(sleepLock);
+            wake.notify_all();
+        }
+    }
+}
+
+void TaskScheduler::runTask(Entry &entry,PlatformThreadInfo *inst)
+{
+    if (!entry.group || !entry.group->cancelled)
+    {
+        try
+        {
+            entry.task(inst);
+        }
+        catch (const std::exception &ex)
+        {
+            wkLogLevel(Error, "TaskScheduler: Task failed: %s", ex.what());
+        }
+        catch (...)
+        {
+            wkLogLevel(Error, "TaskScheduler: Task failed");
+        }
+    }
+    // Let go of anything the task captured before telling the waiters
+    entry.task = nullptr;
+    finishTask(entry.group);
+    entry.group.reset();
+}
+
+void TaskScheduler::workerMain(unsigned int which)
+{
+    PlatformThreadInfo defaultInst;
+    PlatformThreadInfo *inst = setupFunc ? setupFunc() : nullptr;
+    if (!inst)
+        inst = &defaultInst;
+
+    curScheduler = this;
+    curWorker = (int)which;
+    curThreadInfo = inst;
+
+    while (true)
+    {
+        Entry entry;
+        if (findTask((int)which, entry))
+        {
+            runTask(entry, inst);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepLock);
+        wake.wait(lock, [this]{ return shuttingDown || numQueued > 0; });
+        if (shuttingDown)
+            break;
+    }
+
+    curScheduler = nullptr;
+    curWorker = -1;
+    curThreadInfo = nullptr;
+
+    if (teardownFunc && inst != &defaultInst)
+        teardownFunc(inst);
+}
+
+void TaskScheduler::wait(const TaskGroupRef &group)
+{
+    if (!group)
+        return;
+
+    if (curScheduler == this)
+    {
+        // Blocking a worker could leave nobody to run the tasks, so help out instead.
+        // If there's nothing to take, sleep until more work shows up or the group is done.
+        while (group->pending > 0)
+        {
+            Entry entry;
+            if (findTask(curWorker, entry))
+            {
+                runTask(entry, curThreadInfo);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepLock);
+            numWaiting++;
+            wake.wait(lock, [this,&group]{ return group->pending <= 0 || numQueued > 0; });
+            numWaiting--;
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(group->lock);
+    group->done.wait(lock, [&group]{ return group->pending <= 0; });
+}
+
+bool TaskScheduler::parallelFor(PlatformThreadInfo *inst,size_t count,size_t grainSize,
+                                const std::function<void(PlatformThreadInfo *,size_t,size_t)> &func,
+                                Priority priority,
+                                const TaskGroupRef &inGroup)
+{
+    if (count == 0)
+        return true;
+    grainSize = std::max(grainSize, (size_t)1);
+    const size_t numChunks = (count + grainSize - 1) / grainSize;
+
+    const TaskGroupRef group = inGroup ? inGroup : makeGroup();
+
+    // Everyone pulls chunks off the same counter, so it doesn't matter how many
+    //  helpers actually get to run.  The caller may well do it all itself.
+    auto nextChunk = std::make_shared<std::atomic<size_t>>(0);
+    const auto runChunks = [=,&func](PlatformThreadInfo *threadInst)
+    {
+        for (size_t chunk = (*nextChunk)++; chunk < numChunks && !group->cancelled; chunk = (*nextChunk)++)
+        {
+            const size_t begin = chunk * grainSize;
+            func(threadInst, begin, std::min(begin + grainSize, count));
+        }
+    };
+
+    const size_t numHelpers = std::min(numChunks - 1, workers.size());
+    for (size_t ii = 0; ii < numHelpers; ii++)
+    {
+        submit(group, runChunks, priority);
+    }
+
+    runChunks(inst);
+
+    // The helpers reference func, so we have to wait even if we're cancelled
+    wait(group);
+
+    return !group->cancelled;
+}
+
+TaskSchedulerRef TaskScheduler::getShared()
+{
+    std::lock_guard<std::mutex> guardLock(sharedSchedulerLock);
+    if (!sharedScheduler)
+        sharedScheduler = std::make_shared<TaskScheduler>();
+    return sharedScheduler;
+}
+
+void TaskScheduler::setShared(TaskSchedulerRef scheduler)
+{
+    TaskSchedulerRef oldScheduler;
+    {
+        std::lock_guard<std::mutex> guardLock(sharedSchedulerLock);
+        oldScheduler = std::move(sharedScheduler);
+        sharedScheduler = std::move(scheduler);
+    }
+    // The old one's threads get joined here, outside the lock, if this was the last reference
+}
+
+}
@@ -16,163 +16,419 @@
  *  limitations under the License.
  */
 
-#import <list>
+#import <algorithm>
+#import <cstdlib>
+#import <cstring>
 #include "glues.h"
 #import "Tesselator.h"
+#import "BasicDrawableBuilder.h"
+#import "WhirlyKitLog.h"
 
 using namespace Eigen;
 
 namespace WhirlyKit
 {
-    
-//static float PolyScale = 1e14;
-    
-typedef struct
+
+namespace
+{
+
+// Bump allocator for libtess.
+// Frees are ignored and everything goes at once when it's reset.
+class TessArena
+{
+public:
+    TessArena() = default;
+    TessArena(const TessArena &) = delete;
+    TessArena &operator=(const TessArena &) = delete;
+    ~TessArena() { freeChunks(); }
+
+    void *alloc(size_t size)
+    {
+        const size_t need = HeaderSize + align(size);
+        if (chunks.empty() || curOffset + need > chunks.back().size)
+        {
+            if (!addChunk(need))
+                return nullptr;
+        }
+        char *ptr = chunks.back().data + curOffset;
+        *(size_t *)ptr = size;
+        curOffset += need;
+        lastAlloc = ptr + HeaderSize;
+        return lastAlloc;
+    }
+
+    void *realloc(void *ptr,size_t size)
+    {
+        if (!ptr)
+            return alloc(size);
+        size_t &oldSize = *(size_t *)((char *)ptr - HeaderSize);
+
+        // The most recent allocation can grow in place, which is the usual case for the priority queue
+        if (ptr == lastAlloc)
+        {
+            const size_t start = (char *)ptr - chunks.back().data;
+            if (start + align(size) <= chunks.back().size)
+            {
+                curOffset = start + align(size);
+                oldSize = size;
+                return ptr;
+            }
+        }
+
+        void *newPtr = alloc(size);
+        if (newPtr)
+            memcpy(newPtr, ptr, std::min(oldSize, size));
+        return newPtr;
+    }
+
+    // Let go of everything allocated so far
+    void reset()
+    {
+        // If we had to spill into more chunks, replace them with one big enough for next time
+        if (chunks.size() > 1 || (!chunks.empty() && chunks.back().size > MaxRetained))
+        {
+            size_t total = 0;
+            for (const auto &chunk : chunks)
+                total += chunk.size;
+            freeChunks();
+            addChunk(std::min(total, MaxRetained));
+        }
+        curOffset = 0;
+        lastAlloc = nullptr;
+    }
+
+private:
+    struct Chunk
+    {
+        char *data;
+        size_t size;
+    };
+
+    // Keeps the size in front of each allocation, which also keeps them 16 byte aligned
+    static constexpr size_t HeaderSize = 16;
+    static constexpr size_t ChunkSize = 64 * 1024;
+    static constexpr size_t MaxRetained = 4 * 1024 * 1024;
+
+    static size_t align(size_t size) { return (size + 15) & ~(size_t)15; }
+
+    bool addChunk(size_t need)
+    {
+        const size_t size = std::max(need, ChunkSize);
+        char *data = (char *)malloc(size);
+        if (!data)
+            return false;
+        chunks.push_back(Chunk { data, size });
+        curOffset = 0;
+        return true;
+    }
+
+    void freeChunks()
+    {
+        for (const auto &chunk : chunks)
+            free(chunk.data);
+        chunks.clear();
+    }
+
+    std::vector<Chunk> chunks;
+    size_t curOffset = 0;
+    void *lastAlloc = nullptr;
+};
+
+static void *arenaAlloc(void *userData,unsigned int size)
 {
-    Point3fVector pts;
-    std::vector<std::vector<int>> tris;
-//    std::vector<int> vertIDs;
-    bool newVert;
-} TriangulationInfo;
+    return ((TessArena *)userData)->alloc(size);
+}
 
-static void* stdAlloc(void* userData, unsigned int size)
+static void *arenaRealloc(void *userData,void *ptr,unsigned int size)
 {
-  TESS_NOTUSED(userData);
-  return malloc(size);
+    return ((TessArena *)userData)->realloc(ptr, size);
 }
 
-static void stdFree(void* userData, void* ptr)
+static void arenaFree(void *,void *)
 {
-  TESS_NOTUSED(userData);
-  free(ptr);
 }
 
+// What we keep around between polygons, one per thread
+struct TessContext
+{
+    TessArena arena;
+    std::vector<TESSreal> coords;
+    std::vector<int> loopSizes;
+    std::vector<int> remap;
+
+    static TessContext &get()
+    {
+        static thread_local TessContext context;
+        return context;
+    }
+};
 
 static const float PolyScale2 = 1e6;
-    
+static const int VertexSize = 2;
+static const int VerticesPerTriangle = 3;
+
+// Runs libtess over one polygon out of the thread's arena.
+// The results are good until this goes away, so don't nest them on the same thread.
+class ScopedTess
+{
+public:
+    ScopedTess(TessContext &ctx,const std::vector<VectorRing> &loops) :
+        ctx(ctx)
+    {
+        if (loops.empty() || loops[0].empty())
+            return;
+        org = loops[0][0];
+
+        // Clean up the loops first, so we know how big the polygon is
+        auto &coords = ctx.coords;
+        coords.clear();
+        auto &loopSizes = ctx.loopSizes;
+        loopSizes.clear();
+        for (const auto &ring : loops)
+        {
+            const size_t start = coords.size();
+            for (unsigned int ii=0;ii<ring.size();ii++)
+            {
+                const Point2f &pt = ring[ii];
+                if (ii==ring.size()-1 && pt.x() == ring[0].x() && pt.y() == ring[0].y())
+                    continue;
+                if (ii > 0)
+                {
+                    // We're seeing a lot of duplicates
+                    const Point2f &prevPt = ring[ii-1];
+                    if (pt.x() == prevPt.x() && pt.y() == prevPt.y())
+                        continue;
+                }
+                coords.push_back(static_cast<TESSreal>((pt.x()-org.x())*PolyScale2));
+                coords.push_back(static_cast<TESSreal>((pt.y()-org.y())*PolyScale2));
+            }
+            loopSizes.push_back((int)(coords.size() - start) / VertexSize);
+        }
+        const int numInVerts = (int)coords.size() / VertexSize;
+        if (numInVerts < 3)
+            return;
+
+        // libtess threads the free list through a whole bucket when it makes one,
+        //  so the default sizes touch a few hundred KB even for a triangle.
+        const auto bucketSize = [numInVerts](int scale)
+            { return std::min(std::max(numInVerts * scale / 2, 16), 512); };
+        TESSalloc ma;
+        memset(&ma, 0, sizeof(ma));
+        ma.memalloc = arenaAlloc;
+        ma.memrealloc = arenaRealloc;
+        ma.memfree = arenaFree;
+        ma.userData = &ctx.arena;
+        ma.meshEdgeBucketSize = bucketSize(4);
+        ma.meshVertexBucketSize = bucketSize(2);
+        ma.meshFaceBucketSize = bucketSize(1);
+        ma.dictNodeBucketSize = bucketSize(1);
+        ma.regionBucketSize = bucketSize(1);
+        // The priority queue can grow now, so this is just headroom
+        ma.extraVertices = 32;
+
+        tess = tessNewTess(&ma);
+        if (!tess)
+            return;
+
+        const TESSreal *loopCoords = coords.data();
+        for (const int loopSize : loopSizes)
+        {
+            tessAddContour(tess, VertexSize, loopCoords, sizeof(TESSreal) * VertexSize, loopSize);
+            loopCoords += loopSize * VertexSize;
+        }
+        if (!tessTesselate(tess, TESS_WINDING_ODD, TESS_POLYGONS, VerticesPerTriangle, VertexSize, 0))
+            return;
+
+        verts = tessGetVertices(tess);
+        elems = tessGetElements(tess);
+        numVerts = tessGetVertexCount(tess);
+        numTris = tessGetElementCount(tess);
+    }
+
+    ~ScopedTess()
+    {
+        // Everything libtess allocated lives in the arena, so there's no need to tear it down piece by piece
+        ctx.arena.reset();
+    }
+
+    Point2f getVertex(int which) const
+    {
+        const TESSreal *pos = &verts[which * VertexSize];
+        return Point2f(pos[0]/PolyScale2+org.x(), pos[1]/PolyScale2+org.y());
+    }
+
+    // Triangles come out of libtess complete, but it's cheap to be sure
+    bool validTri(int which) const
+    {
+        const TESSindex *tri = &elems[which * VerticesPerTriangle];
+        return tri[0] != TESS_UNDEF && tri[1] != TESS_UNDEF && tri[2] != TESS_UNDEF;
+    }
+
+    TessContext &ctx;
+    TESStesselator *tess = nullptr;
+    Point2f org;
+    const TESSreal *verts = nullptr;
+    const TESSindex *elems = nullptr;
+    int numVerts = 0;
+    int numTris = 0;
+};
+
+}
+
 void TesselateRing(const WhirlyKit::VectorRing &ring,VectorTrianglesRef tris)
 {
     std::vector<VectorRing> rings(1);
     rings[0] = ring;
     TesselateLoops(rings, tris);
 }
-    
+
 void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris)
 {
-    if (loops.size() < 1)
+    const ScopedTess tess(TessContext::get(), loops);
+    if (tess.numTris <= 0)
         return;
-    if (loops[0].size() < 1)
-        return;
-    
-    static const int vertexSize = 2;
-    static const int stride = sizeof(TESSreal) * vertexSize;
-    static const int verticesPerTriangle = 3;
-  
-    TESSalloc ma;
-
-    ma.memalloc = stdAlloc;
-    ma.memfree = stdFree;
-    ma.extraVertices = 256; // realloc not provided, allow 256 extra vertic
-
-    TESStesselator *tess = tessNewTess(&ma);
-    
-    Point2f org = (loops[0])[0];
-    for (unsigned int li=0;li<loops.size();li++)
-    {
-        
-        const VectorRing &ring = loops[li];
-        std::vector<TESSreal> tessRing;
-        for (unsigned int ii=0;ii<ring.size();ii++)
+
+    // The vertices are shared, so they only go in once
+    const int startPoint = (int)tris->pts.size();
+    tris->pts.reserve(tris->pts.size() + tess.numVerts);
+    for (int ii = 0; ii < tess.numVerts; ii++)
+    {
+        const Point2f pt = tess.getVertex(ii);
+        tris->pts.emplace_back(pt.x(), pt.y(), 0.0f);
+    }
+
+    tris->tris.reserve(tris->tris.size() + tess.numTris);
+    for (int ii = 0; ii < tess.numTris; ii++)
+    {
+        if (!tess.validTri(ii))
+            continue;
+        const TESSindex *poly = &tess.elems[ii * VerticesPerTriangle];
+        VectorTriangles::Triangle triOut;
+        for (int jj = 0; jj < VerticesPerTriangle; jj++)
+            triOut.pts[jj] = poly[jj] + startPoint;
+        tris->tris.push_back(triOut);
+    }
+}
+
+static inline bool ValidTri(const VectorTriangles::Triangle &tri,int numPts)
+{
+    return tri.pts[0] >= 0 && tri.pts[0] < numPts &&
+           tri.pts[1] >= 0 && tri.pts[1] < numPts &&
+           tri.pts[2] >= 0 && tri.pts[2] < numPts;
+}
+
+int AddTrianglesToDrawables(const VectorTriangles &mesh,const TessDrawableFunc &drawFunc,const TessVertexFunc &vertFunc)
+{
+    const int numPts = (int)mesh.pts.size();
+    const int numTris = (int)mesh.tris.size();
+    if (numPts == 0 || numTris == 0)
+        return 0;
+
+    int numAdded = 0;
+    if (numPts <= (int)MaxDrawablePoints && numTris <= (int)MaxDrawableTriangles)
+    {
+        BasicDrawableBuilder *draw = drawFunc(numPts, numTris);
+        if (!draw)
+            return 0;
+
+        const int startPoint = (int)draw->getNumPoints();
+        for (int ii = 0; ii < numPts; ii++)
+            vertFunc(draw, ii);
+        for (const auto &tri : mesh.tris)
+        {
+            if (!ValidTri(tri, numPts))
+                continue;
+            draw->addTriangle(BasicDrawable::Triangle(tri.pts[0] + startPoint, tri.pts[2] + startPoint, tri.pts[1] + startPoint));
+            numAdded++;
+        }
+        return numAdded;
+    }
+
+    // Too big for one drawable, so go through in runs that are sure to fit
+    std::vector<int> &remap = TessContext::get().remap;
+    for (int start = 0; start < numTris; start += MaxDrawableTriangles)
+    {
+        const int end = std::min(start + (int)MaxDrawableTriangles, numTris);
+
+        // Number the vertices this run uses, in the order they show up
+        remap.assign(numPts, -1);
+        int runVerts = 0, runTris = 0;
+        for (int ii = start; ii < end; ii++)
         {
-            const Point2f &pt = ring[ii];
-            if (ii==ring.size()-1 && pt.x() == ring[0].x() && pt.y() == ring[0].y())
+            const auto &tri = mesh.tris[ii];
+            if (!ValidTri(tri, numPts))
                 continue;
-            if (ii > 0)
+            for (int jj = 0; jj < VerticesPerTriangle; jj++)
+                if (remap[tri.pts[jj]] < 0)
+                    remap[tri.pts[jj]] = runVerts++;
+            runTris++;
+        }
+        if (runTris == 0)
+            continue;
+
+        BasicDrawableBuilder *draw = drawFunc(runVerts, runTris);
+        if (!draw)
+            return numAdded;
+
+        // Add the vertices in the order we numbered them
+        const int startPoint = (int)draw->getNumPoints();
+        int nextVert = 0;
+        for (int ii = start; ii < end && nextVert < runVerts; ii++)
+        {
+            const auto &tri = mesh.tris[ii];
+            if (!ValidTri(tri, numPts))
+                continue;
+            for (int jj = 0; jj < VerticesPerTriangle; jj++)
             {
-                // We're seeing a lot of duplicates
-                const Point2f &prevPt = ring[ii-1];
-                if (pt.x() == prevPt.x() && pt.y() == prevPt.y())
-                    continue;
+                if (remap[tri.pts[jj]] == nextVert)
+                {
+                    vertFunc(draw, tri.pts[jj]);
+                    nextVert++;
+                }
             }
-            tessRing.push_back(static_cast<TESSreal>((pt.x()-org.x())*PolyScale2));
-            tessRing.push_back(static_cast<TESSreal>((pt.y()-org.y())*PolyScale2));
         }
-        tessAddContour(tess, vertexSize, tessRing.data(), stride, (int)tessRing.size() / vertexSize);
-        
+        for (int ii = start; ii < end; ii++)
+        {
+            const auto &tri = mesh.tris[ii];
+            if (!ValidTri(tri, numPts))
+                continue;
+            draw->addTriangle(BasicDrawable::Triangle(remap[tri.pts[0]] + startPoint,
+                                                      remap[tri.pts[2]] + startPoint,
+                                                      remap[tri.pts[1]] + startPoint));
+            numAdded++;
+        }
     }
-    tessTesselate(tess, TESS_WINDING_ODD, TESS_POLYGONS, verticesPerTriangle, vertexSize, 0);
- 
-    const float* verts = tessGetVertices(tess);
-    const int* elems = tessGetElements(tess);
-    const int nelems = tessGetElementCount(tess);
 
-    for (int i = 0; i < nelems; i++)
+    return numAdded;
+}
+
+int TesselateShapes(const ShapeSet &shapes,const TessLoopsFunc &loopsFunc,const TessShapeFunc &shapeFunc,
+                    const TessDrawableFunc &drawFunc,const TessVertexFunc &vertFunc)
+{
+    // One mesh, reused for each shape
+    const VectorTrianglesRef mesh = VectorTriangles::createTriangles();
+
+    int numTris = 0;
+    for (const auto &shape : shapes)
     {
-        const TESSindex* poly = &elems[i * verticesPerTriangle];
-        VectorTriangles::Triangle triOut;
-        int startPoint = (int)(tris->pts.size());
-        for (int j = 0; j < verticesPerTriangle; j++) {
-          if (poly[j] == TESS_UNDEF) {
-            break;
-          }
-          const TESSreal* pos = &verts[poly[j] * vertexSize];
-          tris->pts.push_back(Point3f(pos[0]/PolyScale2+org.x(), pos[1]/PolyScale2+org.y(), 0.0));
-          triOut.pts[j] = j + startPoint;
-        }
-        
-         //Make sure this is pointed up
-//                   Point3f pts[3];
-//                   for (unsigned int jj=0;jj<3;jj++)
-//                       pts[jj] = tris->pts[triOut.pts[jj]];
-//                   Vector3f norm = (pts[1]-pts[0]).cross(pts[2]-pts[0]);
-//                   if (norm.z() >= 0.0)
-//                   {
-//                       int tmp = triOut.pts[0];
-//                       triOut.pts[0] = triOut.pts[2];
-//                       triOut.pts[2] = tmp;
-//                   }
-       
-        tris->tris.push_back(triOut);
+        const auto areal = dynamic_cast<const VectorAreal *>(shape.get());
+        if (!areal)
+            continue;
+
+        mesh->pts.clear();
+        mesh->tris.clear();
+        if (loopsFunc)
+            loopsFunc(areal, mesh);
+        else
+            TesselateLoops(areal->loops, mesh);
+
+        if (mesh->tris.empty() || (shapeFunc && !shapeFunc(areal, *mesh)))
+            continue;
+
+        numTris += AddTrianglesToDrawables(*mesh, drawFunc, vertFunc);
     }
- 
-    tessDeleteTess(tess);
-    
-    // Convert to triangles
-    //    printf("  ");
-//    int startPoint = (int)(tris->pts.size());
-//    for (unsigned int ii=0;ii<tessInfo.pts.size();ii++)
-//    {
-//        Point3f &pt = tessInfo.pts[ii];
-//        tris->pts.push_back(Point3f(pt.x()/PolyScale2+org.x(),pt.y()/PolyScale2+org.y(),0.0));
-//    }
-//
-//    // Convert to triangles
-//    for (unsigned int ii=0;ii<tessInfo.tris.size();ii++)
-//    {
-//        std::vector<int> &tri = tessInfo.tris[ii];
-//        if (tri.size() == 3)
-//        {
-//            VectorTriangles::Triangle triOut;
-//            for (unsigned int jj=0;jj<3;jj++)
-//            {
-//                triOut.pts[jj] = tri[jj]+startPoint;
-//            }
-//
-//            // Make sure this is pointed up
-//            Point3f pts[3];
-//            for (unsigned int jj=0;jj<3;jj++)
-//                pts[jj] = tris->pts[triOut.pts[jj]];
-//            Vector3f norm = (pts[1]-pts[0]).cross(pts[2]-pts[0]);
-//            if (norm.z() >= 0.0)
-//            {
-//                int tmp = triOut.pts[0];
-//                triOut.pts[0] = triOut.pts[2];
-//                triOut.pts[2] = tmp;
-//            }
-//
-//            tris->tris.push_back(triOut);
-//        }
-//    }
+
+    return numTris;
 }
 
 }
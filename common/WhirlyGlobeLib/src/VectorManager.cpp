@@ -20,9 +20,11 @@
 #import "VectorManager.h"
 #import "WhirlyGeometry.h"
 #import "Tesselator.h"
+#import "Earcut.h"
 #import "GridClipper.h"
 #import "SharedAttributes.h"
 #import "Platform.h"
+#import "TaskScheduler.h"
 
 using namespace Eigen;
 using namespace WhirlyKit;
@@ -167,18 +169,37 @@ public:
             drawable->setColorExpression(vecInfo->colorExp);
             drawable->setOpacityExpression(vecInfo->opacityExp);
         }
-        drawMbr.addPoints(pts);
+        // Convert to real world coordinates all at once
+        geoPts.resize(pts.size());
+        localPts.resize(pts.size());
+        dispPts.resize(pts.size());
+        normPts.resize(pts.size());
+        for (unsigned int jj=0;jj<pts.size();jj++)
+        {
+            geoPts[jj] = Point2d(pts[jj].x()+geoCenter.x(),pts[jj].y()+geoCenter.y());
+        }
+        if (localCoords)
+        {
+            for (unsigned int jj=0;jj<pts.size();jj++)
+                localPts[jj] = Pad(geoPts[jj]);
+        }
+        else
+        {
+            coordSys->geographicToLocalBatch(geoPts.data(), localPts.data(), pts.size());
+        }
+        coordAdapter->localToDisplayBatch(localPts.data(), dispPts.data(), pts.size());
+        coordAdapter->normalForLocalBatch(localPts.data(), normPts.data(), pts.size());
+
+        // Bounds are in the scene's local coordinates, same as everyone else's
+        for (const auto &localPt : localPts)
+            drawMbr.addPoint(Point2f(localPt.x(),localPt.y()));
         
         Point3f prevPt,prevNorm,firstPt,firstNorm;
         for (unsigned int jj=0;jj<pts.size();jj++)
         {
-            // Convert to real world coordinates and offset from the globe
-            const Point2f &geoPt = pts[jj];
-            const Point2d geoCoordD(geoPt.x()+geoCenter.x(),geoPt.y()+geoCenter.y());
-            const Point3d localPt = localCoords ? Pad(geoCoordD) : coordSys->geographicToLocal(geoCoordD);
-            const Point3d norm3d = coordAdapter->normalForLocal(localPt);
-            const Point3f norm = norm3d.cast<float>();
-            const Point3d pt3d = coordAdapter->localToDisplay(localPt) - center;
+            // Offset from the globe
+            const Point3f norm = normPts[jj].cast<float>();
+            const Point3d pt3d = dispPts[jj] - center;
             const Point3f pt = pt3d.cast<float>();
             
             // Add to drawable
@@ -264,6 +285,13 @@ protected:
     Point2d geoCenter;
     bool centerValid;
     const GeometryType primType;
+    // Scratch space for converting points
+    Point2dVector geoPts;
+    Point3dVector localPts,dispPts,normPts;
+    std::vector<TexCoord> texCoords;
+    // For the mesh being added
+    RGBAColor ringColor;
+    bool doTexCoords = false;
 };
 
 /* Drawable Builder (Triangle version)
@@ -319,7 +347,7 @@ public:
         VectorTrianglesRef mesh(VectorTriangles::createTriangles());
         for (auto &inRing : inRings)
         {
-            TesselateRing(inRing,mesh);
+            tesselateRing(inRing,mesh);
         }
         
         addPoints(mesh, attrs, localCoords);
@@ -346,7 +374,7 @@ public:
         VectorTrianglesRef mesh(VectorTriangles::createTriangles());
         for (auto &ir : inRings)
         {
-            TesselateRing(ir,mesh);
+            tesselateRing(ir,mesh);
         }
         
         addPoints(mesh, attrs, localCoords);
@@ -354,6 +382,20 @@ public:
 
     // This version converts a ring into a mesh (chopping, tessellating, etc...)
     void addPoints(const std::vector<VectorRing> &rings,const MutableDictionaryRef &attrs, bool localCoords)
+    {
+        addPoints(tesselate(rings), attrs, localCoords);
+    }
+
+    // Chop and tessellate a set of loops.  This doesn't touch the builder, so it's safe from any thread.
+    VectorTrianglesRef tesselate(const std::vector<VectorRing> &rings) const
+    {
+        VectorTrianglesRef mesh(VectorTriangles::createTriangles());
+        tesselate(rings, mesh);
+        return mesh;
+    }
+
+    // Chop and tessellate a set of loops into the mesh
+    void tesselate(const std::vector<VectorRing> &rings,const VectorTrianglesRef &mesh) const
     {
         // Grid subdivision is done here
         std::vector<VectorRing> inRings;
@@ -371,10 +413,38 @@ public:
             inRings = rings;
         }
 
-        VectorTrianglesRef mesh(VectorTriangles::createTriangles());
-        TesselateLoops(inRings, mesh);
-        
-        addPoints(mesh, attrs, localCoords);
+        tesselateLoops(inRings, mesh);
+    }
+
+    // Most filled areals are small and simple, with a hole at most, and the ear clipper
+    //  is several times quicker than libtess for those.  It hands back anything it can't
+    //  triangulate cleanly.  Past a few thousand points libtess's sweep is the safer bet.
+    static constexpr size_t MaxEarcutRings = 2;
+    static constexpr size_t MaxEarcutPoints = 4096;
+
+    static void tesselateLoops(const std::vector<VectorRing> &loops,const VectorTrianglesRef &mesh)
+    {
+        if (!loops.empty() && loops.size() <= MaxEarcutRings)
+        {
+            size_t numPts = 0;
+            for (const auto &loop : loops)
+            {
+                numPts += loop.size();
+            }
+            if (numPts <= MaxEarcutPoints && EarcutLoops(loops, mesh))
+            {
+                return;
+            }
+        }
+        TesselateLoops(loops, mesh);
+    }
+
+    static void tesselateRing(const VectorRing &ring,const VectorTrianglesRef &mesh)
+    {
+        if (ring.size() > MaxEarcutPoints || !EarcutRing(ring, mesh))
+        {
+            TesselateRing(ring, mesh);
+        }
     }
 
     void addPoints(const VectorTrianglesRef &mesh, const MutableDictionaryRef &attrs, bool localCoords)
@@ -385,7 +455,28 @@ public:
     // If it's a mesh, we're assuming it's been fully processed (triangulated, chopped, and so on)
     void addPoints(const VectorTriangles &mesh, const MutableDictionaryRef &attrs, bool localCoords)
     {
-        const RGBAColor ringColor = attrs->getColor(MaplyColor, vecInfo->color);
+        setupMesh(mesh, attrs, localCoords);
+        AddTrianglesToDrawables(mesh,
+                                [this](int numPts,int numTris) { return drawableFor(numPts,numTris); },
+                                [this](BasicDrawableBuilder *draw,int which) { addVertex(draw,which); });
+    }
+
+    // Tesselate all the areals in a set straight into the drawables
+    void addAreals(const ShapeSet &shapes, bool localCoords)
+    {
+        TesselateShapes(shapes,
+                        [this](const VectorAreal *areal,const VectorTrianglesRef &mesh) { tesselate(areal->loops, mesh); },
+                        [this,localCoords](const VectorAreal *areal,const VectorTriangles &mesh)
+                            { setupMesh(mesh, areal->getAttrDictRef(), localCoords); return true; },
+                        [this](int numPts,int numTris) { return drawableFor(numPts,numTris); },
+                        [this](BasicDrawableBuilder *draw,int which) { addVertex(draw,which); });
+    }
+
+protected:
+    // Work out everything per-vertex for a mesh before its triangles go in
+    void setupMesh(const VectorTriangles &mesh, const MutableDictionaryRef &attrs, bool localCoords)
+    {
+        ringColor = attrs->getColor(MaplyColor, vecInfo->color);
 
         const CoordSystemDisplayAdapter *coordAdapter = scene->getCoordAdapter();
         const CoordSystem *coordSys = coordAdapter->getCoordSystem();
@@ -402,137 +493,143 @@ public:
             }
         }
         
-        for (size_t ir=0;ir<mesh.tris.size();ir++)
+        // Convert all the vertices at once, the triangles just look them up
+        const size_t numMeshPts = mesh.pts.size();
+        geoPts.resize(numMeshPts);
+        localPts.resize(numMeshPts);
+        dispPts.resize(numMeshPts);
+        normPts.resize(numMeshPts);
+        for (size_t ii=0;ii<numMeshPts;ii++)
         {
-            constexpr int triCount = 1;
-            constexpr int ptCount = 3;
-            Point2f pts[ptCount];
-            if (!mesh.getTriangle(ir, pts))
-            {
-                continue;
-            }
-
-            // Decide if we'll appending to an existing drawable or create a new one
-            if (!drawable ||
-                (drawable->getNumPoints()+ptCount > MaxDrawablePoints) ||
-                (drawable->getNumTris()+triCount > MaxDrawableTriangles))
-            {
-                // We're done with it, toss it to the scene
-                if (drawable)
-                    flush();
-                
-                drawable = sceneRender->makeBasicDrawableBuilder(vecBuilderName);
-                drawMbr.reset();
-                drawable->setType(Triangles);
-                vecInfo->setupBasicDrawable(drawable);
-                drawable->setColorExpression(vecInfo->colorExp);
-                drawable->setOpacityExpression(vecInfo->opacityExp);
-                drawable->setColor(ringColor);
-                if (vecInfo->texId != EmptyIdentity)
-                    drawable->setTexId(0, vecInfo->texId);
-            }
-            const unsigned baseVert = drawable->getNumPoints();
-            drawMbr.addPoints(pts);
-            
-            bool doTexCoords = vecInfo->texId != EmptyIdentity;
-            
-            // Need an origin for this type of texture coordinate projection
-            Point3d planeOrg(0,0,0);
-            Point3d planeUp(0,0,1);
-            Point3d planeX(1,0,0);
-            Point3d planeY(0,1,0);
-            if (vecInfo->texProj == TextureProjectionTanPlane)
-            {
-                const Point3d localPt = coordSys->geographicToLocal(centroid);
-                planeOrg = coordAdapter->localToDisplay(localPt);
-                planeUp = coordAdapter->normalForLocal(localPt);
-                planeX = Point3d(0,0,1).cross(planeUp);
-                planeY = planeUp.cross(planeX);
-                planeX.normalize();
-                planeY.normalize();
-            }
-            else if (vecInfo->texProj == TextureProjectionScreen)
-            {
-                // Don't need actual tex coordinates for screen space
-                doTexCoords = false;
-            }
-            
-            // Generate the textures coordinates
-            TexCoord texCoords[ptCount];
-            if (doTexCoords)
-            {
-                TexCoord minCoord(MAXFLOAT,MAXFLOAT);
-                int i = 0;
-                for (const auto &geoPt : pts)
-                {
-                    const Point2d geoCoordD = geoPt.cast<double>() + geoCenter;
+            geoPts[ii] = Point2d(mesh.pts[ii].x(),mesh.pts[ii].y()) + geoCenter;
+        }
+        if (localCoords)
+        {
+            for (size_t ii=0;ii<numMeshPts;ii++)
+                localPts[ii] = Pad(geoPts[ii]);
+        }
+        else
+        {
+            coordSys->geographicToLocalBatch(geoPts.data(), localPts.data(), numMeshPts);
+        }
+        coordAdapter->localToDisplayBatch(localPts.data(), dispPts.data(), numMeshPts);
+        coordAdapter->normalForLocalBatch(localPts.data(), normPts.data(), numMeshPts);
 
-                    auto &texCoord = texCoords[i++];
-                    switch (vecInfo->texProj)
-                    {
-                        case TextureProjectionTanPlane:
-                        {
-                            const Point3d locPt = localCoords ? Pad(geoCoordD) : coordSys->geographicToLocal(geoCoordD);
-                            const Point3d displayPt = coordAdapter->localToDisplay(locPt) - center;
-                            const Point3d dir = displayPt - planeOrg;
-                            const Point3d comp(dir.dot(planeX),dir.dot(planeY),dir.dot(planeUp));
-                            texCoord = Slice(comp).cast<float>().cwiseProduct(vecInfo->texScale);
-                            break;
-                        }
-                        case TextureProjectionNone:
-                        default:
-                            texCoord = (geoPt - centroid.cast<float>()).cwiseProduct(vecInfo->texScale);
-                            break;
-                    }
+        doTexCoords = vecInfo->texId != EmptyIdentity;
+        
+        // Need an origin for this type of texture coordinate projection
+        Point3d planeOrg(0,0,0);
+        Point3d planeUp(0,0,1);
+        Point3d planeX(1,0,0);
+        Point3d planeY(0,1,0);
+        if (vecInfo->texProj == TextureProjectionTanPlane)
+        {
+            const Point3d localPt = coordSys->geographicToLocal(centroid);
+            planeOrg = coordAdapter->localToDisplay(localPt);
+            planeUp = coordAdapter->normalForLocal(localPt);
+            planeX = Point3d(0,0,1).cross(planeUp);
+            planeY = planeUp.cross(planeX);
+            planeX.normalize();
+            planeY.normalize();
+        }
+        else if (vecInfo->texProj == TextureProjectionScreen)
+        {
+            // Don't need actual tex coordinates for screen space
+            doTexCoords = false;
+        }
+        if (!doTexCoords)
+        {
+            return;
+        }
 
-                    minCoord.x() = std::min(minCoord.x(),texCoord.x());
-                    minCoord.y() = std::min(minCoord.y(),texCoord.y());
-                }
-                // Essentially do a mod, since texture coordinates repeat
-                int minS = 0;
-                int minT = 0;
-                if (minCoord.x() != MAXFLOAT)
-                {
-                    minS = (int)std::floor(minCoord.x());
-                    minT = (int)std::floor(minCoord.y());
-                }
-                for (auto &texCoord : texCoords)
+        // Generate the textures coordinates
+        texCoords.resize(numMeshPts);
+        TexCoord minCoord(MAXFLOAT,MAXFLOAT);
+        for (size_t ii=0;ii<numMeshPts;ii++)
+        {
+            auto &texCoord = texCoords[ii];
+            switch (vecInfo->texProj)
+            {
+                case TextureProjectionTanPlane:
                 {
-                    texCoord.x() -= (float)minS;
-                    texCoord.y() -= (float)minT;
+                    const Point3d displayPt = dispPts[ii] - center;
+                    const Point3d dir = displayPt - planeOrg;
+                    const Point3d comp(dir.dot(planeX),dir.dot(planeY),dir.dot(planeUp));
+                    texCoord = Slice(comp).cast<float>().cwiseProduct(vecInfo->texScale);
+                    break;
                 }
+                case TextureProjectionNone:
+                default:
+                    texCoord = (Slice(mesh.pts[ii]) - centroid.cast<float>()).cwiseProduct(vecInfo->texScale);
+                    break;
             }
-            
-            // Add the points
-            for (unsigned int jj=0;jj<ptCount;jj++)
+
+            minCoord.x() = std::min(minCoord.x(),texCoord.x());
+            minCoord.y() = std::min(minCoord.y(),texCoord.y());
+        }
+        // Essentially do a mod, since texture coordinates repeat.
+        // The vertices are shared, so it's the same shift for the whole mesh.
+        if (minCoord.x() != MAXFLOAT)
+        {
+            const TexCoord shift((float)std::floor(minCoord.x()),(float)std::floor(minCoord.y()));
+            for (auto &texCoord : texCoords)
             {
-                // Convert to real world coordinates and offset from the globe
-                const Point2f &geoPt = pts[jj];
-                const Point2d geoCoordD = geoPt.cast<double>() + geoCenter;
-                const Point3d localPt = localCoords ? Pad(geoCoordD) : coordSys->geographicToLocal(geoCoordD);
-                const Point3d norm3d = coordAdapter->normalForLocal(localPt);
-                const Point3f norm(norm3d.x(),norm3d.y(),norm3d.z());
-                const Point3d pt3d = coordAdapter->localToDisplay(localPt) - center;
-                const Point3f pt = pt3d.cast<float>();
-                
-                drawable->addPoint(pt);
-                if (doColor)
-                {
-                    drawable->addColor(ringColor);
-                }
-                drawable->addNormal(norm);
-                if (doTexCoords)
-                {
-                    drawable->addTexCoord(0, texCoords[jj]);
-                }
+                texCoord -= shift;
             }
+        }
+    }
+
+    // Return a drawable with room for the given points and triangles
+    BasicDrawableBuilder *drawableFor(int numPts,int numTris)
+    {
+        // Decide if we'll appending to an existing drawable or create a new one
+        if (!drawable ||
+            (drawable->getNumPoints()+numPts > MaxDrawablePoints) ||
+            (drawable->getNumTris()+numTris > MaxDrawableTriangles))
+        {
+            // We're done with it, toss it to the scene
+            if (drawable)
+                flush();
             
-            // Add the triangles
-            // Note: Should be reusing vertex indices
-            drawable->addTriangle(BasicDrawable::Triangle(0+baseVert,2+baseVert,1+baseVert));
+            drawable = sceneRender->makeBasicDrawableBuilder(vecBuilderName);
+            drawMbr.reset();
+            drawable->setType(Triangles);
+            vecInfo->setupBasicDrawable(drawable);
+            drawable->setColorExpression(vecInfo->colorExp);
+            drawable->setOpacityExpression(vecInfo->opacityExp);
+            drawable->setColor(ringColor);
+            if (vecInfo->texId != EmptyIdentity)
+                drawable->setTexId(0, vecInfo->texId);
         }
+        return drawable.get();
     }
-    
+
+    // Add one of the mesh vertices set up in setupMesh
+    void addVertex(BasicDrawableBuilder *draw,int which)
+    {
+        // Bounds are in the scene's local coordinates, same as everyone else's
+        const Point3d &localPt = localPts[which];
+        drawMbr.addPoint(Point2f(localPt.x(),localPt.y()));
+
+        // Already in real world coordinates, just offset from the globe
+        const Point3d &norm3d = normPts[which];
+        const Point3f norm(norm3d.x(),norm3d.y(),norm3d.z());
+        const Point3d pt3d = dispPts[which] - center;
+        const Point3f pt = pt3d.cast<float>();
+        
+        draw->addPoint(pt);
+        if (doColor)
+        {
+            draw->addColor(ringColor);
+        }
+        draw->addNormal(norm);
+        if (doTexCoords)
+        {
+            draw->addTexCoord(0, texCoords[which]);
+        }
+    }
+
+public:
     void flush()
     {
         if (drawable)
@@ -580,6 +677,13 @@ protected:
     bool centerValid;
     BasicDrawableBuilderRef drawable;
     const VectorInfo *vecInfo;
+    // Scratch space for converting points
+    Point2dVector geoPts;
+    Point3dVector localPts,dispPts,normPts;
+    std::vector<TexCoord> texCoords;
+    // For the mesh being added
+    RGBAColor ringColor;
+    bool doTexCoords = false;
 };
 
 VectorManager::~VectorManager()
@@ -591,6 +695,42 @@ VectorManager::~VectorManager()
     vectorReps.clear();
 }
 
+// Tessellating filled areals is most of the work, so for a big batch we do it
+//  across the task scheduler up front and leave the drawable building to the caller.
+// The meshes come back in the same order as the shapes, empty for anything else.
+template <typename TShapes>
+static void TesselateAreals(const TShapes &shapes, const VectorDrawableBuilderTri &drawBuildTri,
+                            std::vector<VectorTrianglesRef> &meshes)
+{
+    constexpr size_t MinParallelShapes = 64;
+    constexpr size_t ShapesPerTask = 16;
+    if (shapes.size() < MinParallelShapes)
+    {
+        return;
+    }
+
+    std::vector<const VectorAreal *> areals;
+    areals.reserve(shapes.size());
+    for (const auto &shape : shapes)
+    {
+        areals.push_back(dynamic_cast<const VectorAreal *>(shape.get()));
+    }
+    meshes.resize(areals.size());
+
+    PlatformThreadInfo threadInfo;
+    TaskScheduler::getShared()->parallelFor(&threadInfo, areals.size(), ShapesPerTask,
+        [&](PlatformThreadInfo *, size_t begin, size_t end)
+        {
+            for (size_t ii = begin; ii < end; ii++)
+            {
+                if (areals[ii])
+                {
+                    meshes[ii] = drawBuildTri.tesselate(areals[ii]->loops);
+                }
+            }
+        });
+}
+
 // TODO: Get rid of this version
 SimpleIdentity VectorManager::addVectors(const ShapeSet *shapes, const VectorInfo &vecInfo, ChangeSet &changes)
 {
@@ -664,14 +804,28 @@ SimpleIdentity VectorManager::addVectors(const ShapeSet *shapes, const VectorInf
     VectorRing3d tempRing3d;
     constexpr auto localCoords = false;
 
+    // Big batches are tesselated in parallel up front, smaller ones go straight into the drawables
+    std::vector<VectorTrianglesRef> meshes;
+    if (vecInfo.filled)
+    {
+        TesselateAreals(*shapes, drawBuildTri, meshes);
+        if (meshes.empty())
+        {
+            drawBuildTri.addAreals(*shapes, localCoords);
+        }
+    }
+
+    size_t shapeIdx = 0;
     for (auto const &it : *shapes)
     {
+        const size_t thisShapeIdx = shapeIdx++;
         if (const auto theAreal = dynamic_cast<VectorAreal*>(it.get()))
         {
             if (vecInfo.filled)
             {
-                // Triangulate outside and loops
-                drawBuildTri.addPoints(theAreal->loops,theAreal->getAttrDictRef(), localCoords);
+                // Triangulate outside and loops, unless that's already done
+                if (thisShapeIdx < meshes.size() && meshes[thisShapeIdx])
+                    drawBuildTri.addPoints(meshes[thisShapeIdx],theAreal->getAttrDictRef(), localCoords);
                 continue;
             }
 
@@ -863,14 +1017,24 @@ SimpleIdentity VectorManager::addVectors(const std::vector<VectorShapeRef> &shap
     VectorRing newPts;
     VectorRing3d newPts3;
 
-    for (auto const &it : shapes)
+    std::vector<VectorTrianglesRef> meshes;
+    if (vecInfo.filled)
     {
+        TesselateAreals(shapes, drawBuildTri, meshes);
+    }
+
+    for (size_t shapeIdx = 0; shapeIdx < shapes.size(); shapeIdx++)
+    {
+        const auto &it = shapes[shapeIdx];
         if (const auto theAreal = dynamic_cast<const VectorAreal*>(it.get()))
         {
             if (vecInfo.filled)
             {
                 // Triangulate outside and loops
-                drawBuildTri.addPoints(theAreal->loops,theAreal->getAttrDictRef(),false);
+                if (shapeIdx < meshes.size() && meshes[shapeIdx])
+                    drawBuildTri.addPoints(meshes[shapeIdx],theAreal->getAttrDictRef(),false);
+                else
+                    drawBuildTri.addPoints(theAreal->loops,theAreal->getAttrDictRef(),false);
             }
             else
             {
@@ -578,68 +578,78 @@ static void expandBound(GeoMbr &bound, const Point2f &screenCoord,
     }
 }
 
-// See whether a given item's bounding rect overlaps the search area, which is defined by a point
-// and distance.  If the point is not within the item's bounding rect, approximate the distance
-// check by expanding the point into another bounding rect (once) using the specified distance and
-// compare that instead.
-static inline bool checkBounds(const Point2f &screenCoord, const GeoCoord &geoCoord,
-                               const GeoMbr &itemMbr, GeoMbr &searchMbr,
-                               Maply::MapViewState *mapView, WhirlyGlobe::GlobeViewState *globeView,
-                               const CoordSystemDisplayAdapter *adapter,
-                               const Eigen::Matrix4d &matrix,
-                               const Point2f &frameSize, float maxDistance)
-{
-    if (itemMbr.inside(geoCoord))
-    {
-        return true;
-    }
-    if (searchMbr.empty())
-    {
-        expandBound(searchMbr, screenCoord,
-                    mapView, globeView,
-                    adapter, matrix,
-                    frameSize, maxDistance);
-    }
-    return itemMbr.overlaps(searchMbr);
+// See whether a given item's bounding rect overlaps the search area around the point
+static inline bool checkBounds(const GeoMbr &itemMbr, const VectorNearQuery &query)
+{
+    const GeoCoord geoCoord(query.coord.x(),query.coord.y());
+    return itemMbr.inside(geoCoord) || itemMbr.overlaps(query.searchMbr);
 }
 
-bool VectorObject::pointNearLinear(const Point2d &coord,float maxDistance,
-                                   const ViewStateRef &viewState,const Point2f &frameSize) const
+VectorNearQuery::VectorNearQuery(const ViewStateRef &viewState,const Point2f &frameSize,
+                                 const Point2d &coord,float maxDistance) :
+    coord(coord),
+    maxDistance(maxDistance),
+    frameSize(frameSize),
+    onScreen(false),
+    screenPt(0.0,0.0),
+    viewState(viewState),
+    coordAdapter(viewState->coordAdapter),
+    globeView(dynamic_cast<WhirlyGlobe::GlobeViewState*>(viewState.get())),
+    mapView(dynamic_cast<Maply::MapViewState*>(viewState.get()))
 {
-    CoordSystemDisplayAdapter *coordAdapter = viewState->coordAdapter;
-   
-    const auto globeView = dynamic_cast<WhirlyGlobe::GlobeViewState*>(viewState.get());
-    const auto mapView = dynamic_cast<Maply::MapViewState*>(viewState.get());
-
     const Eigen::Matrix4d &modelTrans4d = viewState->modelMatrix;
     // Note: This won't work if there's more than one matrix
     const Eigen::Matrix4d &viewTrans4d = viewState->viewMatrices[0];
-    const Eigen::Matrix4d &modelAndViewMat4d = viewTrans4d * modelTrans4d;
-    const Eigen::Matrix4f &modelAndViewMat = Matrix4dToMatrix4f(modelAndViewMat4d);
-    const Eigen::Matrix4f &modelAndViewNormalMat = modelAndViewMat.inverse().transpose();
+    modelAndViewMat4d = viewTrans4d * modelTrans4d;
+    modelAndViewMat = Matrix4dToMatrix4f(modelAndViewMat4d);
+    modelAndViewNormalMat = modelAndViewMat.inverse().transpose();
     // Note: This is probably redundant
-    const Eigen::Matrix4d &modelMatFull = viewState->fullMatrices[0];
+    modelMatFull = viewState->fullMatrices[0];
+
+    const GeoCoord geoCoord(coord.x(),coord.y());
+    searchMbr = GeoMbr(geoCoord, geoCoord);
 
     // Point we're searching around
-    Point2d p;
-    if (!ScreenPointFromGeo(coord, globeView, mapView, coordAdapter, frameSize, modelAndViewMat,
-                            modelAndViewMat4d, modelMatFull, modelAndViewNormalMat, &p))
+    onScreen = ScreenPointFromGeo(coord, globeView, mapView, coordAdapter, frameSize, modelAndViewMat,
+                                  modelAndViewMat4d, modelMatFull, modelAndViewNormalMat, &screenPt);
+    if (onScreen)
     {
-        return false;
+        // Approximate the distance check by expanding the point into a geographic box
+        expandBound(searchMbr, screenPt.cast<float>(), mapView, globeView,
+                    coordAdapter, modelMatFull, frameSize, maxDistance);
     }
+}
 
-    const Point2f pf = p.cast<float>();
-    const GeoCoord geoCoord(coord.x(),coord.y());
-    GeoMbr searchMbr(geoCoord, geoCoord);
+bool VectorObject::pointNearLinear(const Point2d &coord,float maxDistance,
+                                   const ViewStateRef &viewState,const Point2f &frameSize) const
+{
+    return pointNearLinear(VectorNearQuery(viewState, frameSize, coord, maxDistance));
+}
+
+bool VectorObject::pointNearLinear(const VectorNearQuery &query) const
+{
+    if (!query.onScreen)
+    {
+        return false;
+    }
 
-    const double maxDistSq = (double)maxDistance * maxDistance;
+    const auto globeView = query.globeView;
+    const auto mapView = query.mapView;
+    const auto coordAdapter = query.coordAdapter;
+    const Point2f &frameSize = query.frameSize;
+    const Eigen::Matrix4f &modelAndViewMat = query.modelAndViewMat;
+    const Eigen::Matrix4d &modelAndViewMat4d = query.modelAndViewMat4d;
+    const Eigen::Matrix4d &modelMatFull = query.modelMatFull;
+    const Eigen::Matrix4f &modelAndViewNormalMat = query.modelAndViewNormalMat;
+    const Point2d &p = query.screenPt;
+
+    const double maxDistSq = (double)query.maxDistance * query.maxDistance;
     for (const auto &shape : shapes)
     {
         if (const auto linear = dynamic_cast<VectorLinear*>(shape.get()))
         {
             const GeoMbr geoMbr = linear->calcGeoMbr();
-            if (!checkBounds(pf, geoCoord, geoMbr, searchMbr, mapView, globeView,
-                             coordAdapter, modelMatFull, frameSize, maxDistance))
+            if (!checkBounds(geoMbr, query))
             {
                 continue;
             }
@@ -696,8 +706,7 @@ bool VectorObject::pointNearLinear(const Point2d &coord,float maxDistance,
         else if (const auto linear3d = dynamic_cast<VectorLinear3d*>(shape.get()))
         {
             const GeoMbr geoMbr = linear3d->calcGeoMbr();
-            if (!checkBounds(pf, geoCoord, geoMbr, searchMbr, mapView, globeView,
-                             coordAdapter, modelMatFull, frameSize, maxDistance))
+            if (!checkBounds(geoMbr, query))
             {
                 continue;
             }
@@ -958,45 +967,82 @@ std::string VectorObject::log() const
     return outStr;
 }
     
-void VectorObject::reproject(CoordSystem *inSystem,double scale,CoordSystem *outSystem)
+void VectorObject::reproject(CoordSystem *inSystem,double scale,CoordSystem *outSystem,double maxError)
 {
+    // With some slop allowed, interpolate over the whole area rather than converting every point
+    std::unique_ptr<CoordSystemConvertGrid> grid;
+    if (maxError > 0.0 && !inSystem->isSameAs(outSystem))
+    {
+        MbrD mbr;
+        for (const auto &shapeRef : shapes)
+        {
+            const auto shape = shapeRef.get();
+            if (const auto points = dynamic_cast<VectorPoints*>(shape))
+                for (const auto &pt : points->pts) mbr.addPoint(Point2d(pt.x()*scale,pt.y()*scale));
+            else if (const auto lin = dynamic_cast<VectorLinear*>(shape))
+                for (const auto &pt : lin->pts) mbr.addPoint(Point2d(pt.x()*scale,pt.y()*scale));
+            else if (const auto lin3d = dynamic_cast<VectorLinear3d*>(shape))
+                for (const auto &pt : lin3d->pts) mbr.addPoint(Point2d(pt.x()*scale,pt.y()*scale));
+            else if (const auto ar = dynamic_cast<VectorAreal*>(shape))
+                for (const auto &loop : ar->loops)
+                    for (const auto &pt : loop) mbr.addPoint(Point2d(pt.x()*scale,pt.y()*scale));
+            else if (const auto tri = dynamic_cast<VectorTriangles*>(shape))
+                for (const auto &pt : tri->pts) mbr.addPoint(Point2d(pt.x()*scale,pt.y()*scale));
+        }
+        grid = std::make_unique<CoordSystemConvertGrid>(inSystem, outSystem, mbr, maxError);
+        if (!grid->isValid())
+            grid.reset();
+    }
+
+    // Each run of points is converted in one go
+    Point3dVector convPts;
+    const auto convertRun = [&](Point3d *pts,size_t num)
+    {
+        if (grid)
+            grid->convert(pts, pts, num);
+        else
+            CoordSystemConvert3d(inSystem, outSystem, pts, pts, num);
+    };
+    const auto convert = [&]()
+    {
+        convertRun(convPts.data(), convPts.size());
+    };
+    const auto convert2f = [&](Point2fVector &pts,double outScale)
+    {
+        convPts.resize(pts.size());
+        for (size_t ii=0;ii<pts.size();ii++)
+            convPts[ii] = Point3d(pts[ii].x()*scale,pts[ii].y()*scale,0.0);
+        convert();
+        for (size_t ii=0;ii<pts.size();ii++)
+            pts[ii] = Point2f(convPts[ii].x()*outScale,convPts[ii].y()*outScale);
+    };
+
     for (const auto &shapeRef : shapes)
     {
         const auto shape = shapeRef.get();
         if (const auto points = dynamic_cast<VectorPoints*>(shape))
         {
-            for (Point2f &pt : points->pts)
-            {
-                const Point3f outPt = CoordSystemConvert(inSystem, outSystem, Point3f(pt.x()*scale,pt.y()*scale,0.0));
-                pt.x() = outPt.x();  pt.y() = outPt.y();
-            }
+            convert2f(points->pts, 1.0);
             points->calcGeoMbr();
         } else if (const auto lin = dynamic_cast<VectorLinear*>(shape)) {
-            for (Point2f &pt : lin->pts)
-            {
-                const Point3f outPt = CoordSystemConvert(inSystem, outSystem, Point3f(pt.x()*scale,pt.y()*scale,0.0));
-                pt.x() = outPt.x();  pt.y() = outPt.y();
-            }
+            convert2f(lin->pts, 1.0);
             lin->calcGeoMbr();
         } else if (const auto lin3d = dynamic_cast<VectorLinear3d*>(shape)) {
             for (Point3d &pt : lin3d->pts)
-            {
-                const Point3d outPt = CoordSystemConvert3d(inSystem, outSystem, pt * scale);
-                pt = outPt;
-            }
+                pt *= scale;
+            convertRun(lin3d->pts.data(), lin3d->pts.size());
             lin3d->calcGeoMbr();
         } else if (const auto ar = dynamic_cast<VectorAreal*>(shape)) {
             for (auto &loop : ar->loops)
-                for (Point2f &pt : loop) {
-                    const Point3f outPt = CoordSystemConvert(inSystem, outSystem, Point3f(pt.x()*scale,pt.y()*scale,0.0));
-                    pt.x() = outPt.x() * 180 / M_PI;  pt.y() = outPt.y() * 180 / M_PI;
-                }
+                convert2f(loop, 180 / M_PI);
             ar->calcGeoMbr();
         } else if (const auto tri = dynamic_cast<VectorTriangles*>(shape)) {
-            for (Point3f &pt : tri->pts)
-            {
-                pt = CoordSystemConvert(inSystem, outSystem, Point3f(pt.x()*scale,pt.y()*scale,pt.z()));
-            }
+            convPts.resize(tri->pts.size());
+            for (size_t ii=0;ii<tri->pts.size();ii++)
+                convPts[ii] = Point3d(tri->pts[ii].x()*scale,tri->pts[ii].y()*scale,tri->pts[ii].z());
+            convert();
+            for (size_t ii=0;ii<tri->pts.size();ii++)
+                tri->pts[ii] = convPts[ii].cast<float>();
             tri->calcGeoMbr();
         }
     }
@@ -23,10 +23,12 @@
 #import "VectorObject.h"
 #import "WhirlyKitLog.h"
 #import "DictionaryC.h"
+#import "TaskScheduler.h"
 
 #import "vector_tile.pb.h"
 #import "maply_pb_decode.h"
 
+#import <algorithm>
 #import <vector>
 #import <string>
 
@@ -109,8 +111,37 @@ VectorTilePBFParser::VectorTilePBFParser(
 {
 }
 
-bool VectorTilePBFParser::parse(const uint8_t* data, size_t length)
+VectorTilePBFParser::VectorTilePBFParser(const VectorTilePBFParser &parent,
+                                         PlatformThreadInfo *styleInst,
+                                         std::map<SimpleIdentity, std::vector<VectorObjectRef>*>& vecObjByStyle,
+                                         std::vector<VectorObjectRef>* keepVectors)
+    : _tileData      (parent._tileData)
+    , _styleDelegate (parent._styleDelegate)
+    , _styleInst     (styleInst)
+    , _vecObjByStyle (vecObjByStyle)
+    , _uuidName      (parent._uuidName)
+    , _uuidValues    (parent._uuidValues)
+    , _localCoords   (parent._localCoords)
+    , _parseAll      (parent._parseAll)
+    , _keepVectors   (keepVectors)
+    , _checkCancelled(parent._checkCancelled)
+    , _bbox          (parent._bbox)
+    , _bboxWidth     (parent._bboxWidth)
+    , _bboxHeight    (parent._bboxHeight)
+    , _sx            (parent._sx)
+    , _sy            (parent._sy)
+    , _tileOriginX   (parent._tileOriginX)
+    , _tileOriginY   (parent._tileOriginY)
+{
+}
+
+bool VectorTilePBFParser::parse(const uint8_t* data, size_t length, TaskScheduler *scheduler)
 {
+    if (scheduler && scheduler->getNumThreads() > 0 && _styleDelegate->supportsParallelParsing())
+    {
+        return parseParallel(data, length, *scheduler);
+    }
+
     _vector_tile_Tile tile = {
         /* layer     */ { layerDecode, this },
         /*extensions */ nullptr,
@@ -126,6 +157,189 @@ bool VectorTilePBFParser::parse(const uint8_t* data, size_t length)
     return true;
 }
 
+bool VectorTilePBFParser::parseParallel(const uint8_t* data, size_t length, TaskScheduler &scheduler)
+{
+    // First pass just finds the layers, skipping over their contents
+    std::vector<LayerRange> ranges;
+    ranges.reserve(32);
+
+    _vector_tile_Tile tile = {
+        /* layer     */ { layerScan, &ranges },
+        /*extensions */ nullptr,
+    };
+
+    auto stream = pb_istream_from_buffer(data, length);
+    if (!pb_decode(&stream, vector_tile_Tile_fields, &tile))
+    {
+        _parseError = stream.errmsg ? stream.errmsg : std::string();
+        return false;
+    }
+
+    // Decide which layers we want here, so the layer order is the same as a serial parse
+    std::vector<std::string> layerNames(ranges.size());
+    std::vector<size_t> layers;
+    layers.reserve(ranges.size());
+    for (size_t ii = 0; ii < ranges.size(); ii++)
+    {
+        if (displayLayer(ranges[ii].name, ranges[ii].extent, layerNames[ii]))
+        {
+            layers.push_back(ii);
+        }
+        else
+        {
+            _skippedLayerCount += 1;
+        }
+    }
+
+    // Start the biggest layers first, they're the ones that hold everything up
+    std::vector<size_t> runOrder(layers.size());
+    for (size_t ii = 0; ii < runOrder.size(); ii++)
+    {
+        runOrder[ii] = ii;
+    }
+    std::stable_sort(runOrder.begin(), runOrder.end(), [&](size_t a, size_t b) {
+        return ranges[layers[a]].length > ranges[layers[b]].length;
+    });
+
+    // Each layer gets a parser of its own to collect results
+    std::vector<std::map<SimpleIdentity, std::vector<VectorObjectRef>*>> layerVecObjs(layers.size());
+    std::vector<std::vector<VectorObjectRef>> layerKeepVecs(_keepVectors ? layers.size() : 0);
+    std::vector<std::unique_ptr<VectorTilePBFParser>> layerParsers(layers.size());
+
+    const auto group = scheduler.makeGroup();
+    scheduler.parallelFor(_styleInst, runOrder.size(), 1,
+                          [&](PlatformThreadInfo *threadInst, size_t begin, size_t end)
+    {
+        for (size_t ii = begin; ii < end; ii++)
+        {
+            const size_t which = runOrder[ii];
+            const LayerRange &range = ranges[layers[which]];
+            auto &parser = layerParsers[which];
+            parser.reset(new VectorTilePBFParser(*this, threadInst, layerVecObjs[which],
+                                                 _keepVectors ? &layerKeepVecs[which] : nullptr));
+
+            bool ok = false;
+            if (parser->_checkCancelled(threadInst))
+            {
+                parser->_wasCancelled = true;
+            }
+            else
+            {
+                std::string_view name;
+                uint32_t extent = 0;
+                auto layerStream = pb_istream_from_buffer(range.data, range.length);
+                ok = parser->decodeLayer(&layerStream, name, extent);
+                if (!ok)
+                {
+                    parser->_parseError = layerStream.errmsg ? layerStream.errmsg : std::string();
+                }
+                else
+                {
+                    ok = parser->processFeatures(layerNames[layers[which]], extent, (int)which);
+                }
+            }
+            if (!ok)
+            {
+                // No point in doing the rest
+                group->cancel();
+            }
+        }
+    }, TaskScheduler::PriorityNormal, group);
+
+    // Merge in the original layer order, so the output doesn't depend on timing
+    bool ok = !group->isCancelled();
+    for (auto &parser : layerParsers)
+    {
+        if (!parser)
+        {
+            continue;
+        }
+        if (ok)
+        {
+            mergeFrom(*parser);
+        }
+        else
+        {
+            _wasCancelled |= parser->_wasCancelled;
+            if (_parseError.empty())
+            {
+                _parseError = parser->_parseError;
+            }
+        }
+    }
+    if (!ok)
+    {
+        if (!_wasCancelled && _parseError.empty())
+        {
+            _parseError = "layer decode failed";
+        }
+        for (auto &vecObjs : layerVecObjs)
+        {
+            for (auto &it : vecObjs)
+            {
+                delete it.second;
+            }
+        }
+    }
+    _layerCount = ok ? (unsigned)layers.size() : 0;
+
+    return ok;
+}
+
+void VectorTilePBFParser::mergeFrom(VectorTilePBFParser &that)
+{
+    if (_keepVectors && that._keepVectors)
+    {
+        _keepVectors->insert(_keepVectors->end(), that._keepVectors->begin(), that._keepVectors->end());
+    }
+
+    for (auto &it : that._vecObjByStyle)
+    {
+        const auto ip = _vecObjByStyle.insert(std::make_pair(it.first, it.second));
+        if (!ip.second)
+        {
+            auto &vecs = *ip.first->second;
+            vecs.insert(vecs.end(), it.second->begin(), it.second->end());
+            delete it.second;
+        }
+    }
+    that._vecObjByStyle.clear();
+
+    _featureCount += that._featureCount;
+    _skippedFeatureCount += that._skippedFeatureCount;
+    _skippedLayerCount += that._skippedLayerCount;
+    _unknownValueTypes += that._unknownValueTypes;
+    _badAttributes += that._badAttributes;
+    _unknownCommands += that._unknownCommands;
+    _unknownGeomTypes += that._unknownGeomTypes;
+    _parseErrors += that._parseErrors;
+}
+
+// Record where a layer is, decoding only its name and extent
+bool VectorTilePBFParser::layerScan(pb_istream_t *stream, const pb_field_iter_t *field, void **arg)
+{
+    auto &ranges = **(std::vector<LayerRange>**)arg;
+
+    LayerRange range = { (const uint8_t *)stream->state, stream->bytes_left, std::string_view(), 0 };
+
+    vector_tile_Tile_Layer layer = _defaultLayer;
+    layer.name.arg = &range.name;
+    layer.features.funcs.decode = nullptr;
+    layer.keys.funcs.decode = nullptr;
+    layer.values.funcs.decode = nullptr;
+
+    if (!pb_decode(stream, vector_tile_Tile_Layer_fields, &layer))
+    {
+        return false;
+    }
+
+    // When `has_extent` is false, nanopb sets the default in `extent`
+    range.extent = layer.extent;
+    ranges.push_back(range);
+
+    return true;
+}
+
 // Tile contains a collection of Layers
 bool VectorTilePBFParser::layerDecode(pb_istream_t *stream, const pb_field_iter_t *field, void **arg)
 {
@@ -140,10 +354,34 @@ bool VectorTilePBFParser::layerDecode(pb_istream_t *stream, const pb_field_iter_
         return false;
     }
 
-    vector_tile_Tile_Layer layer = _defaultLayer;
     std::string_view layerNameView;
+    uint32_t extent = 0;
+    if (!decodeLayer(stream, layerNameView, extent))
+    {
+        return false;
+    }
+
+    std::string layerName;
+    if (!displayLayer(layerNameView, extent, layerName))
+    {
+        _skippedLayerCount += 1;
+        return true;
+    }
+
+    if (!processFeatures(layerName, extent, (int)_layerCount))
+    {
+        return false;
+    }
+    _layerCount += 1;
+
+    return true;
+}
 
-    layer.name.arg = &layerNameView;
+bool VectorTilePBFParser::decodeLayer(pb_istream_t *stream, std::string_view &layerName, uint32_t &extent)
+{
+    vector_tile_Tile_Layer layer = _defaultLayer;
+
+    layer.name.arg = &layerName;
     layer.features.arg = this;
     layer.keys.arg = &_layerKeys;
     layer.values.arg = &_layerValues;
@@ -165,43 +403,54 @@ bool VectorTilePBFParser::layerDecode(pb_istream_t *stream, const pb_field_iter_
         return false;
     }
 
-    auto layerName = std::string(layerNameView);
-
     // When `has_extent` is false, nanopb sets the default in `extent`
-    _layerScale = (double)layer.extent / TileSize;
+    extent = layer.extent;
+    return true;
+}
+
+bool VectorTilePBFParser::displayLayer(std::string_view layerNameView, uint32_t extent, std::string &layerName)
+{
+    layerName = std::string(layerNameView);
 
     // Prevent a divide-by-zero, or negative scales
-    if (_layerScale <= 0)
+    if (extent == 0)
     {
         wkLogLevel(Warn, "VectorTilePBFParser: Invalid layer extent (%s / %d / %d)",
-                   layerName.c_str(), layer.extent, TileSize);
-        _skippedLayerCount += 1;
-        return true;
+                   layerName.c_str(), extent, TileSize);
+        return false;
     }
 
     // if we don't have any styles for a layer, don't bother parsing the features
-    bool found = false;
     if (_styleDelegate->layerShouldDisplay(_styleInst, layerName, _tileData->ident))
-        found = true;
-    else {
-        // Try a lowercase version
-        // TODO: This doesn't handle non-ASCII well
-        std::string lowerLayerName = layerName;
-        std::transform(lowerLayerName.begin(), lowerLayerName.end(), lowerLayerName.begin(),
-                                   [](unsigned char c){ return std::tolower(c); });
-        
-        if (lowerLayerName != layerName)
-            if (_styleDelegate->layerShouldDisplay(_styleInst, lowerLayerName, _tileData->ident)) {
-                found = true;
-                layerName = lowerLayerName;
-            }
+    {
+        return true;
     }
-    
-    if (!found) {
-        _skippedLayerCount += 1;
+
+    // Try a lowercase version
+    // TODO: This doesn't handle non-ASCII well
+    std::string lowerLayerName = layerName;
+    std::transform(lowerLayerName.begin(), lowerLayerName.end(), lowerLayerName.begin(),
+                               [](unsigned char c){ return std::tolower(c); });
+
+    if (lowerLayerName != layerName &&
+        _styleDelegate->layerShouldDisplay(_styleInst, lowerLayerName, _tileData->ident))
+    {
+        layerName = std::move(lowerLayerName);
         return true;
     }
 
+    return false;
+}
+
+bool VectorTilePBFParser::processFeatures(const std::string &layerName, uint32_t extent, int layerOrder)
+{
+    _layerScale = (double)extent / TileSize;
+    _layerOrder = layerOrder;
+
+    // If the styles don't need a real dictionary we can match against the tag
+    // tables directly and only build one for the features that get styled
+    const bool lazyAttrs = _styleDelegate->supportsLazyAttributes();
+
     size_t prevTagIndex = 0;
     size_t prevGeomIndex = 0;
     for (auto const &feature : _features)
@@ -212,32 +461,44 @@ bool VectorTilePBFParser::layerDecode(pb_istream_t *stream, const pb_field_iter_
             return false;
         }
 
-        auto attributes = std::make_shared<MutableDictionaryC>();
-        attributes->setString(layerNameKey, layerName);
-        attributes->setInt(geometryTypeKey, (int)feature.geomType);
-        attributes->setInt(layerOrderKey, (int)_layerCount);
-
-        const bool tagsOk = processTags(attributes, prevTagIndex, prevGeomIndex, feature);
-        //const auto curTagIndex = prevTagIndex;
+        const auto curTagIndex = prevTagIndex;
         const auto curGeomIndex = prevGeomIndex;
         const auto curGeomCount = feature.geomIndex - prevGeomIndex;
         prevTagIndex = feature.tagIndex;
         prevGeomIndex = feature.geomIndex;
-        
-        if (!tagsOk)
+
+        MutableDictionaryCRef attributes;
+        if (!lazyAttrs)
         {
-            _skippedFeatureCount += 1;
-            continue;
+            attributes = makeAttributes(layerName, curTagIndex, curGeomIndex, feature);
+            if (!attributes)
+            {
+                _skippedFeatureCount += 1;
+                continue;
+            }
         }
 
         SimpleIDUSet styleIDs(featureStyleHeuristic());
-        if (!checkStyles(styleIDs, attributes, layerName))
+        const bool styled = attributes ?
+            checkStyles(styleIDs, *attributes, layerName) :
+            checkStyles(styleIDs, FeatureAttributes(*this, layerName, feature, curTagIndex, _layerOrder), layerName);
+        if (!styled)
         {
             // Skip this feature
             _skippedFeatureCount += 1;
             continue;
         }
 
+        if (!attributes)
+        {
+            attributes = makeAttributes(layerName, curTagIndex, curGeomIndex, feature);
+            if (!attributes)
+            {
+                _skippedFeatureCount += 1;
+                continue;
+            }
+        }
+
         _featureCount += 1;
 
         auto vecObj = std::make_shared<VectorObject>();
@@ -297,11 +558,230 @@ bool VectorTilePBFParser::layerDecode(pb_istream_t *stream, const pb_field_iter_
 
         addFeature(vecObj, styleIDs);
     }
-    _layerCount += 1;
 
     return true;
 }
 
+VectorTilePBFParser::FeatureAttributes::FeatureAttributes(const VectorTilePBFParser &parser,
+                                                          const std::string &layerName,
+                                                          const Feature &feature,
+                                                          size_t tagIdx,
+                                                          int layerOrder)
+    : parser(parser)
+    , layerName(layerName)
+    , feature(feature)
+    , tagIdx(tagIdx)
+    , layerOrder(layerOrder)
+{
+}
+
+DictionaryEntryView VectorTilePBFParser::FeatureAttributes::find(const std::string &name) const
+{
+    DictionaryEntryView ret;
+
+    // Later tags replace earlier ones, same as when they're added to a dictionary
+    for (size_t m = tagIdx; m + 1 < feature.tagIndex; m += 2)
+    {
+        const auto keyIndex = parser._featureTags[m];
+        const auto valueIndex = parser._featureTags[m + 1];
+        if (keyIndex >= parser._layerKeys.size() || valueIndex >= parser._layerValues.size() ||
+            parser._layerKeys[keyIndex] != name)
+        {
+            continue;
+        }
+
+        const auto &value = parser._layerValues[valueIndex];
+        switch (value.type) {
+            case SmallValue::SmallValString: ret.type = DictTypeString; ret.stringVal = value.stringValue; break;
+            case SmallValue::SmallValFloat:  ret.type = DictTypeDouble; ret.doubleVal = value.floatValue; break;
+            case SmallValue::SmallValDouble: ret.type = DictTypeDouble; ret.doubleVal = value.doubleValue; break;
+            case SmallValue::SmallValInt:    ret.type = DictTypeInt;    ret.intVal = (int)value.intValue; break;
+            case SmallValue::SmallValUInt:   ret.type = DictTypeInt;    ret.intVal = (int)value.uintValue; break;
+            case SmallValue::SmallValSInt:   ret.type = DictTypeInt;    ret.intVal = (int)value.sintValue; break;
+            case SmallValue::SmallValBool:   ret.type = DictTypeInt;    ret.intVal = (int)value.boolValue; break;
+            default:
+            case SmallValue::SmallValNone:
+                break;
+        }
+    }
+    if (ret.type != DictTypeNone)
+    {
+        return ret;
+    }
+
+    // The fields we add to every feature, which the feature's own tags override
+    if (name == layerNameKey)
+    {
+        ret.type = DictTypeString;
+        ret.stringVal = layerName;
+    }
+    else if (name == geometryTypeKey || name == layerOrderKey)
+    {
+        ret.type = DictTypeInt;
+        ret.intVal = (name == geometryTypeKey) ? (int)feature.geomType : layerOrder;
+    }
+
+    return ret;
+}
+
+int VectorTilePBFParser::FeatureAttributes::count() const
+{
+    // The tags, plus the three fields we add
+    return (int)((feature.tagIndex - tagIdx) / 2) + 3;
+}
+
+bool VectorTilePBFParser::FeatureAttributes::hasField(const std::string &name) const
+{
+    return find(name).type != DictTypeNone;
+}
+
+DictionaryType VectorTilePBFParser::FeatureAttributes::getType(const std::string &name) const
+{
+    return find(name).type;
+}
+
+int VectorTilePBFParser::FeatureAttributes::getInt(const std::string &name,int defVal) const
+{
+    const auto val = find(name);
+    switch (val.type) {
+        case DictTypeInt:    return (int)val.intVal;
+        case DictTypeDouble: return (int)val.doubleVal;
+        case DictTypeNone:   return defVal;
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to int", val.type);
+            return defVal;
+    }
+}
+
+int64_t VectorTilePBFParser::FeatureAttributes::getInt64(const std::string &name,int64_t defVal) const
+{
+    const auto val = find(name);
+    switch (val.type) {
+        case DictTypeInt:    return val.intVal;
+        case DictTypeDouble: return (int64_t)val.doubleVal;
+        case DictTypeNone:   return defVal;
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to int64", val.type);
+            return defVal;
+    }
+}
+
+SimpleIdentity VectorTilePBFParser::FeatureAttributes::getIdentity(const std::string &name) const
+{
+    return (SimpleIdentity)getInt64(name, EmptyIdentity);
+}
+
+bool VectorTilePBFParser::FeatureAttributes::getBool(const std::string &name,bool defVal) const
+{
+    const auto val = find(name);
+    switch (val.type) {
+        case DictTypeInt:  return val.intVal != 0;
+        case DictTypeNone: return defVal;
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to bool", val.type);
+            return defVal;
+    }
+}
+
+RGBAColor VectorTilePBFParser::FeatureAttributes::getColor(const std::string &name,const RGBAColor &defVal) const
+{
+    const auto val = find(name);
+    switch (val.type) {
+        case DictTypeInt:
+            return ARGBtoRGBAColor((uint32_t)val.intVal);
+        case DictTypeString:
+        {
+            // We're looking for #RRGGBBAA, #RRGGBB, #RGBA, or #RGB
+            if (val.stringVal.length() < 4 || val.stringVal[0] != '#')
+                return defVal;
+            // The tile strings aren't terminated
+            const std::string str(val.stringVal.substr(1));
+            return parseColor(str.c_str(), defVal);
+        }
+        case DictTypeNone:
+            return defVal;
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to color", val.type);
+            return defVal;
+    }
+}
+
+double VectorTilePBFParser::FeatureAttributes::getDouble(const std::string &name,double defVal) const
+{
+    const auto val = find(name);
+    switch (val.type) {
+        case DictTypeInt:    return val.intVal;
+        case DictTypeDouble: return val.doubleVal;
+        case DictTypeNone:   return defVal;
+        default:
+            wkLogLevel(Warn, "Unsupported conversion from type %d to double", val.type);
+            return defVal;
+    }
+}
+
+std::string VectorTilePBFParser::FeatureAttributes::getString(const std::string &name) const
+{
+    return getString(name, std::string());
+}
+
+std::string VectorTilePBFParser::FeatureAttributes::getString(const std::string &name,const std::string &defVal) const
+{
+    const auto val = find(name);
+    switch (val.type) {
+        case DictTypeString: return std::string(val.stringVal);
+        case DictTypeInt:    return std::to_string(val.intVal);
+        case DictTypeDouble: return std::to_string(val.doubleVal);
+        default:             return defVal;
+    }
+}
+
+DictionaryRef VectorTilePBFParser::FeatureAttributes::getDict(const std::string &name) const
+{
+    // Tile values can't be dictionaries
+    return DictionaryRef();
+}
+
+DictionaryEntryRef VectorTilePBFParser::FeatureAttributes::getEntry(const std::string &name) const
+{
+    const auto val = find(name);
+    switch (val.type) {
+        case DictTypeString: return std::make_shared<DictionaryEntryCString>(std::string(val.stringVal));
+        case DictTypeInt:    return std::make_shared<DictionaryEntryCBasic>((int)val.intVal);
+        case DictTypeDouble: return std::make_shared<DictionaryEntryCBasic>(val.doubleVal);
+        default:             return DictionaryEntryRef();
+    }
+}
+
+std::vector<DictionaryEntryRef> VectorTilePBFParser::FeatureAttributes::getArray(const std::string &name) const
+{
+    // Tile values can't be arrays
+    return std::vector<DictionaryEntryRef>();
+}
+
+bool VectorTilePBFParser::FeatureAttributes::getEntryView(const std::string &name,DictionaryEntryView &view) const
+{
+    view = find(name);
+    return view.type != DictTypeNone;
+}
+
+std::vector<std::string> VectorTilePBFParser::FeatureAttributes::getKeys() const
+{
+    std::vector<std::string> keys;
+    keys.reserve(count());
+    keys.push_back(layerNameKey);
+    keys.push_back(geometryTypeKey);
+    keys.push_back(layerOrderKey);
+    for (size_t m = tagIdx; m + 1 < feature.tagIndex; m += 2)
+    {
+        const auto keyIndex = parser._featureTags[m];
+        if (keyIndex < parser._layerKeys.size() && !parser._layerKeys[keyIndex].empty())
+        {
+            keys.emplace_back(parser._layerKeys[keyIndex]);
+        }
+    }
+    return keys;
+}
+
 /// https://github.com/mapbox/vector-tile-spec/tree/master/2.1/#432-parameter-integers
 /// A ParameterInteger is zigzag encoded so that small negative and positive values are both encoded as small integers.
 int32_t VectorTilePBFParser::decodeParamInt(int32_t p) {
@@ -338,6 +818,16 @@ bool VectorTilePBFParser::featureDecode(pb_istream_t *stream, const pb_field_ite
     return true;
 }
 
+MutableDictionaryCRef VectorTilePBFParser::makeAttributes(const std::string &layerName, size_t tagIdx, size_t geomIdx, const Feature &feature)
+{
+    auto attributes = std::make_shared<MutableDictionaryC>();
+    attributes->setString(layerNameKey, layerName);
+    attributes->setInt(geometryTypeKey, (int)feature.geomType);
+    attributes->setInt(layerOrderKey, _layerOrder);
+
+    return processTags(attributes, tagIdx, geomIdx, feature) ? attributes : MutableDictionaryCRef();
+}
+
 bool VectorTilePBFParser::processTags(const MutableDictionaryCRef &attributes, size_t tagIdx, size_t geomIdx, const Feature &feature)
 {
     const auto tagCount = feature.tagIndex - tagIdx;
@@ -385,7 +875,7 @@ bool VectorTilePBFParser::processTags(const MutableDictionaryCRef &attributes, s
     return true;
 }
 
-bool VectorTilePBFParser::checkStyles(SimpleIDUSet& styleIDs, const MutableDictionaryCRef &attributes, const std::string &layerName)
+bool VectorTilePBFParser::checkStyles(SimpleIDUSet& styleIDs, const Dictionary &attributes, const std::string &layerName)
 {
     // Ask for the styles that correspond to this feature
     // If there are none, we can skip this.
@@ -393,7 +883,7 @@ bool VectorTilePBFParser::checkStyles(SimpleIDUSet& styleIDs, const MutableDicti
     // Do a quick inclusion check
     if (!_uuidName.empty())
     {
-        std::string uuidVal = attributes->getString(_uuidName); // TODO: extra string copy
+        std::string uuidVal = attributes.getString(_uuidName); // TODO: extra string copy
         if (_uuidValues.find(uuidVal) == _uuidValues.end())
         {
             // Skip this feature
@@ -402,7 +892,7 @@ bool VectorTilePBFParser::checkStyles(SimpleIDUSet& styleIDs, const MutableDicti
     }
     
     // TODO: populate a reused vector?
-    const auto styles = _styleDelegate->stylesForFeature(_styleInst, *attributes, _tileData->ident, layerName);
+    const auto styles = _styleDelegate->stylesForFeature(_styleInst, attributes, _tileData->ident, layerName);
     for (const auto &style : styles)
     {
         styleIDs.insert(style->getUuid(_styleInst));
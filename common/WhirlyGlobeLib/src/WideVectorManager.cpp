@@ -819,14 +819,18 @@ struct WideVectorDrawableConstructor
                 drawable->addTriangle(BasicDrawable::Triangle(8,10,11));
             }
             
+            // Get all the points in display space at once
+            Point2dVector geoPts(newPts.size());
+            Point3dVector dispPts(newPts.size());
+            for (unsigned int ii=0;ii<newPts.size();ii++)
+                geoPts[ii] = Point2d(newPts[ii].x(),newPts[ii].y());
+            coordAdapter->geographicToDisplayBatch(geoPts.data(),dispPts.data(),newPts.size());
+
             // Run through the points, adding centerline instances
             double len = 0.0;
             int startPt = drawable->getCenterLineCount();
             for (unsigned int ii=0;ii<newPts.size();ii++) {
-                const auto &pt = newPts[ii];
-
-                Point3d localPa = coordSys->geographicToLocal3d(GeoCoord(pt.x(),pt.y()));
-                Point3d dispPa = coordAdapter->localToDisplay(localPa);
+                const Point3d &dispPa = dispPts[ii];
 
                 unsigned int prev = startPt + ii - 1;
                 if (ii == 0) {
@@ -159,6 +159,39 @@ typedef void (__strong ^InitCompletionBlock)(void);
  */
 @property (nonatomic,assign) bool layoutFade;
 
+/**
+    Keep the drawables for laid out objects between layout passes and only rebuild the ones that changed.
+ 
+    This is much cheaper when there are a lot of labels or markers and only a few change on each pass.
+ */
+@property (nonatomic,assign) bool layoutRetained;
+
+/**
+    Group clustered markers with a hierarchical index built once per set of markers.
+ 
+    The clusters only change at discrete zoom levels, but layout no longer has to check every marker against its neighbors on each pass.
+ */
+@property (nonatomic,assign) bool layoutClusterIndexing;
+
+/**
+    Maximum time (in seconds) the renderer will spend applying changes in a single frame.
+ 
+    Changes that don't fit are deferred to the next frame, which keeps large batches of additions from stalling the display.  Zero, the default, means no limit.
+ */
+@property (nonatomic,assign) NSTimeInterval changeBudgetTime;
+
+/**
+    Maximum number of changes the renderer will apply in a single frame.
+ 
+    Works along with changeBudgetTime.  Zero, the default, means no limit.
+ */
+@property (nonatomic,assign) int changeBudgetCount;
+
+/**
+    Number of changes waiting for a later frame because they didn't fit in the change budget.
+ */
+@property (nonatomic,readonly) int numDeferredChanges;
+
 /**
     Controls the way height changes while animating the view
     For simple, linear zoom use:
@@ -286,6 +286,19 @@ typedef NS_ENUM(NSInteger, MaplyVectorObjectType) {
   */
 - (void)reprojectFrom:(MaplyCoordinateSystem *__nonnull)srcSystem to:(MaplyCoordinateSystem *__nonnull)destSystem;
 
+/** 
+    Reproject from one coordinate system to another, approximating where that's close enough.
+    
+    This works like reprojectFrom:to: but for large data sets it can convert a grid over the data and interpolate between those points rather than converting every point.  If the grid can't stay within the given error, every point is converted as usual.
+    
+    @param srcSystem The source coordinate system.  The data is already in this sytem.
+    
+    @param destSystem The destination coordinate system.  The data will be in this system on return.
+    
+    @param maxError How far off a point can be, in the units of the destination system.  Zero converts every point.
+  */
+- (void)reprojectFrom:(MaplyCoordinateSystem *__nonnull)srcSystem to:(MaplyCoordinateSystem *__nonnull)destSystem maxError:(double)maxError;
+
 /** 
     Dump the feature(s) out as text
     
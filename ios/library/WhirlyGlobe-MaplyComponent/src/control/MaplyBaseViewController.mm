@@ -115,12 +115,20 @@ using namespace WhirlyKit;
 {
     MaplyLocationTracker *_locationTracker;
     bool _layoutFade;
+    bool _layoutRetained;
+    bool _layoutClusterIndexing;
+    NSTimeInterval _changeBudgetTime;
+    int _changeBudgetCount;
     NSMutableArray<InitCompletionBlock> *_postInitCalls;
 }
 
 - (instancetype)init{
     self = [super init];
     _layoutFade = false;
+    _layoutRetained = false;
+    _layoutClusterIndexing = false;
+    _changeBudgetTime = 0.0;
+    _changeBudgetCount = 0;
     _postInitCalls = [NSMutableArray new];
     return self;
 }
@@ -211,6 +219,78 @@ using namespace WhirlyKit;
     return _layoutFade;
 }
 
+- (void)setLayoutRetained:(bool)retained
+{
+    _layoutRetained = retained;
+    if (auto rc = renderControl)
+    if (auto scene = rc->scene)
+    if (auto layoutManager = scene->getManager<LayoutManager>(kWKLayoutManager))
+    {
+        layoutManager->setRetainedMode(retained);
+    }
+}
+
+- (bool)layoutRetained
+{
+    return _layoutRetained;
+}
+
+- (void)setLayoutClusterIndexing:(bool)enable
+{
+    _layoutClusterIndexing = enable;
+    if (auto rc = renderControl)
+    if (auto scene = rc->scene)
+    if (auto layoutManager = scene->getManager<LayoutManager>(kWKLayoutManager))
+    {
+        layoutManager->setClusterIndexing(enable);
+    }
+}
+
+- (bool)layoutClusterIndexing
+{
+    return _layoutClusterIndexing;
+}
+
+- (void)setChangeBudgetTime:(NSTimeInterval)maxTime
+{
+    _changeBudgetTime = maxTime;
+    if (auto rc = renderControl)
+    if (auto scene = rc->scene)
+    {
+        scene->setChangeBudget(_changeBudgetTime, _changeBudgetCount);
+    }
+}
+
+- (NSTimeInterval)changeBudgetTime
+{
+    return _changeBudgetTime;
+}
+
+- (void)setChangeBudgetCount:(int)maxCount
+{
+    _changeBudgetCount = maxCount;
+    if (auto rc = renderControl)
+    if (auto scene = rc->scene)
+    {
+        scene->setChangeBudget(_changeBudgetTime, _changeBudgetCount);
+    }
+}
+
+- (int)changeBudgetCount
+{
+    return _changeBudgetCount;
+}
+
+- (int)numDeferredChanges
+{
+    if (auto rc = renderControl)
+    if (auto scene = rc->scene)
+    {
+        return scene->getNumDeferredChanges();
+    }
+    return 0;
+}
+
 // Kick off the analytics logic.  First we need the server name.
 - (void)startAnalytics
 {
@@ -309,8 +389,13 @@ using namespace WhirlyKit;
     viewPlacementModel = std::make_shared<ViewPlacementActiveModel>();
     renderControl->scene->addActiveModel(viewPlacementModel);
 
-    // Apply layout fade option set before init to the newly-created manager
+    // Apply layout options set before init to the newly-created manager
     [self setLayoutFade:_layoutFade];
+    [self setLayoutRetained:_layoutRetained];
+    [self setLayoutClusterIndexing:_layoutClusterIndexing];
+
+    // Likewise the per-frame change budget
+    [self setChangeBudgetTime:_changeBudgetTime];
 
     // Set up defaults for the hints
     NSDictionary *newHints = [NSDictionary dictionary];
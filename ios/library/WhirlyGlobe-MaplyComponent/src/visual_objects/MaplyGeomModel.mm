@@ -40,8 +40,7 @@ using namespace Eigen;
     self = [super init];
     
     const char *str = [fullPath cStringUsingEncoding:NSASCIIStringEncoding];
-    FILE *fp = fopen(str, "r");
-    if (!fp)
+    if (!str)
         return nil;
     
     // Parse it out of the file
@@ -49,10 +48,21 @@ using namespace Eigen;
     NSString *bundlePath = [[NSBundle mainBundle] resourcePath];
     objModel.setResourceDir([bundlePath cStringUsingEncoding:NSASCIIStringEncoding]);
     
-    if (!objModel.parse(fp))
-        return nil;
+    // Parsed models are cached in binary form, which is much quicker to load the next time
+    std::string cacheFile;
+    NSString *cacheDir = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) firstObject];
+    if (cacheDir)
+    {
+        cacheDir = [cacheDir stringByAppendingPathComponent:@"geomModels"];
+        [[NSFileManager defaultManager] createDirectoryAtPath:cacheDir withIntermediateDirectories:YES attributes:nil error:nil];
+        NSString *cacheName = [NSString stringWithFormat:@"%@-%lx.wkgeom",[fullPath lastPathComponent],(unsigned long)[fullPath hash]];
+        const char *cacheStr = [[cacheDir stringByAppendingPathComponent:cacheName] fileSystemRepresentation];
+        if (cacheStr)
+            cacheFile = cacheStr;
+    }
     
-    objModel.toRawGeometry(textures,rawGeom);
+    if (!objModel.loadCached(str,cacheFile,textures,rawGeom))
+        return nil;
     
     return self;
 }
@@ -409,6 +409,11 @@ using namespace WhirlyGlobe;
 }
 
 - (void)reprojectFrom:(MaplyCoordinateSystem *)srcSystem to:(MaplyCoordinateSystem *)destSystem
+{
+    [self reprojectFrom:srcSystem to:destSystem maxError:0.0];
+}
+
+- (void)reprojectFrom:(MaplyCoordinateSystem *)srcSystem to:(MaplyCoordinateSystem *)destSystem maxError:(double)maxError
 {
     CoordSystem *inSystem = srcSystem->coordSystem.get();
     CoordSystem *outSystem = destSystem->coordSystem.get();
@@ -418,7 +423,7 @@ using namespace WhirlyGlobe;
     if ([srcSystem isKindOfClass:[MaplySphericalMercator class]])
         scale = 1/EarthRadius;
     
-    vObj->reproject(inSystem, scale, outSystem);
+    vObj->reproject(inSystem, scale, outSystem, maxError);
 }
 
 // Look for areals that this point might be inside
@@ -55,6 +55,7 @@ void SceneMTL::teardown(PlatformThreadInfo *inst)
         }
     }
     drawables.clear();
+    drawableIndex->clear();
     for (auto it : textures) {
         it.second->destroyInRenderer(setupInfo,this);
     }
@@ -649,6 +649,9 @@ void SceneRendererMTL::render(TimeInterval duration,
     // Merge any outstanding changes into the scenegraph
     processScene(now);
     
+    if (perfInterval > 0)
+        perfTimer.addCount("Deferred changes", scene->getNumDeferredChanges());
+    
     // Update our work groups accordingly
     updateWorkGroups(&baseFrameInfo);
     